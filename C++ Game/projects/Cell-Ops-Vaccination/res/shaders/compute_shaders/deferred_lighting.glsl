@@ -0,0 +1,130 @@
+#version 430
+
+// Lights the G-buffer in 16x16 pixel tiles. Each tile finds the depth range of its pixels,
+// culls the scene's lights against the box that range covers, then every pixel in the tile
+// only loops over the lights that survived. This keeps the cost at roughly one pass over
+// the screen, rather than one pass per light
+
+#define TILE_SIZE 16
+
+layout(local_size_x = TILE_SIZE, local_size_y = TILE_SIZE) in;
+
+#include "../fragments/multiple_point_lights.glsl"
+#include "../fragments/frame_uniforms.glsl"
+#include "../fragments/octahedral.glsl"
+
+// Slot 0 is reserved for the environment map
+// Albedo in rgb, shininess in a
+layout (binding = 1) uniform sampler2D s_Albedo;
+// Octahedral encoded world space normals
+layout (binding = 2) uniform sampler2D s_Normals;
+layout (binding = 3) uniform sampler2D s_Depth;
+
+// The lit scene is written straight into the primary framebuffer's color target
+layout (rgba8, binding = 0) uniform writeonly image2D u_Output;
+
+// Inverse of the (jittered) view projection the G-buffer was drawn with
+uniform mat4  u_InvViewProjection;
+// Contribution below which a light is considered out of range, matches LightCuller::CutoffIntensity
+uniform float u_LightCutoff;
+
+// Depth range of the tile, stored as the bits of the float since atomics only work on integers.
+// This works since depths are always positive
+shared uint sMinDepth;
+shared uint sMaxDepth;
+// The lights that touch this tile
+shared int  sNumLights;
+shared int  sLightIndices[MAX_LIGHTS];
+
+// Converts a screen position and depth back into world space
+// @param uv    The position on screen, between 0 and 1
+// @param depth The window space depth, between 0 and 1
+vec3 ReconstructWorldPos(vec2 uv, float depth) {
+	vec4 clip = vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+	vec4 world = u_InvViewProjection * clip;
+	return world.xyz / world.w;
+}
+
+// Gets the distance from a light beyond which its contribution drops under u_LightCutoff,
+// this is the same as LightCuller::GetInfluenceRadius
+float GetInfluenceRadius(Light light) {
+	float intensity = max(light.ColorAttenuation.r, max(light.ColorAttenuation.g, light.ColorAttenuation.b));
+	if (intensity <= u_LightCutoff) {
+		return -1.0;
+	}
+	if (light.ColorAttenuation.w <= 0.0) {
+		return 1e30;
+	}
+	return sqrt((intensity / u_LightCutoff - 1.0) / light.ColorAttenuation.w);
+}
+
+void main() {
+	ivec2 size  = textureSize(s_Depth, 0);
+	ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+	bool inside = all(lessThan(pixel, size));
+
+	if (gl_LocalInvocationIndex == 0) {
+		sMinDepth  = 0xFFFFFFFFu;
+		sMaxDepth  = 0u;
+		sNumLights = 0;
+	}
+	barrier();
+
+	// Pixels at the far plane were not covered by any deferred surface
+	float depth = inside ? texelFetch(s_Depth, pixel, 0).r : 1.0;
+	bool hasSurface = depth < 1.0;
+	if (hasSurface) {
+		atomicMin(sMinDepth, floatBitsToUint(depth));
+		atomicMax(sMaxDepth, floatBitsToUint(depth));
+	}
+	barrier();
+
+	// Skip culling for tiles that are all background
+	if (sMinDepth <= sMaxDepth) {
+		float minDepth = uintBitsToFloat(sMinDepth);
+		float maxDepth = uintBitsToFloat(sMaxDepth);
+
+		// Find the world space box around the part of the view frustum this tile covers
+		vec2 tileMin = vec2(gl_WorkGroupID.xy * TILE_SIZE) / vec2(size);
+		vec2 tileMax = min(vec2((gl_WorkGroupID.xy + 1) * TILE_SIZE) / vec2(size), vec2(1.0));
+		vec3 boundsMin = vec3( 1e30);
+		vec3 boundsMax = vec3(-1e30);
+		for (int corner = 0; corner < 8; corner++) {
+			vec2  uv = vec2((corner & 1) != 0 ? tileMax.x : tileMin.x, (corner & 2) != 0 ? tileMax.y : tileMin.y);
+			float z  = (corner & 4) != 0 ? maxDepth : minDepth;
+			vec3  p  = ReconstructWorldPos(uv, z);
+			boundsMin = min(boundsMin, p);
+			boundsMax = max(boundsMax, p);
+		}
+
+		// Each thread in the tile tests a slice of the lights
+		int numLights = min(int(AmbientColAndNumLights.w), MAX_LIGHTS);
+		for (int ix = int(gl_LocalInvocationIndex); ix < numLights; ix += TILE_SIZE * TILE_SIZE) {
+			float radius = GetInfluenceRadius(Lights[ix]);
+			vec3  nearest = clamp(Lights[ix].Position.xyz, boundsMin, boundsMax);
+			vec3  delta = nearest - Lights[ix].Position.xyz;
+			if (radius >= 0.0 && dot(delta, delta) <= radius * radius) {
+				int slot = atomicAdd(sNumLights, 1);
+				sLightIndices[slot] = ix;
+			}
+		}
+	}
+	barrier();
+
+	if (!hasSurface) {
+		return;
+	}
+
+	vec4 albedo = texelFetch(s_Albedo, pixel, 0);
+	vec3 normal = DecodeOctahedral(texelFetch(s_Normals, pixel, 0).xy);
+	vec3 worldPos = ReconstructWorldPos((vec2(pixel) + 0.5) / vec2(size), depth);
+	vec3 viewDir = normalize(u_CamPos.xyz - worldPos);
+
+	// Same lighting model as CalcAllLightContribution, so both paths match
+	vec3 lightAccumulation = AmbientColAndNumLights.rgb;
+	for (int ix = 0; ix < sNumLights; ix++) {
+		lightAccumulation += CalcPointLightContribution(worldPos, normal, viewDir, Lights[sLightIndices[ix]], albedo.a);
+	}
+
+	imageStore(u_Output, pixel, vec4(lightAccumulation * albedo.rgb, 1.0));
+}
@@ -2,9 +2,6 @@
 
 #include "../fragments/fs_common_inputs.glsl"
 
-// We output a single color to the color buffer
-layout(location = 0) out vec4 frag_color;
-
 ////////////////////////////////////////////////////////////////
 /////////////// Instance Level Uniforms ////////////////////////
 ////////////////////////////////////////////////////////////////
@@ -31,19 +28,17 @@ uniform Material u_Material;
 
 #include "../fragments/frame_uniforms.glsl"
 
+// Declares our outputs for both the forward and deferred paths
+#include "../fragments/surface_output.glsl"
+
 // https://learnopengl.com/Advanced-Lighting/Advanced-Lighting
 void main() {
 	// Normalize our input normal
 	vec3 normal = normalize(inNormal);
 
-	// Use the lighting calculation that we included from our partial file
-	vec3 lightAccumulation = CalcAllLightContribution(inWorldPos, normal, u_CamPos.xyz, u_Material.Shininess);
-
 	// Get the albedo from the diffuse / albedo map
 	vec4 textureColor = texture(u_Material.Diffuse, inUV);
 
-	// combine for the final result
-	vec3 result = lightAccumulation  * inColor * textureColor.rgb;
-
-	frag_color = vec4(result, textureColor.a);
+	// Lights the surface now, or stores it in the G-buffer to be lit later
+	OutputSurface(inWorldPos, normal, inColor * textureColor.rgb, textureColor.a, u_Material.Shininess);
 }
\ No newline at end of file
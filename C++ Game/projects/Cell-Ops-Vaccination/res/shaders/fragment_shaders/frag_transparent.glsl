@@ -0,0 +1,43 @@
+#version 430
+
+#include "../fragments/fs_common_inputs.glsl"
+
+// Declares our outputs for both blending paths
+#include "../fragments/transparency.glsl"
+
+// Represents a collection of attributes that would define a material
+// For instance, you can think of this like material settings in 
+// Unity
+struct Material {
+	sampler2D Diffuse;
+	float     Shininess;
+	// Multiplied with the diffuse texture's alpha
+	float     Opacity;
+};
+// Create a uniform for the material
+uniform Material u_Material;
+
+#include "../fragments/multiple_point_lights.glsl"
+#include "../fragments/frame_uniforms.glsl"
+
+// Blinn-phong lighting for see-through surfaces, like cell membranes
+void main() {
+	// Normalize our input normal
+	vec3 normal = normalize(inNormal);
+
+	// Transparent objects are drawn without backface culling, so flip normals for back faces
+	if (!gl_FrontFacing) {
+		normal = -normal;
+	}
+
+	// Use the lighting calculation that we included from our partial file
+	vec3 lightAccumulation = CalcAllLightContribution(inWorldPos, normal, u_CamPos.xyz, u_Material.Shininess);
+
+	// Get the albedo from the diffuse / albedo map
+	vec4 textureColor = texture(u_Material.Diffuse, inUV);
+
+	// combine for the final result
+	vec3 result = lightAccumulation * inColor * textureColor.rgb;
+
+	OutputTransparent(vec4(result, textureColor.a * u_Material.Opacity));
+}
@@ -0,0 +1,33 @@
+#version 430
+
+// Resolves the weighted blended transparency targets over the opaque scene
+// Should be drawn with blending set to (SRC_ALPHA, ONE_MINUS_SRC_ALPHA)
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 frag_color;
+
+// The sum of all weighted, premultiplied transparent colors
+uniform layout(binding = 0) sampler2D s_Accumulation;
+// The product of (1 - alpha) for all transparent surfaces
+uniform layout(binding = 1) sampler2D s_Revealage;
+
+void main() {
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	float revealage = texelFetch(s_Revealage, texel, 0).r;
+
+	// Nothing transparent covers this pixel, leave the opaque color alone
+	if (revealage >= 0.9999) {
+		discard;
+	}
+
+	vec4 accumulation = texelFetch(s_Accumulation, texel, 0);
+
+	// Weights can get large, so make sure we don't overflow to infinity
+	if (isinf(max(max(abs(accumulation.r), abs(accumulation.g)), abs(accumulation.b)))) {
+		accumulation.rgb = vec3(accumulation.a);
+	}
+
+	vec3 averageColor = accumulation.rgb / max(accumulation.a, 1e-5);
+	frag_color = vec4(averageColor, 1.0 - revealage);
+}
@@ -0,0 +1,74 @@
+#version 430
+
+// Blends the current frame with the reprojected history for temporal anti-aliasing
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 frag_color;
+
+// Velocities at or below this were not written by the velocity pass
+// Must match TemporalAntiAliasing::NO_VELOCITY
+#define NO_VELOCITY -1000.0
+
+// The jittered scene color for this frame
+uniform layout(binding = 0) sampler2D s_Current;
+// The anti-aliased result from last frame
+uniform layout(binding = 1) sampler2D s_History;
+// Screen space motion for moving objects, in UV units
+uniform layout(binding = 2) sampler2D s_Velocity;
+// The scene depth, used to reproject pixels that have no velocity
+uniform layout(binding = 3) sampler2D s_Depth;
+
+// The camera matrices without jitter
+uniform mat4  u_InvViewProjection;
+uniform mat4  u_PrevViewProjection;
+// The offset this frame was rendered with, in UV units
+uniform vec2  u_Jitter;
+// How much of the history to keep
+uniform float u_HistoryWeight;
+// False on the first frame, or after the history was discarded
+uniform bool  u_HistoryValid;
+
+void main() {
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	ivec2 maxTexel = textureSize(s_Current, 0) - 1;
+	vec3 current = texelFetch(s_Current, texel, 0).rgb;
+
+	if (!u_HistoryValid) {
+		frag_color = vec4(current, 1.0);
+		return;
+	}
+
+	// Find the range of colors around this pixel, the history should fall somewhere within it
+	vec3 minColor = current;
+	vec3 maxColor = current;
+	for (int y = -1; y <= 1; y++) {
+		for (int x = -1; x <= 1; x++) {
+			vec3 neighbour = texelFetch(s_Current, clamp(texel + ivec2(x, y), ivec2(0), maxTexel), 0).rgb;
+			minColor = min(minColor, neighbour);
+			maxColor = max(maxColor, neighbour);
+		}
+	}
+
+	// Static objects don't write velocity, so work out their motion from the camera movement
+	vec2 velocity = texelFetch(s_Velocity, texel, 0).rg;
+	if (velocity.x <= NO_VELOCITY) {
+		// Keep the sky just short of the far plane so the reprojection stays finite
+		float depth = min(texelFetch(s_Depth, texel, 0).r, 0.99999);
+		vec2 uv = inUV - u_Jitter;
+		vec4 world = u_InvViewProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+		world /= world.w;
+		vec4 previous = u_PrevViewProjection * world;
+		velocity = uv - (previous.xy / previous.w * 0.5 + 0.5);
+	}
+
+	// If the pixel was off screen last frame, there's no history to use
+	vec2 historyUV = inUV - velocity;
+	if (any(lessThan(historyUV, vec2(0.0))) || any(greaterThan(historyUV, vec2(1.0)))) {
+		frag_color = vec4(current, 1.0);
+		return;
+	}
+
+	vec3 history = clamp(texture(s_History, historyUV).rgb, minColor, maxColor);
+	frag_color = vec4(mix(current, history, u_HistoryWeight), 1.0);
+}
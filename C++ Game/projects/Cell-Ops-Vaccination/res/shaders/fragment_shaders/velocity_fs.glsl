@@ -0,0 +1,14 @@
+#version 430
+
+layout(location = 0) in vec4 inCurrentPos;
+layout(location = 1) in vec4 inPreviousPos;
+
+// The distance the surface moved since last frame, in UV units
+layout(location = 0) out vec2 frag_velocity;
+
+void main() {
+	// Divide per-fragment rather than per-vertex, so that perspective is handled correctly
+	vec2 current = inCurrentPos.xy / inCurrentPos.w;
+	vec2 previous = inPreviousPos.xy / inPreviousPos.w;
+	frag_velocity = (current - previous) * 0.5;
+}
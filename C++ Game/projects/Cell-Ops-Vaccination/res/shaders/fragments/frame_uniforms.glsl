@@ -12,6 +12,8 @@ layout (std140, binding = 0) uniform b_FrameLevelUniforms {
     uniform float u_Time;    
     // The time in seconds since the last frame
     uniform float u_DeltaTime;
+    // Non-zero while opaque surfaces are being written to the G-buffer, see surface_output.glsl
+    uniform int   u_DeferredPass;
 };
 
 // Stores uniforms that change every object/instance
@@ -9,8 +9,11 @@
  * vec3 lighting = CalculateAllLightContribution(inWorldPos, normal, u_CamPos);
 */
 
-// The maximum number of lights the shader supports, increasing this will lower performance!
-#define MAX_LIGHTS 8
+// The maximum number of lights the scene can hold, must match Scene::MAX_LIGHTS
+#define MAX_LIGHTS 64
+// The maximum number of lights that can affect a single object, increasing this will lower performance!
+// Must be a multiple of 4, and match LightCuller::MAX_LIGHTS_PER_OBJECT
+#define MAX_OBJECT_LIGHTS 8
 
 // Represents a single light source
 struct Light {
@@ -34,6 +37,16 @@ layout (std140, binding = 2) uniform b_LightBlock {
 	mat3  EnvironmentRotation;
 };
 
+// Stores the lights that affect the object currently being drawn, picked on the CPU
+// so that we only need to loop over a handful of lights per fragment
+layout (std140, binding = 3) uniform b_ObjectLightBlock {
+	// Indices into Lights, most influential first. Packed 4 to a vec4 to avoid
+	// the padding that std140 adds to int arrays
+	ivec4 ObjectLightIndices[MAX_OBJECT_LIGHTS / 4];
+	// The number of valid indices in ObjectLightIndices
+	int   NumObjectLights;
+};
+
 // Uniform for our environment map / skybox, bound to slot 0 by default
 uniform layout(binding=0) samplerCube s_EnvironmentMap;
 
@@ -82,8 +95,8 @@ vec3 CalcPointLightContribution(vec3 worldPos, vec3 normal, vec3 viewDir, Light
 }
 
 /*
- * Calculates the lighting contribution for all lights in the scene
- * for a given fragment
+ * Calculates the lighting contribution for all lights affecting the
+ * current object for a given fragment
  * @param worldPos The fragment's position in world space
  * @param normal The normalized surface normal for the fragment
  * @param camPos The camera's position in world space
@@ -95,10 +108,11 @@ vec3 CalcAllLightContribution(vec3 worldPos, vec3 normal, vec3 camPos, float shi
 	// Direction between camera and fragment will be shared for all lights
 	vec3 viewDir  = normalize(camPos - worldPos);
 	
-	// Iterate over all lights
-	for(int ix = 0; ix < AmbientColAndNumLights.w && ix < MAX_LIGHTS; ix++) {
+	// Iterate over the lights that were selected for this object
+	for(int ix = 0; ix < NumObjectLights && ix < MAX_OBJECT_LIGHTS; ix++) {
+		int index = ObjectLightIndices[ix / 4][ix % 4];
 		// Additive lighting model
-		lightAccumulation += CalcPointLightContribution(worldPos, normal, viewDir, Lights[ix], shininess);
+		lightAccumulation += CalcPointLightContribution(worldPos, normal, viewDir, Lights[index], shininess);
 	}
 
 	return lightAccumulation;
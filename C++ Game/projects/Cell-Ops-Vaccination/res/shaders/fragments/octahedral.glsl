@@ -0,0 +1,32 @@
+/*
+ * This is a partial file for packing unit vectors into 2 components, used to keep
+ * normals in the G-buffer small. The sphere is folded onto an octahedron and then
+ * flattened into a square, which keeps the precision even over the whole sphere
+ *
+ * Usage:
+ * vec2 packed = EncodeOctahedral(normal);
+ * vec3 normal = DecodeOctahedral(packed);
+*/
+
+// Packs a normalized direction into the range [-1, 1]
+// @param n The direction to pack, must be normalized
+vec2 EncodeOctahedral(vec3 n) {
+	n /= (abs(n.x) + abs(n.y) + abs(n.z));
+	vec2 result = n.xy;
+	// Fold the lower hemisphere over the diagonals
+	if (n.z < 0.0) {
+		result = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return result;
+}
+
+// Unpacks a direction that was packed with EncodeOctahedral
+// @param e The packed direction
+// @returns The normalized direction
+vec3 DecodeOctahedral(vec2 e) {
+	vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
@@ -0,0 +1,34 @@
+/*
+ * This is a partial file for opaque lit materials that can be drawn by either the
+ * forward or the deferred path. In the forward path the surface is lit right away,
+ * in the deferred path it is written to the G-buffer and lit later in a single pass
+ * for the whole screen. Materials that use this should have IsDeferred set
+ *
+ * Must be included after multiple_point_lights.glsl and frame_uniforms.glsl
+ *
+ * Usage:
+ * OutputSurface(inWorldPos, normal, albedo.rgb, albedo.a, u_Material.Shininess);
+*/
+
+#include "octahedral.glsl"
+
+// Lit color in the forward path, albedo in rgb and shininess in a in the deferred path
+layout(location = 0) out vec4 frag_color;
+// Octahedral encoded world space normal, only written in the deferred path
+layout(location = 1) out vec2 frag_normal;
+
+// Writes an opaque surface, the render layer selects which path is being drawn
+// @param worldPos  The fragment's position in world space
+// @param normal    The fragment's world space normal (normalized)
+// @param albedo    The surface color
+// @param alpha     The surface's alpha, only kept by the forward path
+// @param shininess The specular power for the fragment, between 0 and 1
+void OutputSurface(vec3 worldPos, vec3 normal, vec3 albedo, float alpha, float shininess) {
+	if (u_DeferredPass != 0) {
+		frag_color = vec4(albedo, shininess);
+		frag_normal = EncodeOctahedral(normal);
+	} else {
+		vec3 lightAccumulation = CalcAllLightContribution(worldPos, normal, u_CamPos.xyz, shininess);
+		frag_color = vec4(lightAccumulation * albedo, alpha);
+	}
+}
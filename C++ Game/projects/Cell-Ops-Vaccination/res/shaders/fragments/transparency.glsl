@@ -0,0 +1,35 @@
+/*
+ * This is a partial file for shaders used by transparent materials. It declares
+ * the outputs for both the sorted alpha blending path and the weighted blended
+ * order-independent transparency (OIT) path, so the same shader works with either
+ * 
+ * Usage:
+ * vec4 color = vec4(lighting * albedo.rgb, albedo.a);
+ * OutputTransparent(color);
+*/
+
+// Straight alpha color, used when transparent objects are sorted and alpha blended
+layout(location = 0) out vec4  frag_color;
+// Weighted, premultiplied color in rgb and weighted alpha in a, added together for all surfaces
+layout(location = 1) out vec4  frag_accumulation;
+// Alpha of the surface, multiplied together as (1 - alpha) for all surfaces
+layout(location = 2) out float frag_revealage;
+
+// Calculates the weight for a fragment, so that surfaces closer to the camera
+// dominate the blended result. This is equation 10 from McGuire and Bavoil's
+// "Weighted Blended Order-Independent Transparency"
+// @param depth The fragment's window space depth, between 0 and 1
+// @param alpha The fragment's opacity
+float CalcTransparencyWeight(float depth, float alpha) {
+	return clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - depth * 0.9, 3.0), 1e-2, 3e3);
+}
+
+// Writes a transparent fragment, the render layer selects which outputs are actually used
+// @param color The fragment's color, with straight (not premultiplied) alpha
+void OutputTransparent(vec4 color) {
+	frag_color = color;
+
+	float weight = CalcTransparencyWeight(gl_FragCoord.z, color.a);
+	frag_accumulation = vec4(color.rgb * color.a, color.a) * weight;
+	frag_revealage = color.a;
+}
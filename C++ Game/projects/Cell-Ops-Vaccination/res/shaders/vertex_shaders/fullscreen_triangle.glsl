@@ -0,0 +1,12 @@
+#version 430
+
+// Generates a single triangle that covers the whole screen, no vertex buffers needed
+// Draw with 3 vertices and an empty VAO bound
+
+layout(location = 0) out vec2 outUV;
+
+void main() {
+	// Vertex 0 -> (0, 0), 1 -> (2, 0), 2 -> (0, 2)
+	outUV = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(outUV * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 430
+
+// Writes the screen space motion of moving objects for temporal anti-aliasing
+
+layout(location = 0) in vec3 inPosition;
+
+layout(location = 0) out vec4 outCurrentPos;
+layout(location = 1) out vec4 outPreviousPos;
+
+// The jittered MVP, so that we land on the same depth as the main pass
+uniform mat4 u_ClipTransform;
+// This frame's MVP without jitter
+uniform mat4 u_CurrentTransform;
+// Last frame's MVP without jitter
+uniform mat4 u_PreviousTransform;
+
+void main() {
+	gl_Position = u_ClipTransform * vec4(inPosition, 1.0);
+	outCurrentPos = u_CurrentTransform * vec4(inPosition, 1.0);
+	outPreviousPos = u_PreviousTransform * vec4(inPosition, 1.0);
+}
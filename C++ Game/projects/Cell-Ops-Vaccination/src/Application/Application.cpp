@@ -10,6 +10,8 @@
 #include <filesystem>
 #include "Layers/GLAppLayer.h"
 #include "Utils/FileHelpers.h"
+#include "Utils/VirtualFileSystem.h"
+#include "Utils/AsyncFileWriter.h"
 #include "Utils/ResourceManager/ResourceManager.h"
 
 // Graphics
@@ -23,11 +25,15 @@
 #include "Graphics/Font.h"
 #include "Graphics/GuiBatcher.h"
 #include "Graphics/Framebuffer.h"
+#include "Graphics/GlUploadThread.h"
+#include "Graphics/GpuReadback.h"
+#include "Graphics/RenderTargetPool.h"
 
 // Gameplay
 #include "Gameplay/Material.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/Physics/PhysicsProfiler.h"
 
 // Components
 #include "Gameplay/Components/IComponent.h"
@@ -47,6 +53,7 @@
 #include "Gameplay/Components/UIController.h"
 #include "Gameplay/Components/EnemySpawnerBehaviour.h"
 #include "Gameplay/Components/ParticleSystem.h"
+#include "Gameplay/Components/FlowFieldNavigation.h"
 
 // GUI
 #include "Gameplay/Components/GUI/RectTransform.h"
@@ -74,6 +81,9 @@ Application::Application() :
 	_windowSize({ DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT }),
 	_isRunning(false),
 	_isEditor(true),
+	_pendingWindowSize({ 0, 0 }),
+	_resizeRequestTime(0.0),
+	_resizeDebounce(0.1),
 	_windowTitle("Cell Ops Vaccination"),
 	_currentScene(nullptr),
 	_targetScene(nullptr)
@@ -107,7 +117,10 @@ void Application::SetPrimaryViewport(const glm::uvec4 & value) {
 
 void Application::ResizeWindow(const glm::ivec2 & newSize)
 {
-	_HandleWindowSizeChanged(newSize);
+	// Dragging a window edge sends a new size every frame, so we wait for the size to settle
+	// before letting the layers know
+	_pendingWindowSize = newSize;
+	_resizeRequestTime = FramePacer::Now();
 }
 
 void Application::Quit() {
@@ -115,10 +128,10 @@ void Application::Quit() {
 }
 
 bool Application::LoadScene(const std::string & path) {
-	if (std::filesystem::exists(path)) {
+	if (VirtualFileSystem::Exists(path)) {
 
 		std::string manifestPath = std::filesystem::path(path).stem().string() + "-manifest.json";
-		if (std::filesystem::exists(manifestPath)) {
+		if (VirtualFileSystem::Exists(manifestPath)) {
 			LOG_INFO("Loading manifest from \"{}\"", manifestPath);
 			ResourceManager::LoadManifest(manifestPath);
 		}
@@ -166,19 +179,43 @@ void Application::_Run()
 	// We'll grab these since we'll need them!
 	_windowSize.x = JsonGet(_appSettings, "window_width", DEFAULT_WINDOW_WIDTH);
 	_windowSize.y = JsonGet(_appSettings, "window_height", DEFAULT_WINDOW_HEIGHT);
+	if (_appSettings.contains("frame_pacing")) {
+		_framePacer.LoadFromJson(_appSettings["frame_pacing"]);
+	}
+	_resizeDebounce = JsonGet(_appSettings, "resize_debounce_ms", 100) / 1000.0;
+	if (_appSettings.contains("physics_profiler")) {
+		Gameplay::Physics::PhysicsProfiler::LoadFromJson(_appSettings["physics_profiler"]);
+	}
+	InputEngine::LoadBindings(_appSettings.contains("input") ? _appSettings["input"] : InputEngine::GetDefaultBindings());
 
 	// By default, we want our viewport to be the whole screen
 	_primaryViewport = { 0, 0, _windowSize.x, _windowSize.y };
 
+	// Mount our asset packs before anything gets loaded, files that aren't in a pack are
+	// still loaded from loose files in the working directory
+	if (_appSettings.contains("vfs")) {
+		const nlohmann::json& vfs = _appSettings["vfs"];
+		std::vector<std::string> packs = JsonGet(vfs, "packs", std::vector<std::string>());
+		if (JsonGet(vfs, "cook_packs", false) && !packs.empty()) {
+			VirtualFileSystem::CookPack(".", packs[0]);
+		}
+		for (const std::string& pack : packs) {
+			if (std::filesystem::exists(pack)) {
+				VirtualFileSystem::MountPack(pack);
+			}
+		}
+	}
+
 	// Register all component and resource types
 	_RegisterClasses();
 
 
 	// Load all layers
 	_Load();
+	VirtualFileSystem::LogStats();
 
-	// Grab current time as the previous frame
-	double lastFrame = glfwGetTime();
+	// Start the frame clock now, so loading isn't counted as part of the first frame
+	_framePacer.Reset();
 
 	// Done loading, app is now running!
 	_isRunning = true;
@@ -193,6 +230,15 @@ void Application::_Run()
 		// Receive events like input and window position/size changes from GLFW
 		glfwPollEvents();
 
+		// Create any resources that other threads are waiting on
+		ResourceManager::ProcessMainThreadTasks();
+		// Hand off any uploads that the GPU has finished with
+		GlUploadThread::Poll();
+		// Deliver any GPU reads that have finished
+		GpuReadback::Poll();
+		// Free any transient render targets that haven't been used in a while
+		RenderTargetPool::NextFrame();
+
 		// Handle closing the app via the close button
 		if (glfwWindowShouldClose(_window)) {
 			_isRunning = false;
@@ -201,9 +247,8 @@ void Application::_Run()
 		// Grab the timing singleton instance as a reference
 		Timing& timing = Timing::_singleton;
 
-		// Figure out the current time, and the time since the last frame
-		double thisFrame = glfwGetTime();
-		float dt = static_cast<float>(thisFrame - lastFrame);
+		// Figure out the time since the last frame, the pacer will smooth and clamp it for us
+		float dt = _framePacer.BeginFrame(timing._frameCount + 1, timing._rawDeltaTime);
 		float scaledDt = dt * timing._timeScale;
 
 		// Update all timing values
@@ -213,6 +258,15 @@ void Application::_Run()
 		timing._unscaledTimeSinceAppLoad += dt;
 		timing._timeSinceSceneLoad += scaledDt;
 		timing._unscaledTimeSinceSceneLoad += dt;
+		timing._frameCount++;
+
+		// Once the window size has stopped changing, let the layers know about it
+		if (_pendingWindowSize.x * _pendingWindowSize.y > 0 && FramePacer::Now() - _resizeRequestTime >= _resizeDebounce) {
+			double start = FramePacer::Now();
+			_HandleWindowSizeChanged(_pendingWindowSize);
+			_framePacer.RecordLayerTime(nullptr, "Resize", FramePacer::Now() - start);
+			_pendingWindowSize = { 0, 0 };
+		}
 
 		ImGuiHelper::StartFrame();
 
@@ -225,13 +279,16 @@ void Application::_Run()
 			_PostRender();
 		}
 
-		// Store timing for next loop
-		lastFrame = thisFrame;
-
 		InputEngine::EndFrame();
 		ImGuiHelper::EndFrame();
 
+		// Swapping can block on vsync or the GPU, so it gets timed alongside the layers
+		double swapStart = FramePacer::Now();
 		glfwSwapBuffers(_window);
+		_framePacer.RecordLayerTime(nullptr, "SwapBuffers", FramePacer::Now() - swapStart);
+
+		// Wait for the next frame if we're running faster than the frame cap
+		_framePacer.EndFrame();
 
 	}
 
@@ -277,6 +334,7 @@ void Application::_RegisterClasses()
 	ComponentManager::RegisterType<GuiText>();
 	ComponentManager::RegisterType<TargetController>();
 	ComponentManager::RegisterType<ParticleSystem>();
+	ComponentManager::RegisterType<FlowFieldNavigation>();
 }
 
 void Application::_Load() {
@@ -298,7 +356,9 @@ void Application::_Load() {
 void Application::_Update() {
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnUpdate)) {
+			double start = FramePacer::Now();
 			layer->OnUpdate();
+			_framePacer.RecordLayerTime(layer.get(), "Update", FramePacer::Now() - start);
 		}
 	}
 }
@@ -306,7 +366,9 @@ void Application::_Update() {
 void Application::_LateUpdate() {
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnLateUpdate)) {
+			double start = FramePacer::Now();
 			layer->OnLateUpdate();
+			_framePacer.RecordLayerTime(layer.get(), "LateUpdate", FramePacer::Now() - start);
 		}
 	}
 }
@@ -323,7 +385,9 @@ void Application::_PreRender()
 
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnPreRender)) {
+			double start = FramePacer::Now();
 			layer->OnPreRender();
+			_framePacer.RecordLayerTime(layer.get(), "PreRender", FramePacer::Now() - start);
 		}
 	}
 }
@@ -333,7 +397,9 @@ void Application::_RenderScene() {
 	Framebuffer::Sptr result = nullptr;
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnRender)) {
+			double start = FramePacer::Now();
 			layer->OnRender(result);
+			_framePacer.RecordLayerTime(layer.get(), "Render", FramePacer::Now() - start);
 			Framebuffer::Sptr layerResult = layer->GetRenderOutput();
 			result = layerResult != nullptr ? layerResult : result;
 		}
@@ -347,7 +413,9 @@ void Application::_PostRender() {
 	for (auto it = _layers.crbegin(); it != _layers.crend(); it++) {
 		const auto& layer = *it;
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnPostRender)) {
+			double start = FramePacer::Now();
 			layer->OnPostRender();
+			_framePacer.RecordLayerTime(layer.get(), "PostRender", FramePacer::Now() - start);
 			Framebuffer::Sptr layerResult = layer->GetPostRenderOutput();
 			_renderOutput = layerResult != nullptr ? layerResult : _renderOutput;
 		}
@@ -386,6 +454,13 @@ void Application::_Unload() {
 
 	// Clean up ImGui
 	ImGuiHelper::Cleanup();
+
+	// Leave a record of how the session ran, useful for runs without the editor
+	_framePacer.LogSummary();
+	Gameplay::Physics::PhysicsProfiler::Export();
+
+	// Make sure any saves that are still being written make it to disk
+	AsyncFileWriter::Shutdown();
 }
 
 void Application::_HandleSceneChange() {
@@ -469,5 +544,18 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"] = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+	result["frame_pacing"] = FramePacer().ToJson();
+	// How long the window size has to stay the same before render targets are resized, in milliseconds
+	result["resize_debounce_ms"] = 100;
+	// Set an export path to write a CSV breakdown of every physics step when the app closes
+	result["physics_profiler"] = Gameplay::Physics::PhysicsProfiler::ToJson();
+	// Keys and mouse buttons for each action and axis, see InputEngine::LoadBindings
+	result["input"] = InputEngine::GetDefaultBindings();
+	result["vfs"] = {
+		// Packs to mount at startup, later packs take priority over earlier ones
+		{ "packs", { "res.pak" } },
+		// Rebuilds the first pack from the working directory on startup
+		{ "cook_packs", false }
+	};
 	return result;
 }
@@ -4,6 +4,7 @@
 #include <json.hpp>
 #include "Utils/Macros.h"
 #include "Application/ApplicationLayer.h"
+#include "Application/FramePacer.h"
 #include "Gameplay/Scene.h"
 
 struct GLFWwindow;
@@ -44,7 +45,8 @@ public:
 	 */
 	const glm::ivec2& GetWindowSize() const;
 	/**
-	 * Resizes the application window to the given size in pixels
+	 * Resizes the application window to the given size in pixels. Layers are notified once the
+	 * size has stopped changing for a moment, so GetWindowSize will lag behind while resizing
 	 *
 	 * @param newSize The new size for the window, in pixels. Should not contain zeroes or negative values
 	 */
@@ -103,6 +105,11 @@ public:
 		return nullptr;
 	}
 
+	/**
+	 * Gets the frame pacer, which handles the frame cap, delta time smoothing and frame time stats
+	 */
+	FramePacer& GetFramePacer() { return _framePacer; }
+
 	/**
 	 * Saves the application settings to a file in %APPDATA%
 	 */
@@ -126,12 +133,21 @@ protected:
 	// Not an idea way of distinguising, since we need to build editor into our game, but good 'nuff for GDW
 	bool        _isEditor;
 
+	// The size the window is being resized to, or zero if there is no resize waiting
+	glm::ivec2  _pendingWindowSize;
+	// When the pending size last changed, and how long it needs to stay the same before it's applied, in seconds
+	double      _resizeRequestTime;
+	double      _resizeDebounce;
+
 	// The primary viewport that the game will render into, in client window bounds
 	glm::uvec4  _primaryViewport;
 
 	// Stores the current application settings
 	nlohmann::json _appSettings;
 
+	// Measures frame times, and handles frame limiting
+	FramePacer  _framePacer;
+
 	// The current scene that the application is working on
 	Gameplay::Scene::Sptr _currentScene;
 	// The scene to switch to at the start of the next frame
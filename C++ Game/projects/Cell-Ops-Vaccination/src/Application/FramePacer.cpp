@@ -0,0 +1,249 @@
+#include "FramePacer.h"
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "Logging.h"
+#include "Application/ApplicationLayer.h"
+#include "Utils/ImGuiHelper.h"
+#include "Utils/JsonGlmHelpers.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+FramePacer::FramePacer() :
+	TargetFrameRate(0),
+	SpinThresholdMs(2.0f),
+	MaxDeltaTime(0.1f),
+	SmoothingFrames(1),
+	HitchThresholdMs(50.0f),
+	HitchMultiplier(2.5f),
+	LogInterval(0.0f),
+	_lastFrameStart(Now()),
+	_nextDeadline(0.0),
+	_lastLogTime(Now()),
+	_hasHighResTimer(false),
+	_history(),
+	_historyCount(0),
+	_historyHead(0),
+	_medianMs(0.0f),
+	_smoothing(),
+	_smoothingHead(0),
+	_slowestLayer(nullptr),
+	_slowestPhase(""),
+	_slowestTime(0.0),
+	_hitches(),
+	_totalHitches(0)
+{ }
+
+FramePacer::~FramePacer() {
+	_SetHighResTimer(false);
+}
+
+double FramePacer::Now() {
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void FramePacer::Reset() {
+	_lastFrameStart = Now();
+	_lastLogTime = _lastFrameStart;
+	_nextDeadline = 0.0;
+}
+
+float FramePacer::BeginFrame(uint64_t frame, float& outRawDelta) {
+	double now = Now();
+	double raw = now - _lastFrameStart;
+	_lastFrameStart = now;
+	outRawDelta = (float)raw;
+
+	// Record the length of the frame that just finished, and check it against our hitch thresholds
+	float frameMs = (float)(raw * 1000.0);
+	if (_historyCount > 0) {
+		// Sorting the history every frame would be wasteful, the median moves slowly anyways
+		if ((frame & 31) == 0 || _medianMs <= 0.0f) {
+			_medianMs = GetPercentiles().P50;
+		}
+		float median = _medianMs;
+		if (frameMs > HitchThresholdMs || (_historyCount >= 60 && frameMs > median * HitchMultiplier)) {
+			Hitch hitch;
+			hitch.Frame   = frame - 1;
+			hitch.FrameMs = frameMs;
+			hitch.Layer   = _slowestLayer != nullptr ? _slowestLayer->Name : "Application";
+			hitch.Phase   = _slowestPhase;
+			hitch.LayerMs = (float)(_slowestTime * 1000.0);
+			LOG_WARN("Hitch on frame {}: {:.2f}ms (median {:.2f}ms), slowest was {} {} at {:.2f}ms", hitch.Frame, hitch.FrameMs, median, hitch.Layer, hitch.Phase, hitch.LayerMs);
+
+			_hitches.push_back(hitch);
+			if (_hitches.size() > MAX_HITCHES) {
+				_hitches.pop_front();
+			}
+			_totalHitches++;
+		}
+	}
+	_history[_historyHead] = frameMs;
+	_historyHead = (_historyHead + 1) % HISTORY_SIZE;
+	_historyCount = std::min(_historyCount + 1, HISTORY_SIZE);
+
+	_slowestLayer = nullptr;
+	_slowestPhase = "";
+	_slowestTime = 0.0;
+
+	if (LogInterval > 0.0f && now - _lastLogTime >= LogInterval) {
+		_lastLogTime = now;
+		LogSummary();
+	}
+
+	// Clamp first, so one huge stall can't dominate the average for the next few frames
+	float dt = std::min((float)raw, MaxDeltaTime);
+	_smoothing[_smoothingHead] = dt;
+	_smoothingHead = (_smoothingHead + 1) % MAX_SMOOTHING_FRAMES;
+
+	int samples = std::clamp(SmoothingFrames, 1, std::min(MAX_SMOOTHING_FRAMES, _historyCount));
+	if (samples > 1) {
+		float total = 0.0f;
+		for (int ix = 1; ix <= samples; ix++) {
+			total += _smoothing[(_smoothingHead - ix + MAX_SMOOTHING_FRAMES) % MAX_SMOOTHING_FRAMES];
+		}
+		dt = total / samples;
+	}
+	return dt;
+}
+
+void FramePacer::EndFrame() {
+	if (TargetFrameRate <= 0) {
+		_SetHighResTimer(false);
+		_nextDeadline = 0.0;
+		return;
+	}
+	_SetHighResTimer(true);
+
+	// Deadlines advance by a fixed period so that small overshoots don't accumulate as drift. If we
+	// fell more than a frame behind, start again from now rather than trying to catch up
+	double period = 1.0 / TargetFrameRate;
+	double now = Now();
+	_nextDeadline = _nextDeadline <= 0.0 ? _lastFrameStart + period : _nextDeadline + period;
+	if (now - _nextDeadline > period) {
+		_nextDeadline = now;
+		return;
+	}
+
+	// Sleep off most of the wait (cheap, but coarse), then spin for the last stretch (precise)
+	double spin = SpinThresholdMs / 1000.0;
+	while (_nextDeadline - now > spin) {
+		std::this_thread::sleep_for(std::chrono::duration<double>(_nextDeadline - now - spin));
+		now = Now();
+	}
+	while (Now() < _nextDeadline) {
+		std::this_thread::yield();
+	}
+}
+
+void FramePacer::RecordLayerTime(const ApplicationLayer* layer, const char* phase, double seconds) {
+	if (seconds > _slowestTime) {
+		_slowestLayer = layer;
+		_slowestPhase = phase;
+		_slowestTime = seconds;
+	}
+}
+
+FramePacer::Percentiles FramePacer::GetPercentiles() const {
+	Percentiles result;
+	if (_historyCount == 0) {
+		return result;
+	}
+
+	float sorted[HISTORY_SIZE];
+	std::copy(_history, _history + _historyCount, sorted);
+	std::sort(sorted, sorted + _historyCount);
+
+	auto at = [&](float percentile) {
+		return sorted[std::min((int)(percentile * _historyCount), _historyCount - 1)];
+	};
+	result.P50 = at(0.50f);
+	result.P95 = at(0.95f);
+	result.P99 = at(0.99f);
+	result.Max = sorted[_historyCount - 1];
+	return result;
+}
+
+void FramePacer::LogSummary() const {
+	Percentiles stats = GetPercentiles();
+	LOG_INFO("Frame times over last {} frames: p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms, {} hitches total",
+		_historyCount, stats.P50, stats.P95, stats.P99, stats.Max, _totalHitches);
+	for (const Hitch& hitch : _hitches) {
+		LOG_INFO("\tFrame {}: {:.2f}ms, slowest {} {} at {:.2f}ms", hitch.Frame, hitch.FrameMs, hitch.Layer, hitch.Phase, hitch.LayerMs);
+	}
+}
+
+void FramePacer::RenderImGui() {
+	Percentiles stats = GetPercentiles();
+	ImGui::Text("p50 %.2fms  p95 %.2fms  p99 %.2fms  max %.2fms", stats.P50, stats.P95, stats.P99, stats.Max);
+
+	// Once the ring buffer is full, the oldest sample is at the head
+	int offset = _historyCount < HISTORY_SIZE ? 0 : _historyHead;
+	ImGui::PlotLines("##frame_times", _history, _historyCount, offset, nullptr, 0.0f, std::max(stats.P99 * 1.5f, 1.0f), ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+
+	if (ImGui::CollapsingHeader("Pacing")) {
+		LABEL_LEFT(ImGui::DragInt, "Target FPS      ", &TargetFrameRate, 1.0f, 0, 500);
+		LABEL_LEFT(ImGui::DragFloat, "Spin Threshold  ", &SpinThresholdMs, 0.1f, 0.0f, 10.0f);
+		LABEL_LEFT(ImGui::DragFloat, "Max Delta Time  ", &MaxDeltaTime, 0.005f, 0.001f, 1.0f);
+		LABEL_LEFT(ImGui::SliderInt, "Smoothing Frames", &SmoothingFrames, 1, MAX_SMOOTHING_FRAMES);
+		LABEL_LEFT(ImGui::DragFloat, "Hitch Threshold ", &HitchThresholdMs, 0.5f, 1.0f, 1000.0f);
+		LABEL_LEFT(ImGui::DragFloat, "Hitch Multiplier", &HitchMultiplier, 0.1f, 1.0f, 20.0f);
+		LABEL_LEFT(ImGui::DragFloat, "Log Interval    ", &LogInterval, 1.0f, 0.0f, 3600.0f);
+	}
+
+	if (ImGui::CollapsingHeader("Hitches")) {
+		ImGui::Text("Total: %d", (int)_totalHitches);
+		for (auto it = _hitches.rbegin(); it != _hitches.rend(); it++) {
+			ImGui::Text("#%d  %.2fms  %s %s (%.2fms)", (int)it->Frame, it->FrameMs, it->Layer.c_str(), it->Phase.c_str(), it->LayerMs);
+		}
+	}
+}
+
+nlohmann::json FramePacer::ToJson() const {
+	return {
+		{ "target_frame_rate", TargetFrameRate },
+		{ "spin_threshold_ms", SpinThresholdMs },
+		{ "max_delta_time", MaxDeltaTime },
+		{ "smoothing_frames", SmoothingFrames },
+		{ "hitch_threshold_ms", HitchThresholdMs },
+		{ "hitch_multiplier", HitchMultiplier },
+		{ "log_interval", LogInterval }
+	};
+}
+
+void FramePacer::LoadFromJson(const nlohmann::json& blob) {
+	if (!blob.is_object()) {
+		return;
+	}
+	TargetFrameRate  = JsonGet(blob, "target_frame_rate", TargetFrameRate);
+	SpinThresholdMs  = JsonGet(blob, "spin_threshold_ms", SpinThresholdMs);
+	MaxDeltaTime     = JsonGet(blob, "max_delta_time", MaxDeltaTime);
+	SmoothingFrames  = JsonGet(blob, "smoothing_frames", SmoothingFrames);
+	HitchThresholdMs = JsonGet(blob, "hitch_threshold_ms", HitchThresholdMs);
+	HitchMultiplier  = JsonGet(blob, "hitch_multiplier", HitchMultiplier);
+	LogInterval      = JsonGet(blob, "log_interval", LogInterval);
+}
+
+void FramePacer::_SetHighResTimer(bool enabled) {
+	if (enabled == _hasHighResTimer) {
+		return;
+	}
+	_hasHighResTimer = enabled;
+	#ifdef _WIN32
+	// The default scheduler tick on windows is ~15.6ms, far too coarse to sleep with
+	if (enabled) {
+		timeBeginPeriod(1);
+	} else {
+		timeEndPeriod(1);
+	}
+	#endif
+}
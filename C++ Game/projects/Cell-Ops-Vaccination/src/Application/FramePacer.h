@@ -0,0 +1,139 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <json.hpp>
+
+class ApplicationLayer;
+
+/**
+ * The frame pacer owns the application's frame clock. It measures frame times with a
+ * high resolution monotonic clock, optionally caps the frame rate, smooths and clamps
+ * the delta time handed to gameplay, and keeps a rolling history of frame times along
+ * with a log of hitches that records which layer ran long
+ */
+class FramePacer final {
+public:
+	// Number of frames kept in the rolling frame time history
+	static const int HISTORY_SIZE = 512;
+	// Number of hitches kept in the hitch log
+	static const int MAX_HITCHES = 32;
+
+	/**
+	 * Describes a single frame that took significantly longer than usual
+	 */
+	struct Hitch {
+		uint64_t    Frame;
+		float       FrameMs;
+		// The layer and phase that took the longest during the frame
+		std::string Layer;
+		std::string Phase;
+		float       LayerMs;
+	};
+
+	/**
+	 * Frame time percentiles over the rolling history, in milliseconds
+	 */
+	struct Percentiles {
+		float P50 = 0.0f;
+		float P95 = 0.0f;
+		float P99 = 0.0f;
+		float Max = 0.0f;
+	};
+
+	// Frame rate to cap to, or 0 to run unlimited (vsync will still apply)
+	int   TargetFrameRate;
+	// How close to the deadline the limiter stops sleeping and starts spinning, in milliseconds
+	float SpinThresholdMs;
+	// Largest delta time handed to gameplay, in seconds. Stops big stalls from launching objects through walls
+	float MaxDeltaTime;
+	// Number of frames to average delta time over, 1 to disable smoothing
+	int   SmoothingFrames;
+	// Frames longer than this are always counted as hitches, in milliseconds
+	float HitchThresholdMs;
+	// Frames longer than this multiple of the median frame time are counted as hitches
+	float HitchMultiplier;
+	// How often to write a frame time summary to the log, in seconds, or 0 to only log on shutdown
+	float LogInterval;
+
+	FramePacer();
+	~FramePacer();
+
+	/**
+	 * Gets the current time in seconds from a high resolution monotonic clock
+	 */
+	static double Now();
+
+	/**
+	 * Restarts the frame clock, should be called right before the first frame so that
+	 * loading times don't get counted as a frame
+	 */
+	void Reset();
+
+	/**
+	 * Marks the start of a new frame, recording the length of the previous frame and
+	 * checking it for hitches
+	 *
+	 * @param frame The index of the frame that is starting
+	 * @param outRawDelta Receives the measured time since the last frame, in seconds
+	 * @returns The smoothed and clamped delta time to use for this frame, in seconds
+	 */
+	float BeginFrame(uint64_t frame, float& outRawDelta);
+
+	/**
+	 * Marks the end of a frame, waiting until the next frame is due if the limiter is enabled
+	 */
+	void EndFrame();
+
+	/**
+	 * Records how long a layer took to run one of its phases this frame
+	 *
+	 * @param layer The layer that was invoked, or nullptr for work done by the application itself
+	 * @param phase The name of the phase, should be a string literal
+	 * @param seconds How long the layer took, in seconds
+	 */
+	void RecordLayerTime(const ApplicationLayer* layer, const char* phase, double seconds);
+
+	/**
+	 * Calculates the frame time percentiles over the rolling history
+	 */
+	Percentiles GetPercentiles() const;
+	const std::deque<Hitch>& GetHitches() const { return _hitches; }
+
+	/**
+	 * Writes a summary of frame times and recent hitches to the log
+	 */
+	void LogSummary() const;
+
+	void RenderImGui();
+
+	nlohmann::json ToJson() const;
+	void LoadFromJson(const nlohmann::json& blob);
+
+private:
+	double   _lastFrameStart;
+	double   _nextDeadline;
+	double   _lastLogTime;
+	bool     _hasHighResTimer;
+
+	// Ring buffer of raw frame times in milliseconds
+	float    _history[HISTORY_SIZE];
+	int      _historyCount;
+	int      _historyHead;
+	float    _medianMs;
+
+	// Ring buffer of recent delta times used for smoothing, in seconds
+	static const int MAX_SMOOTHING_FRAMES = 16;
+	float    _smoothing[MAX_SMOOTHING_FRAMES];
+	int      _smoothingHead;
+
+	// Slowest layer phase of the frame currently running
+	const ApplicationLayer* _slowestLayer;
+	const char*             _slowestPhase;
+	double                  _slowestTime;
+
+	std::deque<Hitch> _hitches;
+	uint64_t          _totalHitches;
+
+	void _SetHighResTimer(bool enabled);
+};
@@ -76,9 +76,11 @@
 
 #include "Application/Application.h"
 #include "Gameplay/Components/ParticleSystem.h"
+#include "Gameplay/Components/FlowFieldNavigation.h"
 
 DefaultSceneLayer::DefaultSceneLayer() :
-	ApplicationLayer()
+	ApplicationLayer(),
+	_randomSeed(RandomService::DEFAULT_SEED)
 {
 	Name = "Default Scene";
 	Overrides = AppLayerFunctions::OnAppLoad;
@@ -87,9 +89,18 @@ DefaultSceneLayer::DefaultSceneLayer() :
 DefaultSceneLayer::~DefaultSceneLayer() = default;
 
 void DefaultSceneLayer::OnAppLoad(const nlohmann::json& config) {
+	if (config.contains(Name)) {
+		_randomSeed = JsonGet(config[Name], "random_seed", _randomSeed);
+	}
 	_CreateScene();
 }
 
+nlohmann::json DefaultSceneLayer::GetDefaultConfig() {
+	return {
+		{ "random_seed", RandomService::DEFAULT_SEED }
+	};
+}
+
 void DefaultSceneLayer::_CreateScene()
 {
 	using namespace Gameplay;
@@ -242,6 +253,10 @@ void DefaultSceneLayer::_CreateScene()
 		// Create an empty scene
 		Scene::Sptr scene = std::make_shared<Scene>();
 
+		// Seed the scene's random streams from the settings, so layouts and spawns are reproducible
+		scene->Random.SetSeed(_randomSeed);
+		RandomStream& layout = scene->Random.GetStream("background_layout");
+
 		// Setting up our enviroment map
 		scene->SetSkyboxTexture(testCubemap);
 		scene->SetSkyboxShader(skyboxShader);
@@ -255,6 +270,7 @@ void DefaultSceneLayer::_CreateScene()
 			PlayerMaterial->Name = "PlayerMaterial";
 			PlayerMaterial->Set("u_Material.Diffuse", PlayerTexture);
 			PlayerMaterial->Set("u_Material.Shininess", 0.1f);
+			PlayerMaterial->IsDeferred = true;
 		}
 		// Enemy Materials
 		Material::Sptr LargeEnemyMaterial = ResourceManager::CreateAsset<Material>(AnimationShader);
@@ -262,18 +278,21 @@ void DefaultSceneLayer::_CreateScene()
 			LargeEnemyMaterial->Name = "LargeEnemyMaterial";
 			LargeEnemyMaterial->Set("u_Material.Diffuse", LargeEnemyTexture);
 			LargeEnemyMaterial->Set("u_Material.Shininess", 0.1f);
+			LargeEnemyMaterial->IsDeferred = true;
 		}
 		Material::Sptr NormalEnemyMaterial = ResourceManager::CreateAsset<Material>(AnimationShader);
 		{
 			NormalEnemyMaterial->Name = "NormalEnemyMaterial";
 			NormalEnemyMaterial->Set("u_Material.Diffuse", NormalEnemyTexture);
 			NormalEnemyMaterial->Set("u_Material.Shininess", 0.1f);
+			NormalEnemyMaterial->IsDeferred = true;
 		}
 		Material::Sptr FastEnemyMaterial = ResourceManager::CreateAsset<Material>(basicShader);
 		{
 			FastEnemyMaterial->Name = "FastEnemyMaterial";
 			FastEnemyMaterial->Set("u_Material.Diffuse", FastEnemyTexture);
 			FastEnemyMaterial->Set("u_Material.Shininess", 0.1f);
+			FastEnemyMaterial->IsDeferred = true;
 		}
 		// Target Material
 		Material::Sptr LeftLungMaterial = ResourceManager::CreateAsset<Material>(basicShader);
@@ -281,24 +300,28 @@ void DefaultSceneLayer::_CreateScene()
 			LeftLungMaterial->Name = "LeftLungMaterial";
 			LeftLungMaterial->Set("u_Material.Diffuse", LeftLungTexture);
 			LeftLungMaterial->Set("u_Material.Shininess", 0.1f);
+			LeftLungMaterial->IsDeferred = true;
 		}
 		Material::Sptr RightLungMaterial = ResourceManager::CreateAsset<Material>(basicShader);
 		{
 			RightLungMaterial->Name = "LeftLungMaterial";
 			RightLungMaterial->Set("u_Material.Diffuse", RightLungTexture);
 			RightLungMaterial->Set("u_Material.Shininess", 0.1f);
+			RightLungMaterial->IsDeferred = true;
 		}
 		Material::Sptr HeartMaterial = ResourceManager::CreateAsset<Material>(basicShader);
 		{
 			HeartMaterial->Name = "HeartMaterial";
 			HeartMaterial->Set("u_Material.Diffuse", HeartTexture);
 			HeartMaterial->Set("u_Material.Shininess", 0.1f);
+			HeartMaterial->IsDeferred = true;
 		}
 		Material::Sptr KidneyMaterial = ResourceManager::CreateAsset<Material>(basicShader);
 		{
 			KidneyMaterial->Name = "KidneyMateriall";
 			KidneyMaterial->Set("u_Material.Diffuse", KidneyTexture);
 			KidneyMaterial->Set("u_Material.Shininess", 0.1f);
+			KidneyMaterial->IsDeferred = true;
 		}
 
 		// Background Materials
@@ -521,6 +544,12 @@ void DefaultSceneLayer::_CreateScene()
 
 			//scene->EnemySpawnerObjects.push_back(EnemySpawner);
 		}
+
+		// Builds the flow fields that enemies use to path around obstacles to their targets
+		GameObject::Sptr Navigation = scene->CreateGameObject("Navigation");
+		{
+			Navigation->Add<FlowFieldNavigation>();
+		}
 		//GameObject::Sptr EnemySpawner2 = scene->CreateGameObject("Enemy Spawner 2");
 		//{
 		//	EnemySpawner2->Add<EnemySpawnerBehaviour>();
@@ -583,9 +612,9 @@ void DefaultSceneLayer::_CreateScene()
 
 		GameObject::Sptr APC = scene->CreateGameObject("APC");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			APC->SetPostion(glm::vec3(x, y, z));
 
 
@@ -600,9 +629,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr APC2 = scene->CreateGameObject("APC2");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			APC2->SetPostion(glm::vec3(x, y, z));
 
 
@@ -616,9 +645,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Bronchi = scene->CreateGameObject("Bronchi");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Bronchi->SetPostion(glm::vec3(x, y, z));
 
 
@@ -633,9 +662,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Cell = scene->CreateGameObject("Cell");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Cell->SetPostion(glm::vec3(x, y, z));
 
 
@@ -650,9 +679,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Cell2 = scene->CreateGameObject("Cell2");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Cell2->SetPostion(glm::vec3(x, y, z));
 
 
@@ -666,9 +695,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Co2 = scene->CreateGameObject("Co2");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Co2->SetPostion(glm::vec3(x, y, z));
 
 
@@ -683,9 +712,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Mca = scene->CreateGameObject("Mca");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Mca->SetPostion(glm::vec3(x, y, z));
 
 
@@ -700,9 +729,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Microbiota = scene->CreateGameObject("Microbiota");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Microbiota->SetPostion(glm::vec3(x, y, z));
 
 
@@ -716,9 +745,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr NewGerm = scene->CreateGameObject("NewGerm");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			NewGerm->SetPostion(glm::vec3(x, y, z));
 
 
@@ -732,9 +761,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Oxygen = scene->CreateGameObject("Oxygen");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Oxygen->SetPostion(glm::vec3(x, y, z));
 
 
@@ -763,9 +792,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Smokeplaque = scene->CreateGameObject("Smokeplaque");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Smokeplaque->SetPostion(glm::vec3(x, y, z));
 
 
@@ -780,9 +809,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Symbiont = scene->CreateGameObject("Symbiont");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Symbiont->SetPostion(glm::vec3(x, y, z));
 
 
@@ -797,9 +826,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr Symbiont2 = scene->CreateGameObject("Symbiont2");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			Symbiont2->SetPostion(glm::vec3(x, y, z));
 
 			// Add a render component
@@ -861,9 +890,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr WhiteBloodCell = scene->CreateGameObject("WhiteBloodCell");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			WhiteBloodCell->SetPostion(glm::vec3(x, y, z));
 
 
@@ -878,9 +907,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr WhiteBloodCell2 = scene->CreateGameObject("WhiteBloodCell2");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			WhiteBloodCell2->SetPostion(glm::vec3(x, y, z));
 
 
@@ -894,9 +923,9 @@ void DefaultSceneLayer::_CreateScene()
 		}
 		GameObject::Sptr YellowMicrobiota = scene->CreateGameObject("YellowMicrobiota");
 		{
-			float x = (float)(rand() % 100 + (-50));
-			float y = (float)(rand() % 100 + (-50));
-			float z = (float)(rand() % 100 + (-50));
+			float x = (float)layout.Range(-50, 50);
+			float y = (float)layout.Range(-50, 50);
+			float z = (float)layout.Range(-50, 50);
 			YellowMicrobiota->SetPostion(glm::vec3(x, y, z));
 
 
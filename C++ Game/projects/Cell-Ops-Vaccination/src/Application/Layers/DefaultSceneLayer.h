@@ -16,7 +16,11 @@ public:
 	// Inherited from ApplicationLayer
 
 	virtual void OnAppLoad(const nlohmann::json& config) override;
+	virtual nlohmann::json GetDefaultConfig() override;
 
 protected:
+	// Seed for the scene's random streams, set with "random_seed" in the layer's settings
+	uint64_t _randomSeed;
+
 	void _CreateScene();
 };
\ No newline at end of file
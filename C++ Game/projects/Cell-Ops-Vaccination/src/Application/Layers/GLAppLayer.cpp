@@ -2,6 +2,11 @@
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 #include "Application/Application.h"
+#include "Graphics/GlUploadThread.h"
+#include "Graphics/GpuReadback.h"
+#include "Graphics/SamplerCache.h"
+#include "Graphics/RenderTargetPool.h"
+#include "Utils/JsonGlmHelpers.h"
 
 GLAppLayer::GLAppLayer() :
 	ApplicationLayer() {
@@ -27,11 +32,23 @@ void GLAppLayer::OnAppLoad(const nlohmann::json & config) {
 	LOG_ASSERT(gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) != 0, "Failed to initialize glad");
 
 	glEnable(GL_PROGRAM_POINT_SIZE);
+
+	// Textures and buffers marked for async upload get created on a second, shared context
+	if (!config.contains(Name) || JsonGet(config[Name], "upload_thread", true)) {
+		GlUploadThread::Init(app._window);
+	}
 }
 
 void GLAppLayer::OnAppUnload()
 {
 	Application& app = Application::Get();
+
+	// The upload context shares with our window, so it has to go first
+	GlUploadThread::Shutdown();
+	GpuReadback::Shutdown();
+	SamplerCache::Shutdown();
+	RenderTargetPool::Shutdown();
+
 	glfwDestroyWindow(app._window);
 	app._window = nullptr;
 	app._windowSize = glm::ivec2(0, 0);
@@ -40,6 +57,12 @@ void GLAppLayer::OnAppUnload()
 	glfwTerminate();
 }
 
+nlohmann::json GLAppLayer::GetDefaultConfig() {
+	return {
+		{ "upload_thread", true }
+	};
+}
+
 void GLAppLayer::GlDebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar * message, const void* userParam) {
 	std::string sourceTxt;
 	switch (source) {
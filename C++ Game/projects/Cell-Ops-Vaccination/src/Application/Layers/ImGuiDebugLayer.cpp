@@ -3,6 +3,7 @@
 #include "Utils/ImGuiHelper.h"
 #include "../Windows/HierarchyWindow.h"
 #include "../Windows/InspectorWindow.h"
+#include "../Windows/FrameTimingWindow.h"
 #include "imgui_internal.h"
 #include "Gameplay/Scene.h"
 #include "../Timing.h"
@@ -26,6 +27,7 @@ void ImGuiDebugLayer::OnAppLoad(const nlohmann::json & config)
 	// Register our windows
 	RegisterWindow<HierarchyWindow>();
 	RegisterWindow<InspectorWindow>();
+	RegisterWindow<FrameTimingWindow>();
 }
 
 void ImGuiDebugLayer::OnAppUnload()
@@ -252,6 +254,7 @@ void ImGuiDebugLayer::_RenderGameWindow()
 		if (BulletDebugDraw::DrawModeGui("Physics Debug Mode:", physicsDrawMode)) {
 			app.CurrentScene()->SetPhysicsDebugDrawMode(physicsDrawMode);
 		}
+		app.CurrentScene()->GetPhysicsDebugDraw().RenderFilterImGui();
 
 		ImGui::EndPopup();
 	}
@@ -270,7 +273,7 @@ void ImGuiDebugLayer::_RenderGameWindow()
 	if (ImGui::Button(buffer)) {
 		// Save scene so it can be restored when exiting play mode
 		if (!scene->IsPlaying) {
-			_backupState = scene->ToJson();
+			_backupState = scene->CaptureState();
 		}
 
 		// Toggle state
@@ -278,10 +281,9 @@ void ImGuiDebugLayer::_RenderGameWindow()
 
 		// If we've gone from playing to not playing, restore the state from before we started playing
 		if (!scene->IsPlaying) {
-			scene = nullptr;
-			// We reload to scene from our cached state
-			scene = Scene::FromJson(_backupState);
-			app.LoadScene(scene);
+			// We roll the scene back in place, so nothing needs to be reloaded or re-awoken
+			scene->RestoreState(_backupState);
+			_backupState = nullptr;
 		}
 	}
 
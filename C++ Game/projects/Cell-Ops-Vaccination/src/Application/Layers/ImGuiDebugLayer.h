@@ -1,6 +1,7 @@
 #pragma once
 #include "../ApplicationLayer.h"
 #include "Gameplay/Physics/BulletDebugDraw.h"
+#include "Gameplay/Scene.h"
 #include "../IEditorWindow.h"
 #include "Logging.h"
 
@@ -49,7 +50,7 @@ public:
 
 protected:
 	std::vector<IEditorWindow::Sptr> _windows;
-	nlohmann::json _backupState;
+	std::shared_ptr<Gameplay::Scene::StateSnapshot> _backupState;
 	bool           _dockInvalid;
 
 	void _RenderGameWindow();
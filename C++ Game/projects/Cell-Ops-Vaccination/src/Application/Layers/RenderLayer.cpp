@@ -4,9 +4,15 @@
 #include "Gameplay/Components/Camera.h"
 #include "Graphics/DebugDraw.h"
 #include "Graphics/TextureCube.h"
+#include "Graphics/SamplerCache.h"
+#include "Graphics/TextureStreamer.h"
+#include "Graphics/RenderTargetPool.h"
 #include "../Timing.h"
 #include "Gameplay/Components/ComponentManager.h"
 #include "Gameplay/Components/RenderComponent.h"
+#include "Utils/JsonGlmHelpers.h"
+
+#include <algorithm>
 
 // GLM math library
 #include <GLM/glm.hpp>
@@ -22,6 +28,24 @@ RenderLayer::RenderLayer() :
 	_blitFbo(true),
 	_frameUniforms(nullptr),
 	_instanceUniforms(nullptr),
+	_objectLightUniforms(nullptr),
+	_oitEnabled(true),
+	_oitCompositeShader(nullptr),
+	_fullscreenVao(nullptr),
+	_deferredEnabled(true),
+	_deferredLightingShader(nullptr),
+	_deferredObjects(),
+	_forwardObjects(),
+	_transparentObjects(),
+	_taa(nullptr),
+	_velocityShader(nullptr),
+	_prevViewProj(glm::mat4(1.0f)),
+	_prevTransforms(),
+	_currentTransforms(),
+	_movingObjects(),
+	_targetSize(glm::ivec2(0)),
+	_lastResizeMs(0.0f),
+	_resizeCount(0),
 	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f })
 {
 	Name = "Rendering";
@@ -36,6 +60,12 @@ void RenderLayer::OnRender(const Framebuffer::Sptr & prevLayer)
 
 	Application& app = Application::Get();
 
+	// Resizes are applied here instead of in OnWindowResize, so the render targets only get
+	// reallocated once, right before they're needed
+	if (_targetSize != _primaryFBO->GetSize()) {
+		_ApplyResize();
+	}
+
 	glViewport(0, 0, _primaryFBO->GetWidth(), _primaryFBO->GetHeight());
 
 	// We bind our framebuffer so we can render to it
@@ -48,8 +78,16 @@ void RenderLayer::OnRender(const Framebuffer::Sptr & prevLayer)
 	// Grab shorthands to the camera and shader from the scene
 	Camera::Sptr camera = app.CurrentScene()->MainCamera;
 
-	// Cache the camera's viewprojection
-	glm::mat4 viewProj = camera->GetViewProjection();
+	// Cache the camera's viewprojection. With TAA on, every frame is rendered with a slightly
+	// different sub-pixel offset, which the resolve pass blends together
+	glm::mat4 unjitteredViewProj = camera->GetViewProjection();
+	glm::mat4 projection = camera->GetProjection();
+	glm::vec2 jitter = glm::vec2(0.0f);
+	if (_taa != nullptr) {
+		jitter = _taa->GetJitter(Timing::Current().FrameCount());
+		projection = TemporalAntiAliasing::JitterProjection(projection, jitter, _primaryFBO->GetSize());
+	}
+	glm::mat4 viewProj = projection * camera->GetView();
 	DebugDrawer::Get().SetViewProjection(viewProj);
 
 	// Make sure depth testing and culling are re-enabled
@@ -58,7 +96,6 @@ void RenderLayer::OnRender(const Framebuffer::Sptr & prevLayer)
 
 	// The current material that is bound for rendering
 	Material::Sptr currentMat = nullptr;
-	ShaderProgram::Sptr shader = nullptr;
 
 	// Bind the skybox texture to a reserved texture slot
 	// See Material.h and Material.cpp for how we're reserving texture slots
@@ -69,23 +106,33 @@ void RenderLayer::OnRender(const Framebuffer::Sptr & prevLayer)
 	app.CurrentScene()->PreRender();
 	_frameUniforms->Bind(FRAME_UBO_BINDING);
 	_instanceUniforms->Bind(INSTANCE_UBO_BINDING);
+	_objectLightUniforms->Bind(OBJECT_LIGHT_UBO_BINDING);
 
 	// Draw physics debug
 	app.CurrentScene()->DrawPhysicsDebug();
 
-	// Upload frame level uniforms
-	auto& frameData = _frameUniforms->GetData();
-	frameData.u_Projection = camera->GetProjection();
-	frameData.u_View = camera->GetView();
-	frameData.u_ViewProjection = camera->GetViewProjection();
-	frameData.u_CameraPos = glm::vec4(camera->GetGameObject()->GetPosition(), 1.0f);
-	frameData.u_Time = static_cast<float>(Timing::Current().TimeSinceSceneLoad());
-	frameData.u_DeltaTime = Timing::Current().DeltaTime();
-	_frameUniforms->Update();
+	// Upload frame level uniforms, only the fields that changed since last frame get sent
+	_frameUniforms->Set(&FrameLevelUniforms::u_Projection, projection);
+	_frameUniforms->Set(&FrameLevelUniforms::u_View, camera->GetView());
+	_frameUniforms->Set(&FrameLevelUniforms::u_ViewProjection, viewProj);
+	_frameUniforms->Set(&FrameLevelUniforms::u_CameraPos, glm::vec4(camera->GetGameObject()->GetPosition(), 1.0f));
+	_frameUniforms->Set(&FrameLevelUniforms::u_Time, static_cast<float>(Timing::Current().TimeSinceSceneLoad()));
+	_frameUniforms->Set(&FrameLevelUniforms::u_DeltaTime, Timing::Current().DeltaTime());
+	_frameUniforms->Set(&FrameLevelUniforms::u_DeferredPass, 0);
+	_frameUniforms->Flush();
 
 	Material::Sptr defaultMat = app.CurrentScene()->DefaultMaterial;
+	bool useDeferred = _deferredEnabled && app.CurrentScene()->UseDeferredShading;
+	_deferredObjects.clear();
+	_forwardObjects.clear();
+	_transparentObjects.clear();
+	_movingObjects.clear();
+
+	// Scales an object's world space radius to its size on screen in pixels, for texture streaming
+	glm::vec3 cameraPos = camera->GetGameObject()->GetPosition();
+	float pixelsPerUnit = projection[1][1] * 0.5f * _primaryFBO->GetHeight();
 
-	// Render all our objects
+	// Sort our objects into the passes that will draw them
 	app.CurrentScene()->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
 		// Early bail if mesh not set
 		if (renderable->GetMesh() == nullptr) {
@@ -103,49 +150,311 @@ void RenderLayer::OnRender(const Framebuffer::Sptr & prevLayer)
 			}
 		}
 
-		// If the material has changed, we need to bind the new shader and set up our material and frame data
-		// Note: This is a good reason why we should be sorting the render components in ComponentManager
-		if (renderable->GetMaterial() != currentMat) {
-			currentMat = renderable->GetMaterial();
-			shader = currentMat->GetShader();
-
-			shader->Bind();
-			currentMat->Apply();
+		// Let streamed textures know roughly how big they'll be on screen, assuming the
+		// texture is stretched across the object once
+		{
+			const glm::mat4& transform = renderable->GetGameObject()->GetTransform();
+			float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+			float distance = glm::max(glm::distance(cameraPos, glm::vec3(transform[3])), 0.01f);
+			renderable->GetMaterial()->RequestScreenSize(2.0f * renderable->BoundingRadius * scale * pixelsPerUnit / distance);
 		}
 
-		// Grab the game object so we can do some stuff with it
-		GameObject* object = renderable->GetGameObject();
+		// Transparent objects need everything behind them to be drawn first
+		if (renderable->GetMaterial()->IsTransparent) {
+			glm::vec4 viewPos = camera->GetView() * glm::vec4(renderable->GetGameObject()->GetPosition(), 1.0f);
+			_transparentObjects.push_back(std::make_pair(viewPos.z, renderable.get()));
+			return;
+		}
 
-		// Use our uniform buffer for our instance level uniforms
-		auto& instanceData = _instanceUniforms->GetData();
-		instanceData.u_Model = object->GetTransform();
-		instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
-		instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
-		_instanceUniforms->Update();
+		if (useDeferred && renderable->GetMaterial()->IsDeferred) {
+			_deferredObjects.push_back(renderable.get());
+		} else {
+			_forwardObjects.push_back(renderable.get());
+		}
 
-		// Draw the object
-		renderable->GetMesh()->Draw();
+		// Remember where the object was, so TAA can tell which objects are moving
+		if (_taa != nullptr) {
+			const glm::mat4& transform = renderable->GetGameObject()->GetTransform();
+			_currentTransforms[renderable.get()] = transform;
+			auto it = _prevTransforms.find(renderable.get());
+			if (it != _prevTransforms.end() && it->second != transform) {
+				_movingObjects.push_back(std::make_pair(renderable.get(), it->second));
+			}
+		}
 		});
 
+	// Deferred surfaces have to go first, since the lighting pass lights every pixel with depth
+	if (!_deferredObjects.empty()) {
+		_RenderDeferred(viewProj);
+	}
+
+	// Render the rest of our opaque objects
+	for (RenderComponent* renderable : _forwardObjects) {
+		_DrawRenderable(renderable, viewProj, currentMat);
+	}
+
 	// Use our cubemap to draw our skybox
 	app.CurrentScene()->DrawSkybox();
 
+	if (_taa != nullptr) {
+		_RenderVelocity(viewProj, unjitteredViewProj);
+	}
+
+	// Draw transparent objects over top of the opaque scene
+	if (!_transparentObjects.empty()) {
+		if (_oitEnabled) {
+			_RenderTransparentOit(viewProj);
+		} else {
+			_RenderTransparentSorted(viewProj);
+		}
+	}
+
+	if (_taa != nullptr) {
+		_taa->Resolve(_primaryFBO, RenderTargetAttachment::Color3, unjitteredViewProj, _prevViewProj, jitter);
+		_ReleaseTransient(RenderTargetAttachment::Color3);
+
+		_prevViewProj = unjitteredViewProj;
+		std::swap(_prevTransforms, _currentTransforms);
+		_currentTransforms.clear();
+	}
+
+	// The fullscreen passes may have replaced the environment map
+	if (environment) environment->Bind(0);
+
 	// Unbind our primary framebuffer so subsequent draw calls do not modify it
 	//_primaryFBO->Unbind();
 
 	VertexArrayObject::Unbind();
+
+	// Now that we know what was drawn this frame, stream texture levels in and out
+	TextureStreamer::Update();
 }
 
-void RenderLayer::OnWindowResize(const glm::ivec2 & oldSize, const glm::ivec2 & newSize)
-{
-	if (newSize.x * newSize.y == 0) return;
+void RenderLayer::_DrawRenderable(RenderComponent* renderable, const glm::mat4& viewProj, Gameplay::Material::Sptr& currentMat, bool selectLights) {
+	using namespace Gameplay;
+
+	// If the material has changed, we need to bind the new shader and set up our material and frame data
+	// Note: This is a good reason why we should be sorting the render components in ComponentManager
+	if (renderable->GetMaterial() != currentMat) {
+		currentMat = renderable->GetMaterial();
+		currentMat->GetShader()->Bind();
+		currentMat->Apply();
+	}
+
+	// Grab the game object so we can do some stuff with it
+	GameObject* object = renderable->GetGameObject();
+
+	// Use our uniform buffer for our instance level uniforms
+	auto& instanceData = _instanceUniforms->GetData();
+	instanceData.u_Model = object->GetTransform();
+	instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
+	instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
+	_instanceUniforms->Update();
+
+	// Pick the lights that affect this object. Neighbouring objects usually end up with the
+	// same lights, in which case nothing needs to be uploaded
+	if (selectLights) {
+		const LightCuller& lightCuller = object->GetScene()->GetLightCuller();
+		const glm::mat4& transform = object->GetTransform();
+		float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		int lights[LightCuller::MAX_LIGHTS_PER_OBJECT] = { 0 };
+		int numLights = lightCuller.Select(glm::vec3(transform[3]), renderable->BoundingRadius * scale, lights);
+		for (int ix = 0; ix < LightCuller::MAX_LIGHTS_PER_OBJECT / 4; ix++) {
+			_objectLightUniforms->SetElement(&ObjectLightUniforms::LightIndices, ix, glm::ivec4(lights[ix * 4], lights[ix * 4 + 1], lights[ix * 4 + 2], lights[ix * 4 + 3]));
+		}
+		_objectLightUniforms->Set(&ObjectLightUniforms::NumLights, numLights);
+		_objectLightUniforms->Flush();
+	}
+
+	// Draw the object
+	renderable->GetMesh()->Draw();
+}
+
+void RenderLayer::_RenderDeferred(const glm::mat4& viewProj) {
+	// The G-buffer is kept small, albedo and shininess in one target, and normals packed into 2
+	// channels in another. Positions are rebuilt from the depth buffer we already have. It's only
+	// needed until the lighting pass is done with it, so it's borrowed from the pool
+	_AttachTransient(RenderTargetAttachment::Color4, RenderTargetType::ColorRgba8);
+	_AttachTransient(RenderTargetAttachment::Color5, RenderTargetType::ColorRg16F);
+
+	// Fill the G-buffer, materials see u_DeferredPass and write their surface instead of lighting it
+	_frameUniforms->Set(&FrameLevelUniforms::u_DeferredPass, 1);
+	_frameUniforms->Flush();
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Color4, RenderTargetAttachment::Color5 });
+
+	Gameplay::Material::Sptr currentMat = nullptr;
+	for (RenderComponent* renderable : _deferredObjects) {
+		_DrawRenderable(renderable, viewProj, currentMat, false);
+	}
+
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Color0 });
+	_frameUniforms->Set(&FrameLevelUniforms::u_DeferredPass, 0);
+	_frameUniforms->Flush();
+
+	// Light every covered pixel in one dispatch, writing straight into the scene color
+	_deferredLightingShader->Bind();
+	_deferredLightingShader->SetUniformMatrix("u_InvViewProjection", glm::inverse(viewProj));
+	_deferredLightingShader->SetUniform("u_LightCutoff", Application::Get().CurrentScene()->GetLightCuller().CutoffIntensity);
+	_primaryFBO->BindAttachment(RenderTargetAttachment::Color4, 1);
+	_primaryFBO->BindAttachment(RenderTargetAttachment::Color5, 2);
+	_primaryFBO->BindAttachment(RenderTargetAttachment::DepthStencil, 3);
+	Texture2D::Sptr output = _primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color0);
+	glBindImageTexture(0, output->GetHandle(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+	// Must match TILE_SIZE in compute_shaders/deferred_lighting.glsl
+	const int tileSize = 16;
+	glDispatchCompute((_primaryFBO->GetWidth() + tileSize - 1) / tileSize, (_primaryFBO->GetHeight() + tileSize - 1) / tileSize, 1);
+
+	// Make sure the image writes land before anything else draws into or samples the color target
+	glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+	// The normals target is the same format as the velocity target, so TAA will pick it back up
+	_ReleaseTransient(RenderTargetAttachment::Color4);
+	_ReleaseTransient(RenderTargetAttachment::Color5);
+}
+
+void RenderLayer::_RenderVelocity(const glm::mat4& viewProj, const glm::mat4& unjitteredViewProj) {
+	// Start by marking every pixel as having no velocity, the resolve will work out motion from the
+	// depth buffer for those pixels instead. Most of the scene is static, so this saves us drawing it all again.
+	// A velocity target is a lot cheaper than multisampling every attachment, and it stays attached
+	// until the TAA resolve is done with it
+	_AttachTransient(RenderTargetAttachment::Color3, RenderTargetType::ColorRg16F);
+	Texture2D::Sptr velocity = _primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color3);
+	const float clearValue[4] = { TemporalAntiAliasing::NO_VELOCITY, TemporalAntiAliasing::NO_VELOCITY, 0.0f, 0.0f };
+	glClearTexImage(velocity->GetHandle(), 0, GL_RG, GL_FLOAT, clearValue);
+
+	if (_movingObjects.empty()) {
+		return;
+	}
+
+	// Redraw moving objects on top of themselves, nudged towards the camera so they pass the depth test
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Color3 });
+	glDepthMask(GL_FALSE);
+	glDepthFunc(GL_LEQUAL);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(-1.0f, -1.0f);
+
+	_velocityShader->Bind();
+	for (const auto& [renderable, prevTransform] : _movingObjects) {
+		const glm::mat4& transform = renderable->GetGameObject()->GetTransform();
+		_velocityShader->SetUniformMatrix("u_ClipTransform", viewProj * transform);
+		_velocityShader->SetUniformMatrix("u_CurrentTransform", unjitteredViewProj * transform);
+		_velocityShader->SetUniformMatrix("u_PreviousTransform", _prevViewProj * prevTransform);
+		renderable->GetMesh()->Draw();
+	}
+
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Color0 });
+}
+
+void RenderLayer::_RenderTransparentOit(const glm::mat4& viewProj) {
+	// Weighted blended OIT needs an accumulation and a revealage target. Weights go well past 1,
+	// so these need to be floating point
+	_AttachTransient(RenderTargetAttachment::Color1, RenderTargetType::ColorRgba16F);
+	_AttachTransient(RenderTargetAttachment::Color2, RenderTargetType::ColorRed16F);
+
+	// Only the accumulation and revealage targets get written, output 0 is discarded
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Unknown, RenderTargetAttachment::Color1, RenderTargetAttachment::Color2 });
+
+	// Accumulation starts at 0, revealage starts fully revealed
+	const float accumulationClear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const float revealageClear[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glClearNamedFramebufferfv(_primaryFBO->GetHandle(), GL_COLOR, 1, accumulationClear);
+	glClearNamedFramebufferfv(_primaryFBO->GetHandle(), GL_COLOR, 2, revealageClear);
+
+	// Test against the opaque depth, but don't write, so transparent surfaces never hide each other.
+	// Since blending is commutative, draw order doesn't matter and no sorting is needed
+	glDepthMask(GL_FALSE);
+	glDisable(GL_CULL_FACE);
+	glEnable(GL_BLEND);
+	glBlendFunci(1, GL_ONE, GL_ONE);
+	glBlendFunci(2, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+	Gameplay::Material::Sptr currentMat = nullptr;
+	for (const auto& [depth, renderable] : _transparentObjects) {
+		_DrawRenderable(renderable, viewProj, currentMat);
+	}
+
+	// Resolve the transparent layers over the opaque color
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Color0 });
+	glDisable(GL_DEPTH_TEST);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	_oitCompositeShader->Bind();
+	_primaryFBO->BindAttachment(RenderTargetAttachment::Color1, 0);
+	_primaryFBO->BindAttachment(RenderTargetAttachment::Color2, 1);
+	_fullscreenVao->Bind();
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	VertexArrayObject::Unbind();
+
+	_ReleaseTransient(RenderTargetAttachment::Color1);
+	_ReleaseTransient(RenderTargetAttachment::Color2);
 
-	// Set viewport and resize our primary FBO
-	_primaryFBO->Resize(newSize);
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+	glDepthMask(GL_TRUE);
+}
+
+void RenderLayer::_AttachTransient(RenderTargetAttachment attachment, RenderTargetType format) {
+	_primaryFBO->Attach(attachment, RenderTargetPool::AcquireTexture(_primaryFBO->GetSize(), format));
+}
+
+void RenderLayer::_ReleaseTransient(RenderTargetAttachment attachment) {
+	Texture2D::Sptr target = _primaryFBO->GetTextureAttachment(attachment);
+	if (target != nullptr) {
+		_primaryFBO->Detach(attachment);
+		RenderTargetPool::Release(target);
+	}
+}
+
+void RenderLayer::_ApplyResize() {
+	double start = FramePacer::Now();
+
+	_primaryFBO->Resize(_targetSize);
+	if (_taa != nullptr) {
+		_taa->Resize(_targetSize);
+	}
 
 	// Update the main camera's projection
 	Application& app = Application::Get();
-	app.CurrentScene()->MainCamera->ResizeWindow(newSize.x, newSize.y);
+	app.CurrentScene()->MainCamera->ResizeWindow(_targetSize.x, _targetSize.y);
+
+	// Only measures the time on our end, the driver may defer some of the work
+	_lastResizeMs = (float)((FramePacer::Now() - start) * 1000.0);
+	_resizeCount++;
+}
+
+void RenderLayer::_RenderTransparentSorted(const glm::mat4& viewProj) {
+	// View space looks down -Z, so the furthest objects have the most negative depth
+	std::sort(_transparentObjects.begin(), _transparentObjects.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	glDepthMask(GL_FALSE);
+	glDisable(GL_CULL_FACE);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	Gameplay::Material::Sptr currentMat = nullptr;
+	for (const auto& [depth, renderable] : _transparentObjects) {
+		_DrawRenderable(renderable, viewProj, currentMat);
+	}
+
+	glDisable(GL_BLEND);
+	glEnable(GL_CULL_FACE);
+	glDepthMask(GL_TRUE);
+}
+
+void RenderLayer::OnWindowResize(const glm::ivec2 & oldSize, const glm::ivec2 & newSize)
+{
+	if (newSize.x * newSize.y == 0) return;
+
+	// The targets get resized the next time we render
+	_targetSize = newSize;
 }
 
 void RenderLayer::OnAppLoad(const nlohmann::json & config)
@@ -163,17 +472,104 @@ void RenderLayer::OnAppLoad(const nlohmann::json & config)
 	fboDescriptor.Height = app.GetWindowSize().y;
 	fboDescriptor.GenerateUnsampled = false;
 	fboDescriptor.SampleCount = 1;
+	_targetSize = app.GetWindowSize();
 
 	// Add a depth and color attachment (same as default)
 	fboDescriptor.RenderTargets[RenderTargetAttachment::DepthStencil] = { true, RenderTargetType::DepthStencil };
 	fboDescriptor.RenderTargets[RenderTargetAttachment::Color0] = { true, RenderTargetType::ColorRgb8 };
 
+	bool taaEnabled = true;
+	if (config.contains(Name)) {
+		_oitEnabled = JsonGet(config[Name], "weighted_blended_oit", _oitEnabled);
+		taaEnabled = JsonGet(config[Name], "temporal_aa", taaEnabled);
+		_deferredEnabled = JsonGet(config[Name], "deferred_shading", _deferredEnabled);
+		SamplerCache::SetQuality(JsonGet(config[Name], "max_anisotropy", -1.0f), JsonGet(config[Name], "mip_lod_bias", 0.0f));
+		TextureStreamer::SetBudget(JsonGet(config[Name], "texture_budget_mb", (size_t)512) * 1024 * 1024);
+		TextureStreamer::SetMinResidentSize(JsonGet(config[Name], "texture_stream_min_size", 64u));
+		RenderTargetPool::SetReleaseAfterFrames(JsonGet(config[Name], "transient_release_frames", 60u));
+	}
+
+	// The lighting pass writes the color target as an image, which can't be RGB. The G-buffer,
+	// velocity and OIT targets are only needed for part of the frame, so those passes borrow
+	// them from the RenderTargetPool instead of keeping them on the FBO
+	if (_deferredEnabled) {
+		fboDescriptor.RenderTargets[RenderTargetAttachment::Color0] = { true, RenderTargetType::ColorRgba8 };
+	}
+
 	// Create the primary FBO
 	_primaryFBO = std::make_shared<Framebuffer>(fboDescriptor);
+	// Regular rendering only goes to the main color target, the OIT targets are only drawn to
+	// during the transparent pass
+	_primaryFBO->SetDrawBuffers({ RenderTargetAttachment::Color0 });
+
+	if (_oitEnabled) {
+		_oitCompositeShader = ShaderProgram::Create();
+		_oitCompositeShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_triangle.glsl", ShaderPartType::Vertex);
+		_oitCompositeShader->LoadShaderPartFromFile("shaders/fragment_shaders/oit_composite.glsl", ShaderPartType::Fragment);
+		_oitCompositeShader->Link();
+
+		// The fullscreen triangle generates its vertices from gl_VertexID, but GL still needs a VAO bound
+		_fullscreenVao = VertexArrayObject::Create();
+	}
+
+	if (_deferredEnabled) {
+		_deferredLightingShader = ShaderProgram::Create();
+		_deferredLightingShader->LoadShaderPartFromFile("shaders/compute_shaders/deferred_lighting.glsl", ShaderPartType::Compute);
+		_deferredLightingShader->Link();
+	}
+
+	if (taaEnabled) {
+		_taa = std::make_shared<TemporalAntiAliasing>(app.GetWindowSize());
+		if (config.contains(Name)) {
+			_taa->JitterSamples = JsonGet(config[Name], "taa_jitter_samples", _taa->JitterSamples);
+			_taa->HistoryWeight = JsonGet(config[Name], "taa_history_weight", _taa->HistoryWeight);
+		}
+
+		_velocityShader = ShaderProgram::Create();
+		_velocityShader->LoadShaderPartFromFile("shaders/vertex_shaders/velocity_vs.glsl", ShaderPartType::Vertex);
+		_velocityShader->LoadShaderPartFromFile("shaders/fragment_shaders/velocity_fs.glsl", ShaderPartType::Fragment);
+		_velocityShader->Link();
+	}
 
 	// Create our common uniform buffers
 	_frameUniforms = std::make_shared<UniformBuffer<FrameLevelUniforms>>(BufferUsage::DynamicDraw);
 	_instanceUniforms = std::make_shared<UniformBuffer<InstanceLevelUniforms>>(BufferUsage::DynamicDraw);
+	_objectLightUniforms = std::make_shared<UniformBuffer<ObjectLightUniforms>>(BufferUsage::DynamicDraw);
+}
+
+nlohmann::json RenderLayer::GetDefaultConfig() {
+	return {
+		{ "weighted_blended_oit", true },
+		{ "deferred_shading", true },
+		{ "temporal_aa", true },
+		{ "taa_jitter_samples", 8 },
+		{ "taa_history_weight", 0.9f },
+		{ "max_anisotropy", -1.0f },
+		{ "mip_lod_bias", 0.0f },
+		{ "texture_budget_mb", 512 },
+		{ "texture_stream_min_size", 64 },
+		{ "transient_release_frames", 60 }
+	};
+}
+
+bool RenderLayer::IsOitEnabled() const {
+	return _oitEnabled;
+}
+
+const TemporalAntiAliasing::Sptr& RenderLayer::GetTemporalAntiAliasing() const {
+	return _taa;
+}
+
+bool RenderLayer::IsDeferredEnabled() const {
+	return _deferredEnabled;
+}
+
+float RenderLayer::GetLastResizeTime() const {
+	return _lastResizeMs;
+}
+
+uint32_t RenderLayer::GetResizeCount() const {
+	return _resizeCount;
 }
 
 const Framebuffer::Sptr& RenderLayer::GetPrimaryFBO() const {
@@ -2,6 +2,17 @@
 #include "../ApplicationLayer.h"
 #include "Graphics/Framebuffer.h"
 #include "Graphics/Buffers/UniformBuffer.h"
+#include "Gameplay/LightCuller.h"
+#include "Graphics/ShaderProgram.h"
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/TemporalAntiAliasing.h"
+
+#include <unordered_map>
+
+class RenderComponent;
+namespace Gameplay {
+	class Material;
+}
 
 class RenderLayer final : public ApplicationLayer {
 public:
@@ -23,6 +34,8 @@ public:
 		float u_Time;
 		// The time in seconds since the previous frame
 		float u_DeltaTime;
+		// Non-zero while drawing into the G-buffer
+		int   u_DeferredPass;
 	};
 
 	// Structure for our instance-level uniforms, matches layout from
@@ -37,6 +50,18 @@ public:
 		glm::mat4 u_NormalMatrix;
 	};
 
+	// Structure for the lights affecting a single object, matches layout from
+	// fragments/multiple_point_lights.glsl
+	// For use with a UBO.
+	struct ObjectLightUniforms {
+		// Indices of the lights affecting the object, packed 4 to an ivec4
+		glm::ivec4 LightIndices[Gameplay::LightCuller::MAX_LIGHTS_PER_OBJECT / 4];
+		// The number of valid light indices
+		int        NumLights;
+		// std140 rounds the block size up to a multiple of a vec4
+		int        _padding[3];
+	};
+
 	RenderLayer();
 	virtual ~RenderLayer();
 
@@ -51,9 +76,35 @@ public:
 	const glm::vec4& GetClearColor() const;
 	void SetClearColor(const glm::vec4& value);
 
+	/// <summary>
+	/// Returns true if transparent materials are drawn with weighted blended order-independent
+	/// transparency, false if they are sorted back to front and alpha blended
+	/// </summary>
+	bool IsOitEnabled() const;
+
+	/// <summary>
+	/// Gets the temporal anti-aliasing pass, or nullptr if TAA is disabled
+	/// </summary>
+	const TemporalAntiAliasing::Sptr& GetTemporalAntiAliasing() const;
+
+	/// <summary>
+	/// Returns true if the G-buffer was allocated, so that scenes can use deferred shading
+	/// </summary>
+	bool IsDeferredEnabled() const;
+
+	/// <summary>
+	/// Gets how long it took to resize the render targets the last time the window was resized, in milliseconds
+	/// </summary>
+	float GetLastResizeTime() const;
+	/// <summary>
+	/// Gets the number of times the render targets have been resized
+	/// </summary>
+	uint32_t GetResizeCount() const;
+
 	// Inherited from ApplicationLayer
 
 	virtual void OnAppLoad(const nlohmann::json& config) override;
+	virtual nlohmann::json GetDefaultConfig() override;
 	virtual void OnRender(const Framebuffer::Sptr& prevLayer) override;
 	virtual void OnWindowResize(const glm::ivec2& oldSize, const glm::ivec2& newSize) override;
 	virtual Framebuffer::Sptr GetRenderOutput() override;
@@ -68,4 +119,63 @@ protected:
 
 	const int INSTANCE_UBO_BINDING = 1;
 	UniformBuffer<InstanceLevelUniforms>::Sptr _instanceUniforms;
+
+	const int OBJECT_LIGHT_UBO_BINDING = 3;
+	UniformBuffer<ObjectLightUniforms>::Sptr _objectLightUniforms;
+
+	// Weighted blended OIT accumulates into 2 extra targets on the primary FBO, then
+	// resolves them over the opaque scene with a fullscreen pass
+	bool                    _oitEnabled;
+	ShaderProgram::Sptr     _oitCompositeShader;
+	VertexArrayObject::Sptr _fullscreenVao;
+
+	// Temporal anti-aliasing, jitters the projection and writes velocities for moving objects
+	TemporalAntiAliasing::Sptr _taa;
+	ShaderProgram::Sptr        _velocityShader;
+	// The camera's view projection from last frame, without jitter
+	glm::mat4                  _prevViewProj;
+	// Object transforms from last frame and this frame, used to find moving objects
+	std::unordered_map<const RenderComponent*, glm::mat4> _prevTransforms;
+	std::unordered_map<const RenderComponent*, glm::mat4> _currentTransforms;
+	// Opaque objects that moved since last frame, with their previous transforms
+	std::vector<std::pair<RenderComponent*, glm::mat4>>   _movingObjects;
+
+	// Deferred shading writes albedo and normals into 2 extra targets on the primary FBO, then
+	// lights them with a tiled compute pass. Only used when the current scene asks for it
+	bool                    _deferredEnabled;
+	ShaderProgram::Sptr     _deferredLightingShader;
+
+	// The size the window was last resized to, the targets catch up at the start of the next render
+	glm::ivec2              _targetSize;
+	float                   _lastResizeMs;
+	uint32_t                _resizeCount;
+
+	// Objects collected by the render pass, sorted into the passes that draw them
+	std::vector<RenderComponent*> _deferredObjects;
+	std::vector<RenderComponent*> _forwardObjects;
+	// Transparent objects, with their view space depths
+	std::vector<std::pair<float, RenderComponent*>> _transparentObjects;
+
+	/// <summary>
+	/// Binds the object's material if it's not already bound, uploads its instance and light
+	/// uniforms, then draws it
+	/// </summary>
+	/// <param name="selectLights">False to skip picking lights for the object, for passes that don't do lighting</param>
+	void _DrawRenderable(RenderComponent* renderable, const glm::mat4& viewProj, std::shared_ptr<Gameplay::Material>& currentMat, bool selectLights = true);
+	void _RenderDeferred(const glm::mat4& viewProj);
+	void _RenderVelocity(const glm::mat4& viewProj, const glm::mat4& unjitteredViewProj);
+	void _RenderTransparentOit(const glm::mat4& viewProj);
+	void _RenderTransparentSorted(const glm::mat4& viewProj);
+	/// <summary>
+	/// Borrows a target from the RenderTargetPool and attaches it to the primary FBO for a pass
+	/// </summary>
+	void _AttachTransient(RenderTargetAttachment attachment, RenderTargetType format);
+	/// <summary>
+	/// Detaches a borrowed target from the primary FBO and gives it back to the pool
+	/// </summary>
+	void _ReleaseTransient(RenderTargetAttachment attachment);
+	/// <summary>
+	/// Resizes the primary FBO, TAA history and camera to the last size the window was resized to
+	/// </summary>
+	void _ApplyResize();
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 
 /**
  * The timing class is a very simple singleton class that will store our timing values 
@@ -11,10 +12,13 @@ public:
 
 	inline float DeltaTime() { return _deltaTime; }
 	inline float UnscaledDeltaTime() { return _unscaledDeltaTime; }
+	// The measured frame time, before any smoothing or clamping is applied
+	inline float RawDeltaTime() { return _rawDeltaTime; }
 	inline float TimeSinceSceneLoad() { return _timeSinceSceneLoad; }
 	inline float UnscaledTimeSinceSceneLoad() { return _unscaledTimeSinceSceneLoad; }
 	inline float TimeSinceAppLoad() { return _timeSinceSceneLoad; }
 	inline float UnscaledTimeSinceAppLoad() { return _unscaledTimeSinceSceneLoad; }
+	inline uint64_t FrameCount() { return _frameCount; }
 
 	static inline Timing& Current() { return _singleton; }
 
@@ -28,10 +32,12 @@ protected:
 
 	float _deltaTime = 0;
 	float _unscaledDeltaTime = 0;
+	float _rawDeltaTime = 0;
 	float _timeSinceSceneLoad = 0;
 	float _unscaledTimeSinceSceneLoad = 0;
 	float _timeSinceAppLoad = 0;
 	float _unscaledTimeSinceAppLoad = 0;
+	uint64_t _frameCount = 0;
 
 	static inline float _timeScale = 1.0f;
 };
@@ -0,0 +1,70 @@
+#include "FrameTimingWindow.h"
+#include "../Application.h"
+#include "../Layers/RenderLayer.h"
+#include "Graphics/Buffers/UniformBuffer.h"
+#include "Graphics/GpuReadback.h"
+#include "Graphics/RenderTargetPool.h"
+#include "Graphics/SamplerCache.h"
+#include "Graphics/TextureStreamer.h"
+#include "Gameplay/Physics/PhysicsProfiler.h"
+
+FrameTimingWindow::FrameTimingWindow() :
+	IEditorWindow(),
+	_lastUboBytes(0)
+{
+	Name = "Frame Timing";
+	ParentName = "Inspector";
+	SplitDirection = ImGuiDir_::ImGuiDir_Down;
+	SplitDepth = 0.3f;
+}
+
+FrameTimingWindow::~FrameTimingWindow() = default;
+
+void FrameTimingWindow::Render()
+{
+	Application::Get().GetFramePacer().RenderImGui();
+
+	uint64_t uboBytes = AbstractUniformBuffer::GetTotalBytesUploaded();
+	ImGui::Text("UBO uploads: %.2f KB/frame", (uboBytes - _lastUboBytes) / 1024.0f);
+	_lastUboBytes = uboBytes;
+
+	if (ImGui::CollapsingHeader("Texture Sampling")) {
+		SamplerCache::RenderImGui();
+	}
+
+	if (ImGui::CollapsingHeader("Texture Streaming")) {
+		TextureStreamer::RenderImGui();
+	}
+
+	if (ImGui::CollapsingHeader("Render Targets")) {
+		RenderTargetPool::RenderImGui();
+		RenderLayer::Sptr renderLayer = Application::Get().GetLayer<RenderLayer>();
+		if (renderLayer != nullptr) {
+			ImGui::Text("Last resize: %.2f ms (%u resizes)", renderLayer->GetLastResizeTime(), renderLayer->GetResizeCount());
+		}
+	}
+
+	if (ImGui::CollapsingHeader("GPU Readback")) {
+		const GpuReadback::Stats& stats = GpuReadback::GetStats();
+		ImGui::Text("Pending: %u", (uint32_t)stats.Pending);
+		ImGui::Text("Latency: %.1f frames", stats.AverageLatencyFrames);
+		ImGui::Text("Delivered: %llu (%.2f KB)", stats.Completed, stats.BytesRead / 1024.0f);
+		// Blocking reads stall the whole pipeline, they should never show up during regular frames
+		if (stats.BlockingReadsLastFrame > 0) {
+			ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Blocking reads last frame: %u", stats.BlockingReadsLastFrame);
+		}
+		ImGui::Text("Blocking reads: %llu", stats.BlockingReads);
+	}
+
+	Gameplay::Scene::Sptr scene = Application::Get().CurrentScene();
+	if (scene != nullptr && ImGui::CollapsingHeader("Light Culling")) {
+		ImGui::Checkbox("Deferred Shading", &scene->UseDeferredShading);
+		scene->GetLightCuller().RenderImGui();
+	}
+	if (ImGui::CollapsingHeader("Physics Profiling")) {
+		Gameplay::Physics::PhysicsProfiler::RenderImGui();
+	}
+	if (scene != nullptr && ImGui::CollapsingHeader("Physics Queries")) {
+		scene->GetPhysicsQueries().RenderImGui();
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "../IEditorWindow.h"
+#include <cstdint>
+
+/**
+ * Handles an editor window for showing frame time stats and frame pacing settings
+ */
+class FrameTimingWindow : public IEditorWindow {
+public:
+	MAKE_PTRS(FrameTimingWindow)
+
+		FrameTimingWindow();
+	virtual ~FrameTimingWindow();
+
+	// Inherited from IEditorWindow
+
+	virtual void Render() override;
+
+protected:
+	// Total uniform buffer upload volume as of the last render, used to work out per-frame uploads
+	uint64_t _lastUboBytes;
+};
@@ -25,6 +25,7 @@ void InspectorWindow::Render()
 	Gameplay::GameObject::Sptr selection = app.EditorState.SelectedObject.lock();
 	if (selection != nullptr) {
 		ImGui::PushID(selection.get());
+		bool wasEdited = ImGuiHelper::IsAnyItemEditedThisFrame();
 
 		// Draw a textbox for the object name
 		static char nameBuff[256];
@@ -77,6 +78,7 @@ void InspectorWindow::Render()
 
 			if (_RenderComponent(component)) {
 				selection->_components.erase(selection->_components.begin() + ix);
+				selection->MarkDirty();
 				ix--;
 			}
 		}
@@ -107,6 +109,11 @@ void InspectorWindow::Render()
 			preview = "";
 		}
 
+		// If any of the object's fields were changed, it will need to be saved again
+		if (!wasEdited && ImGuiHelper::IsAnyItemEditedThisFrame()) {
+			selection->MarkDirty();
+		}
+
 		ImGui::PopID();
 	}
 }
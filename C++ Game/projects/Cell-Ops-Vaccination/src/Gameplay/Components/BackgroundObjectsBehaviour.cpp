@@ -21,8 +21,14 @@ BackgroundObjectsBehaviour::~BackgroundObjectsBehaviour() = default;
 
 BackgroundObjectsBehaviour::BackgroundObjectsBehaviour() :
     IComponent(),
-    BezierMode(false)
-{}
+    BezierMode(false),
+    UpdateLod()
+{
+    // Background objects are purely cosmetic, so stop moving them when they can't be seen
+    UpdateLod.PauseBeyondRange = true;
+    UpdateLod.HiddenInterval = 0;
+    UpdateLod.BoundingRadius = 2.0f;
+}
 
 void BackgroundObjectsBehaviour::Awake()
 {
@@ -35,7 +41,10 @@ void BackgroundObjectsBehaviour::Awake()
 
 void BackgroundObjectsBehaviour::Update(float deltaTime)
 {
-    SegmentTimer += deltaTime;
+    float dt;
+    if (!UpdateLod.ShouldTick(GetGameObject(), deltaTime, dt)) return;
+
+    SegmentTimer += dt;
     if (SegmentTimer >= SegmentTimerMax) {
         SegmentTimer = 0;
     }
@@ -49,7 +58,17 @@ void BackgroundObjectsBehaviour::Update(float deltaTime)
 }
 
 void BackgroundObjectsBehaviour::RenderImGui() {
-   
+    UpdateLod.RenderImGui();
+}
+
+std::any BackgroundObjectsBehaviour::CaptureState() const
+{
+    return _PackState(RoutePoint1, RoutePoint2, RoutePoint3, RoutePoint4, SegmentTimer);
+}
+
+void BackgroundObjectsBehaviour::RestoreState(const std::any& state)
+{
+    _UnpackState(state, RoutePoint1, RoutePoint2, RoutePoint3, RoutePoint4, SegmentTimer);
 }
 /// <summary>
 /// Sets Random points for Routes
@@ -57,18 +76,23 @@ void BackgroundObjectsBehaviour::RenderImGui() {
 /// <returns>xyz points in floats</returns>
 glm::vec3 BackgroundObjectsBehaviour::GetPosition()
 {
-    float x = (float)(rand() % 100 + (-50));
-    float y = (float)(rand() % 100 + (-50));
-    float z = (float)(rand() % 100 + (-50));
+    RandomStream& random = GetGameObject()->GetScene()->Random.GetStream("background_routes");
+    float x = (float)random.Range(-50, 50);
+    float y = (float)random.Range(-50, 50);
+    float z = (float)random.Range(-50, 50);
     return glm::vec3(x,y,z);
 }
 nlohmann::json BackgroundObjectsBehaviour::ToJson() const {
     return {
-        {"BezierMode",BezierMode}
+        {"BezierMode",BezierMode},
+        {"update_lod",UpdateLod.ToJson()}
     };
 }
 BackgroundObjectsBehaviour::Sptr BackgroundObjectsBehaviour::FromJson(const nlohmann::json& blob) {
     BackgroundObjectsBehaviour::Sptr result = std::make_shared<BackgroundObjectsBehaviour>();
     result->BezierMode = blob["BezierMode"];
+    if (blob.contains("update_lod")) {
+        result->UpdateLod.LoadFromJson(blob["update_lod"]);
+    }
     return result;
 }
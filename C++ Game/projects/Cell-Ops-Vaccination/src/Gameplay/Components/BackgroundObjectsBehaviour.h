@@ -3,6 +3,7 @@
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 #include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/UpdateRateLod.h"
 class BackgroundObjectsBehaviour :public Gameplay::IComponent
 {
 public:
@@ -17,6 +18,8 @@ public:
 	virtual nlohmann::json ToJson() const override;
 	static BackgroundObjectsBehaviour::Sptr FromJson(const nlohmann::json& blob);
 	virtual void RenderImGui() override;
+	virtual std::any CaptureState() const override;
+	virtual void RestoreState(const std::any& state) override;
 	glm::vec3 GetPosition();
 
 
@@ -29,4 +32,7 @@ public:
 	float SegmentTimerMax = 10.0f;
 
 	bool BezierMode;
+
+	// Controls how often we tick based on distance to the camera and visibility
+	Gameplay::UpdateRateLod UpdateLod;
 };
\ No newline at end of file
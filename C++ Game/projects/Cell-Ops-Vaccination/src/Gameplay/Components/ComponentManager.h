@@ -3,6 +3,7 @@
 #include "IComponent.h"
 #include <typeindex>
 #include <optional>
+#include <algorithm>
 
 namespace Gameplay {
 	/// <summary>
@@ -206,6 +207,40 @@ namespace Gameplay {
 			}
 		}
 
+		/// <summary>
+		/// Invokes a callback on all enabled components whose type takes part in the given phase. Only types
+		/// that override the phase method are visited, so components with an empty Update are never touched
+		/// </summary>
+		/// <typeparam name="Func">The type of callback, should accept a const IComponent::Sptr&</typeparam>
+		/// <param name="phase">The single phase to iterate over</param>
+		/// <param name="callback">The callback to invoke with the components</param>
+		template <typename Func>
+		static void EachInPhase(ComponentPhases phase, Func&& callback) {
+			for (const std::type_index& type : _PhaseTypes[phase]) {
+				std::vector<std::weak_ptr<IComponent>>& componentStore = _Components[type];
+				_CompactStore(type, componentStore);
+
+				// Components created during the callbacks will be picked up next time, we index
+				// instead of using iterators since the store may grow while we're iterating
+				const size_t count = componentStore.size();
+				for (size_t ix = 0; ix < count; ix++) {
+					IComponent::Sptr sptr = componentStore[ix].lock();
+					if (sptr && sptr->IsEnabled) {
+						callback(sptr);
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Gets the phases that a registered component type takes part in
+		/// </summary>
+		/// <param name="type">The type of component to check</param>
+		static ComponentPhases GetPhases(const std::type_index& type) {
+			auto it = _TypePhases.find(type);
+			return it == _TypePhases.end() ? ComponentPhases::None : it->second;
+		}
+
 		/// <summary>
 		/// Attempts to register a given type as a component, should be called for each component type 
 		/// at the start of you application
@@ -226,6 +261,15 @@ namespace Gameplay {
 				_TypeLoadRegistry[type] = &ComponentManager::ParseTypeFromBlob<T>;
 				_TypeCreateRegistry[type] = &ComponentManager::Create<T>;
 				_TypeNameMap[StringTools::SanitizeClassName(typeid(T).name())] = type;
+
+				// Detect which per-frame functions the type overrides, so we only dispatch to those
+				ComponentPhases phases = (ComponentPhases)get_component_phases<T>();
+				_TypePhases[type] = phases;
+				for (ComponentPhases phase : { ComponentPhases::Update, ComponentPhases::LateUpdate, ComponentPhases::FixedUpdate }) {
+					if (*(phases & phase)) {
+						_PhaseTypes[phase].push_back(type);
+					}
+				}
 			}
 		}
 
@@ -246,6 +290,25 @@ namespace Gameplay {
 		// actually increasing the reference count. Thus components will be destroyed at the correct
 		// time (when the only reference is the one stored here).
 		inline static std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>> _Components;  
+		// Tracks how many components of each type have been destroyed since the type's store was last compacted
+		inline static std::unordered_map<std::type_index, size_t> _ExpiredCounts;
+
+		// Stores the phases that each component type overrides, and the inverse mapping of phase to types
+		inline static std::unordered_map<std::type_index, ComponentPhases> _TypePhases;
+		inline static std::unordered_map<ComponentPhases, std::vector<std::type_index>> _PhaseTypes;
+
+		/// <summary>
+		/// Removes any expired components from a type's store, if any have been destroyed since the last call
+		/// </summary>
+		static void _CompactStore(const std::type_index& type, std::vector<std::weak_ptr<IComponent>>& componentStore) {
+			size_t& expired = _ExpiredCounts[type];
+			if (expired > 0) {
+				componentStore.erase(std::remove_if(componentStore.begin(), componentStore.end(), [](const std::weak_ptr<IComponent>& ptr) {
+					return ptr.expired();
+				}), componentStore.end());
+				expired = 0;
+			}
+		}
 
 		template <typename T>
 		static IComponent::Sptr ParseTypeFromBlob(const nlohmann::json& blob) {
@@ -262,13 +325,9 @@ namespace Gameplay {
 			// Make sure the component's type was one that was registered
 			LOG_ASSERT(_TypeLoadRegistry[component->_realType] != nullptr, "You must register component types before creating them!");
 
-			// Get a reference to the vector of components for easy access
-			std::vector<std::weak_ptr<IComponent>>& componentStore = _Components[component->_realType];
-
-			// Clear any dead weak pointers
-			std::remove_if(componentStore.begin(), componentStore.end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-			});
+			// The store may be in the middle of being iterated, so we just flag it and let
+			// the next EachInPhase clear out the dead weak pointers
+			_ExpiredCounts[component->_realType]++;
 		}
 	};
 }
\ No newline at end of file
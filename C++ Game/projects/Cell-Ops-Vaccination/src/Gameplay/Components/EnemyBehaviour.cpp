@@ -1,6 +1,7 @@
 #include "EnemyBehaviour.h"
 #include <GLFW/glfw3.h>
 #include "Utils/ImGuiHelper.h"
+#include "Gameplay/Components/FlowFieldNavigation.h"
 
 // Templated LERP function
 template<typename T>
@@ -19,6 +20,7 @@ void EnemyBehaviour::RenderImGui() {
 	LABEL_LEFT(ImGui::DragFloat, "Health", &Health, 1.0f);
 	ImGui::Text, "Target", Target->Name.c_str();
 	ImGui::Text, "Enemy Type", EnemyType.c_str();
+	UpdateLod.RenderImGui();
 }
 
 nlohmann::json EnemyBehaviour::ToJson() const {
@@ -36,8 +38,16 @@ EnemyBehaviour::EnemyBehaviour() :
 	Health(0.0f),
 	EnemyType(""),
 	Target(nullptr),
-	RespawnPosition(glm::vec3(0.0f,0.0f,0.0f))
-{}
+	RespawnPosition(glm::vec3(0.0f,0.0f,0.0f)),
+	UpdateLod()
+{
+	// Enemies still need to reach their targets when off screen, so never fully pause them
+	UpdateLod.FullRateDistance = 30.0f;
+	UpdateLod.HalfRateDistance = 60.0f;
+	UpdateLod.QuarterRateDistance = 100.0f;
+	UpdateLod.EighthRateDistance = 150.0f;
+	UpdateLod.HiddenInterval = 4;
+}
 
 EnemyBehaviour::~EnemyBehaviour() = default;
 
@@ -53,7 +63,13 @@ EnemyBehaviour::Sptr EnemyBehaviour::FromJson(const nlohmann::json & blob) {
 
 void EnemyBehaviour::Update(float deltaTime)
 {
-	lerpTimer += deltaTime * Speed;
+	float dt;
+	if (!UpdateLod.ShouldTick(GetGameObject(), deltaTime, dt)) return;
+
+	// Prefer following the flow field so we path around obstacles
+	if (_FollowFlowField(dt)) return;
+
+	lerpTimer += dt * Speed;
 	if (lerpTimer >= lerpTimerMax) {
 		lerpTimer = 0;
 	}
@@ -63,6 +79,37 @@ void EnemyBehaviour::Update(float deltaTime)
 	GetGameObject()->LookAt(Target.get()->GetPosition());
 }
 
+bool EnemyBehaviour::_FollowFlowField(float dt)
+{
+	Gameplay::Scene* scene = GetGameObject()->GetScene();
+	if (Target == nullptr || scene->NavigationObject == nullptr) return false;
+
+	FlowFieldNavigation::Sptr navigation = scene->NavigationObject->Get<FlowFieldNavigation>();
+	if (navigation == nullptr || !navigation->IsEnabled) return false;
+
+	Gameplay::Navigation::FlowField::Sptr field = navigation->GetField(Target->GetGUID());
+	if (field == nullptr) return false;
+
+	// Reaching the target loops back around to the respawn point, same as the lerp does
+	glm::vec3 position = GetGameObject()->GetPosition();
+	if (field->IsAtGoal(position)) {
+		lerpTimer = 0;
+		GetGameObject()->SetPostion(RespawnPosition);
+		return true;
+	}
+
+	// A zero direction means the target can't be reached from here
+	glm::vec3 direction = field->Sample(position);
+	if (direction == glm::vec3(0.0f)) return false;
+
+	// Match the lerp's pace, which covers the respawn to target distance in lerpTimerMax / Speed seconds
+	float travelSpeed = Speed * glm::max(glm::distance(RespawnPosition, Target->GetPosition()), 1.0f) / lerpTimerMax;
+	position += direction * travelSpeed * dt;
+	GetGameObject()->SetPostion(position);
+	GetGameObject()->LookAt(position + direction);
+	return true;
+}
+
 // After destroying target look for new one
 void EnemyBehaviour::NewTarget()
 {
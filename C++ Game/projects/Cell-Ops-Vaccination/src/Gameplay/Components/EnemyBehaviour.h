@@ -4,6 +4,7 @@
 #include "Gameplay/Scene.h"
 #include "Gameplay/Physics/TriggerVolume.h"
 #include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/UpdateRateLod.h"
 #include "Gameplay/Physics/TriggerVolume.h"
 
 class EnemyBehaviour :public Gameplay::IComponent
@@ -38,6 +39,9 @@ public:
 	float lerpTimer = 0;
 	float lerpTimerMax = 10.0f;
 
+	// Controls how often we tick based on distance to the camera and visibility
+	Gameplay::UpdateRateLod UpdateLod;
+
 	/// <summary>
 	/// Finds new target for enemy
 	/// kind of rubber banding methods as this is called from scene to enemy 
@@ -47,4 +51,10 @@ public:
 
 protected:
 	float _dmg;
+
+	/// <summary>
+	/// Steers the enemy along the flow field for its target, if one has been built
+	/// </summary>
+	/// <returns>False if there is no usable field, and the enemy should lerp instead</returns>
+	bool _FollowFlowField(float dt);
 };
\ No newline at end of file
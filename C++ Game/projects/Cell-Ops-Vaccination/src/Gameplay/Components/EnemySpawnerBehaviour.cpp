@@ -45,6 +45,18 @@ nlohmann::json EnemySpawnerBehaviour::ToJson() const
 
 }
 
+std::any EnemySpawnerBehaviour::CaptureState() const
+{
+	return _PackState(_largeAmount, _normalAmount, _fastAmount, _totalAmount, _spawned,
+		_largeEnemySpeed, _normalEnemySpeed, _fastEnemySpeed, _counter, _isSpawning);
+}
+
+void EnemySpawnerBehaviour::RestoreState(const std::any& state)
+{
+	_UnpackState(state, _largeAmount, _normalAmount, _fastAmount, _totalAmount, _spawned,
+		_largeEnemySpeed, _normalEnemySpeed, _fastEnemySpeed, _counter, _isSpawning);
+}
+
 EnemySpawnerBehaviour::Sptr EnemySpawnerBehaviour::FromJson(const nlohmann::json& blob)
 {
 	EnemySpawnerBehaviour::Sptr result = std::make_shared<EnemySpawnerBehaviour>();
@@ -198,7 +210,7 @@ void EnemySpawnerBehaviour::_spawning()
 {
 	if (_totalAmount > _spawned)
 	{
-		int a = rand()%3;
+		int a = GetGameObject()->GetScene()->Random.GetStream("enemy_spawns").Range(0, 3);
 		switch (a) {
 		case 0:
 			if (_fastAmount > 0) {
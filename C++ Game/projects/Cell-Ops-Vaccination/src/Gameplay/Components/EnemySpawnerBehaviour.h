@@ -26,6 +26,8 @@ public:
 	virtual nlohmann::json ToJson() const override;
 	static EnemySpawnerBehaviour::Sptr FromJson(const nlohmann::json& blob);
 	virtual void RenderImGui() override;
+	virtual std::any CaptureState() const override;
+	virtual void RestoreState(const std::any& state) override;
 
 	//Materials
 	Gameplay::Material::Sptr LargeEnemyMaterial;
@@ -0,0 +1,262 @@
+#include "Gameplay/Components/FlowFieldNavigation.h"
+
+#include <unordered_map>
+#include <algorithm>
+
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Scene.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
+#include "Utils/ImGuiHelper.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/GlmBulletConversions.h"
+
+using namespace Gameplay::Navigation;
+
+FlowFieldNavigation::FlowFieldNavigation() :
+	IComponent(),
+	Grid(),
+	RefreshInterval(30),
+	_fields(),
+	_framesUntilRefresh(0),
+	_lastBuildTimeMs(0.0f),
+	_totalBuilds(0),
+	_worker(),
+	_mutex(),
+	_jobReady(),
+	_jobs(),
+	_results(),
+	_isStopping(false)
+{ }
+
+FlowFieldNavigation::~FlowFieldNavigation() {
+	if (_worker.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isStopping = true;
+		}
+		_jobReady.notify_all();
+		_worker.join();
+	}
+}
+
+void FlowFieldNavigation::Update(float deltaTime) {
+	_CollectResults();
+
+	if (--_framesUntilRefresh <= 0) {
+		_framesUntilRefresh = glm::max(RefreshInterval, 1);
+		_RefreshFields();
+	}
+}
+
+FlowField::Sptr FlowFieldNavigation::GetField(const Guid& target) const {
+	for (const FieldEntry& entry : _fields) {
+		if (entry.Target == target) {
+			return entry.Field;
+		}
+	}
+	return nullptr;
+}
+
+void FlowFieldNavigation::Invalidate() {
+	for (FieldEntry& entry : _fields) {
+		// An empty grid never matches, so the next refresh will queue a build
+		entry.Inputs.Grid.Size = glm::ivec3(0);
+	}
+	_framesUntilRefresh = 0;
+}
+
+void FlowFieldNavigation::_RefreshFields() {
+	Gameplay::Scene* scene = GetGameObject()->GetScene();
+	btDynamicsWorld* world = scene->GetPhysicsWorld();
+
+	// Don't let a bad grid from the editor take the worker down
+	Grid.CellSize = glm::max(Grid.CellSize, 0.1f);
+	Grid.Size = glm::max(Grid.Size, glm::ivec3(1));
+
+	// Gather the world space bounds of every static body and trigger volume, keyed by the object
+	// that owns it. Broadphase AABBs are already maintained by bullet, so this is just a copy
+	std::unordered_map<const Gameplay::GameObject*, NavBox> triggerBounds;
+	std::vector<NavBox> staticBounds;
+	const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	for (int ix = 0; ix < objects.size(); ix++) {
+		const btCollisionObject* obj = objects[ix];
+		if (obj->getBroadphaseHandle() == nullptr || obj->getUserPointer() == nullptr) continue;
+
+		IComponent::Sptr component = reinterpret_cast<std::weak_ptr<IComponent>*>(obj->getUserPointer())->lock();
+		if (component == nullptr || !component->IsEnabled) continue;
+
+		const btBroadphaseProxy* proxy = obj->getBroadphaseHandle();
+		NavBox bounds{ ToGlm(proxy->m_aabbMin), ToGlm(proxy->m_aabbMax) };
+
+		// Enemies are dynamic (with 0 mass), so we can't rely on bullet's static flag here
+		Gameplay::Physics::RigidBody::Sptr body = std::dynamic_pointer_cast<Gameplay::Physics::RigidBody>(component);
+		if (body != nullptr && body->GetType() == RigidBodyType::Static) {
+			staticBounds.push_back(bounds);
+		}
+		else if (std::dynamic_pointer_cast<Gameplay::Physics::TriggerVolume>(component) != nullptr) {
+			triggerBounds[component->GetGameObject()] = bounds;
+		}
+	}
+
+	// Work out the goal bounds for each target, falling back to a single cell if the target has
+	// no trigger volume yet
+	std::vector<NavBox> targetBounds;
+	targetBounds.reserve(scene->Targets.size());
+	for (const auto& target : scene->Targets) {
+		auto it = triggerBounds.find(target.get());
+		if (it != triggerBounds.end()) {
+			targetBounds.push_back(it->second);
+		} else {
+			glm::vec3 halfCell = glm::vec3(Grid.CellSize * 0.5f);
+			targetBounds.push_back(NavBox{ target->GetPosition() - halfCell, target->GetPosition() + halfCell });
+		}
+	}
+
+	// Drop the fields for any targets that no longer exist
+	_fields.erase(std::remove_if(_fields.begin(), _fields.end(), [&](const FieldEntry& entry) {
+		return std::find_if(scene->Targets.begin(), scene->Targets.end(), [&](const Gameplay::GameObject::Sptr& target) {
+			return target->GetGUID() == entry.Target;
+		}) == scene->Targets.end();
+	}), _fields.end());
+
+	// Queue builds for any target whose inputs have changed since its field was last built
+	std::vector<BuildJob> jobs;
+	for (size_t ix = 0; ix < scene->Targets.size(); ix++) {
+		BuildInputs inputs;
+		inputs.Grid = Grid;
+		inputs.Goal = targetBounds[ix];
+		inputs.Obstacles = staticBounds;
+		for (size_t jx = 0; jx < targetBounds.size(); jx++) {
+			if (jx != ix) {
+				inputs.Obstacles.push_back(targetBounds[jx]);
+			}
+		}
+
+		Guid guid = scene->Targets[ix]->GetGUID();
+		auto it = std::find_if(_fields.begin(), _fields.end(), [&](const FieldEntry& entry) { return entry.Target == guid; });
+		if (it == _fields.end()) {
+			_fields.push_back(FieldEntry{ guid, inputs, nullptr, true });
+		} else if (!_InputsMatch(it->Inputs, inputs)) {
+			it->Inputs = inputs;
+			it->IsPending = true;
+		} else {
+			continue;
+		}
+		jobs.push_back(BuildJob{ guid, std::move(inputs) });
+	}
+
+	if (jobs.empty()) {
+		return;
+	}
+
+	// Hand the jobs over to the worker, replacing any stale job for the same target
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (BuildJob& job : jobs) {
+			auto it = std::find_if(_jobs.begin(), _jobs.end(), [&](const BuildJob& queued) { return queued.Target == job.Target; });
+			if (it != _jobs.end()) {
+				*it = std::move(job);
+			} else {
+				_jobs.push_back(std::move(job));
+			}
+		}
+	}
+	if (!_worker.joinable()) {
+		_worker = std::thread(&FlowFieldNavigation::_WorkerMain, this);
+	}
+	_jobReady.notify_one();
+}
+
+void FlowFieldNavigation::_CollectResults() {
+	std::vector<BuildResult> results;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_results.empty()) return;
+		results.swap(_results);
+	}
+
+	for (BuildResult& result : results) {
+		auto it = std::find_if(_fields.begin(), _fields.end(), [&](const FieldEntry& entry) { return entry.Target == result.Target; });
+		if (it != _fields.end()) {
+			it->Field = result.Field;
+			it->IsPending = false;
+		}
+		_lastBuildTimeMs = result.Field->GetBuildTimeMs();
+		_totalBuilds++;
+	}
+}
+
+void FlowFieldNavigation::_WorkerMain() {
+	while (true) {
+		BuildJob job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobReady.wait(lock, [this]() { return _isStopping || !_jobs.empty(); });
+			if (_isStopping) return;
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		FlowField::Sptr field = FlowField::Build(job.Inputs.Grid, job.Inputs.Goal, job.Inputs.Obstacles);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_results.push_back(BuildResult{ job.Target, field });
+	}
+}
+
+bool FlowFieldNavigation::_InputsMatch(const BuildInputs& a, const BuildInputs& b) const {
+	if (!(a.Grid == b.Grid) || a.Obstacles.size() != b.Obstacles.size()) {
+		return false;
+	}
+
+	// Boxes only matter at cell resolution, so small movements don't trigger a rebuild
+	auto sameCells = [&](const NavBox& x, const NavBox& y) {
+		return a.Grid.CellAt(x.Min) == a.Grid.CellAt(y.Min) && a.Grid.CellAt(x.Max) == a.Grid.CellAt(y.Max);
+	};
+	if (!sameCells(a.Goal, b.Goal)) {
+		return false;
+	}
+	for (size_t ix = 0; ix < a.Obstacles.size(); ix++) {
+		if (!sameCells(a.Obstacles[ix], b.Obstacles[ix])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void FlowFieldNavigation::RenderImGui() {
+	LABEL_LEFT(ImGui::DragFloat3, "Origin   ", &Grid.Origin.x, 0.5f);
+	LABEL_LEFT(ImGui::DragFloat, "Cell Size", &Grid.CellSize, 0.1f, 0.5f, 50.0f);
+	LABEL_LEFT(ImGui::DragInt3, "Size     ", &Grid.Size.x, 1.0f, 1, 256);
+	LABEL_LEFT(ImGui::DragInt, "Refresh  ", &RefreshInterval, 1.0f, 1, 600);
+
+	int pending = 0;
+	for (const FieldEntry& entry : _fields) {
+		pending += entry.IsPending ? 1 : 0;
+	}
+	ImGui::Text("Fields: %d (%d pending)", (int)_fields.size(), pending);
+	ImGui::Text("Last build: %.2f ms", _lastBuildTimeMs);
+	ImGui::Text("Total builds: %d", _totalBuilds);
+	if (ImGui::Button("Rebuild")) {
+		Invalidate();
+	}
+}
+
+nlohmann::json FlowFieldNavigation::ToJson() const {
+	return {
+		{ "origin", Grid.Origin },
+		{ "cell_size", Grid.CellSize },
+		{ "size", Grid.Size },
+		{ "refresh_interval", RefreshInterval }
+	};
+}
+
+FlowFieldNavigation::Sptr FlowFieldNavigation::FromJson(const nlohmann::json& blob) {
+	FlowFieldNavigation::Sptr result = std::make_shared<FlowFieldNavigation>();
+	result->Grid.Origin = JsonGet(blob, "origin", result->Grid.Origin);
+	result->Grid.CellSize = JsonGet(blob, "cell_size", result->Grid.CellSize);
+	result->Grid.Size = JsonGet(blob, "size", result->Grid.Size);
+	result->RefreshInterval = JsonGet(blob, "refresh_interval", result->RefreshInterval);
+	return result;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include "IComponent.h"
+#include "Gameplay/Navigation/FlowField.h"
+#include "Utils/GUID.hpp"
+
+/// <summary>
+/// Owns the flow fields that enemies use to steer towards their targets. One field is
+/// kept per target, built from the physics world's static bodies and the other targets'
+/// volumes. Fields are only rebuilt when their inputs change, and building happens on a
+/// worker thread so that the main thread only ever swaps in finished fields
+/// </summary>
+class FlowFieldNavigation : public Gameplay::IComponent {
+public:
+	typedef std::shared_ptr<FlowFieldNavigation> Sptr;
+
+	FlowFieldNavigation();
+	virtual ~FlowFieldNavigation();
+
+	// The grid that all fields are built over
+	Gameplay::Navigation::NavGrid Grid;
+	// How many frames to wait between checking the world for changes
+	int RefreshInterval;
+
+	virtual void Update(float deltaTime) override;
+	virtual void RenderImGui() override;
+
+	/// <summary>
+	/// Gets the flow field leading to the given target, or nullptr if one has not been
+	/// built yet. The result is immutable and may be held on to between frames
+	/// </summary>
+	/// <param name="target">The GUID of the target object</param>
+	Gameplay::Navigation::FlowField::Sptr GetField(const Guid& target) const;
+
+	/// <summary>
+	/// Marks all fields as dirty, so they will be rebuilt on the next refresh
+	/// </summary>
+	void Invalidate();
+
+	MAKE_TYPENAME(FlowFieldNavigation);
+	virtual nlohmann::json ToJson() const override;
+	static FlowFieldNavigation::Sptr FromJson(const nlohmann::json& blob);
+
+private:
+	// The inputs that a field was (or is being) built from
+	struct BuildInputs {
+		Gameplay::Navigation::NavGrid             Grid;
+		Gameplay::Navigation::NavBox              Goal;
+		std::vector<Gameplay::Navigation::NavBox> Obstacles;
+	};
+
+	struct FieldEntry {
+		Guid                                  Target;
+		BuildInputs                           Inputs;
+		Gameplay::Navigation::FlowField::Sptr Field;
+		bool                                  IsPending;
+	};
+
+	struct BuildJob {
+		Guid        Target;
+		BuildInputs Inputs;
+	};
+
+	struct BuildResult {
+		Guid                                  Target;
+		Gameplay::Navigation::FlowField::Sptr Field;
+	};
+
+	// Only touched from the main thread
+	std::vector<FieldEntry> _fields;
+	int                     _framesUntilRefresh;
+	float                   _lastBuildTimeMs;
+	int                     _totalBuilds;
+
+	// Shared with the worker thread, guarded by _mutex
+	std::thread             _worker;
+	std::mutex              _mutex;
+	std::condition_variable _jobReady;
+	std::deque<BuildJob>    _jobs;
+	std::vector<BuildResult> _results;
+	bool                    _isStopping;
+
+	void _WorkerMain();
+	void _RefreshFields();
+	void _CollectResults();
+	bool _InputsMatch(const BuildInputs& a, const BuildInputs& b) const;
+};
@@ -1,5 +1,8 @@
 #pragma once
 #include <memory>
+#include <any>
+#include <tuple>
+#include <EnumToString.h>
 #include "json.hpp"
 #include <imgui.h>
 #include "Utils/StringUtils.h"
@@ -7,6 +10,20 @@
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/TypeHelpers.h"
 
+/// <summary>
+/// Flags for the per-frame phases that a component type takes part in. These are
+/// detected when the type is registered, so the scene only ever dispatches to
+/// components that actually do something in that phase
+/// </summary>
+ENUM_FLAGS(ComponentPhases, uint8_t,
+	None        = 0,
+	Update      = 1 << 0,
+	LateUpdate  = 1 << 1,
+	FixedUpdate = 1 << 2,
+
+	All = 0xFF
+)
+
 namespace Gameplay {
 	// We pre-declare GameObject to avoid circular dependencies in the headers
 	class GameObject;
@@ -97,6 +114,16 @@ namespace Gameplay {
 		/// <param name="context">The game object that the component belongs to</param>
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		virtual void Update(float deltaTime) {};
+		/// <summary>
+		/// Invoked during the update loop, after all components have had Update called
+		/// </summary>
+		/// <param name="deltaTime">The time since the last frame, in seconds</param>
+		virtual void LateUpdate(float deltaTime) {};
+		/// <summary>
+		/// Invoked before each internal physics sub-step while the scene is playing
+		/// </summary>
+		/// <param name="fixedDeltaTime">The length of the physics sub-step, in seconds</param>
+		virtual void FixedUpdate(float fixedDeltaTime) {};
 
 		/// <summary>
 		/// All components should override this to allow us to render component
@@ -105,6 +132,19 @@ namespace Gameplay {
 		/// <param name="context">The game object that the component belongs to</param>
 		virtual void RenderImGui() = 0;
 
+		/// <summary>
+		/// Captures any state that this component changes while the scene is playing, so
+		/// that the editor can roll it back in place when leaving play mode. Components that
+		/// only hold configuration can leave this as is
+		/// </summary>
+		/// <returns>An opaque copy of the runtime state, or an empty value if there is none</returns>
+		virtual std::any CaptureState() const { return std::any(); }
+		/// <summary>
+		/// Restores state previously returned from CaptureState
+		/// </summary>
+		/// <param name="state">The state that was captured before entering play mode</param>
+		virtual void RestoreState(const std::any& state) {};
+
 		/// <summary>
 		/// Returns the component's type name
 		/// To override in child classes, use MAKE_TYPENAME(Type) instead of
@@ -154,6 +194,24 @@ namespace Gameplay {
 	protected:
 		IComponent();
 
+		/// <summary>
+		/// Helper for implementing CaptureState, packs copies of the given fields into a tuple
+		/// </summary>
+		template <typename ... TArgs>
+		static std::any _PackState(const TArgs& ... fields) {
+			return std::make_tuple(fields...);
+		}
+		/// <summary>
+		/// Helper for implementing RestoreState, unpacks a tuple created by _PackState into the
+		/// given fields. Fields must be passed in the same order they were packed in
+		/// </summary>
+		template <typename ... TArgs>
+		static void _UnpackState(const std::any& state, TArgs& ... fields) {
+			if (state.has_value()) {
+				std::tie(fields...) = std::any_cast<const std::tuple<TArgs...>&>(state);
+			}
+		}
+
 	private:
 		friend class ComponentManager;
 		friend class GameObject;
@@ -177,6 +235,25 @@ namespace Gameplay {
 	constexpr bool is_valid_component() {
 		return std::is_base_of<IComponent, T>::value && test_json<T, const nlohmann::json&>::value;
 	}
+
+	// Resolves to true if the member pointer was declared somewhere below IComponent (ie overridden)
+	template <typename C>
+	constexpr bool is_phase_override(void (C::*)(float)) { return !std::is_same<C, IComponent>::value; }
+	// Fallback for classes that hide the phase method with an unrelated signature
+	template <typename P>
+	constexpr bool is_phase_override(P) { return false; }
+
+	/// <summary>
+	/// Determines which per-frame phases the given component type overrides
+	/// </summary>
+	/// <typeparam name="T">The type to check</typeparam>
+	template <typename T>
+	constexpr uint8_t get_component_phases() {
+		return
+			(is_phase_override(&T::Update)      ? (uint8_t)ComponentPhases::Update      : 0) |
+			(is_phase_override(&T::LateUpdate)  ? (uint8_t)ComponentPhases::LateUpdate  : 0) |
+			(is_phase_override(&T::FixedUpdate) ? (uint8_t)ComponentPhases::FixedUpdate : 0);
+	}
 }
 
 // Defines the ComponentTypeName interface to match those used elsewhere by other systems
@@ -4,7 +4,7 @@
 
 /// <summary>
 /// A simple behaviour that applies an impulse along the Z axis to the 
-/// rigidbody of the parent when the space key is pressed
+/// rigidbody of the parent when the Jump action is pressed
 /// </summary>
 class JumpBehaviour : public Gameplay::IComponent {
 public:
@@ -8,8 +8,12 @@
 MorphAnimator::MorphAnimator()
 	: IComponent(),
 	switchClip(false),
-	timer(0.0f)
-{ }
+	timer(0.0f),
+	UpdateLod()
+{
+	// No point in blending frames for something that isn't on screen
+	UpdateLod.HiddenInterval = 0;
+}
 
 MorphAnimator::~MorphAnimator() = default;
 
@@ -20,6 +24,8 @@ void MorphAnimator::Awake()
 
 void MorphAnimator::Update(float deltaTime)
 {
+	float dt;
+	if (!UpdateLod.ShouldTick(GetGameObject(), deltaTime, dt)) return;
 
 	if (switchClip)
 	{
@@ -29,7 +35,7 @@ void MorphAnimator::Update(float deltaTime)
 
 	else
 	{
-		timer += deltaTime;
+		timer += dt;
 		
 	}
 
@@ -116,6 +122,17 @@ void MorphAnimator::ActivateAnim(std::string name)
 
 void MorphAnimator::RenderImGui()
 {
+	UpdateLod.RenderImGui();
+}
+
+std::any MorphAnimator::CaptureState() const
+{
+	return _PackState(animClips, currentClip, timer, switchClip);
+}
+
+void MorphAnimator::RestoreState(const std::any& state)
+{
+	_UnpackState(state, animClips, currentClip, timer, switchClip);
 }
 
 nlohmann::json MorphAnimator::ToJson() const
@@ -2,6 +2,7 @@
 #include "IComponent.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/UpdateRateLod.h"
 
 class MorphAnimator :
     public Gameplay::IComponent
@@ -35,9 +36,14 @@ public:
 
 	std::vector<animInfo> animClips;
 
+	// Controls how often we tick based on distance to the camera and visibility
+	Gameplay::UpdateRateLod UpdateLod;
+
 public:
 
 	virtual void RenderImGui() override;
+	virtual std::any CaptureState() const override;
+	virtual void RestoreState(const std::any& state) override;
 	MAKE_TYPENAME(MorphAnimator);
 	virtual nlohmann::json ToJson() const override;
 	static MorphAnimator::Sptr FromJson(const nlohmann::json& blob);
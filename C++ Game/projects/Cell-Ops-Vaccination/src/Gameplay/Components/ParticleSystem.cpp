@@ -3,6 +3,7 @@
 #include "Application/Timing.h"
 #include "Application/Application.h"
 #include "Utils/ImGuiHelper.h"
+#include "Graphics/GpuReadback.h"
 
 ParticleSystem::ParticleSystem() :
 	IComponent(),
@@ -114,14 +115,16 @@ void ParticleSystem::Update()
 	glEndTransformFeedback();
 	glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
 
-	// Use our query to get the number of particles
-	glGetQueryObjectuiv(_query, GL_QUERY_RESULT, &_numParticles);
-	if (_numParticles >= _emitters.size()) {
-		_numParticles -= _emitters.size();
-	}
-	else {
-		_numParticles = 0;
-	}
+	// Use our query to get the number of particles, this arrives a few frames late but saves us
+	// from waiting on the GPU to finish the simulation
+	std::weak_ptr<IComponent> selfRef = SelfRef();
+	GpuReadback::ReadQuery(_query, [selfRef](uint32_t count) {
+		std::shared_ptr<IComponent> self = selfRef.lock();
+		if (self != nullptr) {
+			ParticleSystem* system = static_cast<ParticleSystem*>(self.get());
+			system->_numParticles = count >= system->_emitters.size() ? count - (GLuint)system->_emitters.size() : 0;
+		}
+	});
 
 	// Clean up our state
 	glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
@@ -1,18 +1,22 @@
 #include "Gameplay/Components/RenderComponent.h"
 
 #include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/ImGuiHelper.h"
 
 
 RenderComponent::RenderComponent(const Gameplay::MeshResource::Sptr& mesh, const Gameplay::Material::Sptr& material) :
 	_mesh(mesh), 
 	_material(material), 
-	_meshBuilderParams(std::vector<MeshBuilderParam>()) 
+	_meshBuilderParams(std::vector<MeshBuilderParam>()),
+	BoundingRadius(1.0f)
 { }
 
 RenderComponent::RenderComponent() : 
 	_mesh(nullptr), 
 	_material(nullptr), 
-	_meshBuilderParams(std::vector<MeshBuilderParam>())
+	_meshBuilderParams(std::vector<MeshBuilderParam>()),
+	BoundingRadius(1.0f)
 { }
 
 void RenderComponent::SetMesh(const Gameplay::MeshResource::Sptr& mesh) {
@@ -39,6 +43,7 @@ nlohmann::json RenderComponent::ToJson() const {
 	nlohmann::json result;
 	result["mesh"] = _mesh ? _mesh->GetGUID().str() : "null";
 	result["material"] = _material ? _material->GetGUID().str() : "null";
+	result["bounding_radius"] = BoundingRadius;
 	return result;
 }
 
@@ -46,6 +51,7 @@ RenderComponent::Sptr RenderComponent::FromJson(const nlohmann::json& data) {
 	RenderComponent::Sptr result = std::make_shared<RenderComponent>();
 	result->_mesh = ResourceManager::Get<Gameplay::MeshResource>(Guid(data["mesh"].get<std::string>()));
 	result->_material = ResourceManager::Get<Gameplay::Material>(Guid(data["material"].get<std::string>()));
+	result->BoundingRadius = JsonGet(data, "bounding_radius", result->BoundingRadius);
 
 	return result;
 }
@@ -56,4 +62,5 @@ void RenderComponent::RenderImGui() {
 	ImGui::Text("Source:    %s", (_mesh == nullptr || _mesh->Filename.empty()) ? "Generated" : _mesh->Filename.c_str());
 	ImGui::Separator();
 	ImGui::Text("Material:  %s", _material != nullptr ? _material->Name.c_str() : "NULL");
+	LABEL_LEFT(ImGui::DragFloat, "Bounds    ", &BoundingRadius, 0.1f, 0.0f);
 }
@@ -13,6 +13,12 @@ class RenderComponent : public Gameplay::IComponent {
 public:
 	typedef std::shared_ptr<RenderComponent> Sptr;
 
+	/// <summary>
+	/// Radius of the mesh's bounds in local space, scaled by the object's transform when
+	/// picking which lights affect it
+	/// </summary>
+	float BoundingRadius;
+
 	RenderComponent();
 	RenderComponent(const Gameplay::MeshResource::Sptr& mesh, const Gameplay::Material::Sptr& material);
 
@@ -5,22 +5,40 @@
 #include "Utils/ImGuiHelper.h"
 #include "Utils/JsonGlmHelpers.h"
 
+RotatingBehaviour::RotatingBehaviour() :
+	IComponent(),
+	RotationSpeed(glm::vec3(0.0f)),
+	UpdateLod()
+{
+	// Spinning something nobody can see is wasted work
+	UpdateLod.PauseBeyondRange = true;
+	UpdateLod.HiddenInterval = 0;
+}
+
 void RotatingBehaviour::Update(float deltaTime) {
-	GetGameObject()->SetRotation(GetGameObject()->GetRotationEuler() + RotationSpeed * deltaTime);
+	float dt;
+	if (!UpdateLod.ShouldTick(GetGameObject(), deltaTime, dt)) return;
+
+	GetGameObject()->SetRotation(GetGameObject()->GetRotationEuler() + RotationSpeed * dt);
 }
 
 void RotatingBehaviour::RenderImGui() {
 	LABEL_LEFT(ImGui::DragFloat3, "Speed", &RotationSpeed.x);
+	UpdateLod.RenderImGui();
 }
 
 nlohmann::json RotatingBehaviour::ToJson() const {
 	return {
-		{ "speed", RotationSpeed }
+		{ "speed", RotationSpeed },
+		{ "update_lod", UpdateLod.ToJson() }
 	};
 }
 
 RotatingBehaviour::Sptr RotatingBehaviour::FromJson(const nlohmann::json& data) {
 	RotatingBehaviour::Sptr result = std::make_shared<RotatingBehaviour>();
 	result->RotationSpeed = JsonGet(data, "speed", result->RotationSpeed);
+	if (data.contains("update_lod")) {
+		result->UpdateLod.LoadFromJson(data["update_lod"]);
+	}
 	return result;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "IComponent.h"
+#include "Gameplay/UpdateRateLod.h"
 
 /// <summary>
 /// Showcases a very simple behaviour that rotates the parent gameobject at a fixed rate over time
@@ -8,8 +9,10 @@ class RotatingBehaviour : public Gameplay::IComponent {
 public:
 	typedef std::shared_ptr<RotatingBehaviour> Sptr;
 
-	RotatingBehaviour() = default;
+	RotatingBehaviour();
 	glm::vec3 RotationSpeed;
+	// Controls how often we tick based on distance to the camera and visibility
+	Gameplay::UpdateRateLod UpdateLod;
 
 	virtual void Update(float deltaTime) override;
 
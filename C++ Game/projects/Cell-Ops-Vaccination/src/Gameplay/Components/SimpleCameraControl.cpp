@@ -22,12 +22,12 @@ SimpleCameraControl::~SimpleCameraControl() = default;
 
 void SimpleCameraControl::Update(float deltaTime)
 {
-	if (InputEngine::GetMouseState(GLFW_MOUSE_BUTTON_LEFT) == ButtonState::Pressed) {
+	if (InputEngine::GetActionState("Look") == ButtonState::Pressed) {
 		if (_isMousePressed == false) {
 			_prevMousePos = InputEngine::GetMousePos();
 		}
 	}
-	if (InputEngine::IsMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT)) {
+	if (InputEngine::IsActionDown("Look")) {
 		glm::dvec2 currentMousePos = InputEngine::GetMousePos();
 		glm::dvec2 delta = currentMousePos - _prevMousePos;
 
@@ -41,26 +41,11 @@ void SimpleCameraControl::Update(float deltaTime)
 		_prevMousePos = currentMousePos;
 
 		glm::vec3 input = glm::vec3(0.0f);
-		if (InputEngine::IsKeyDown(GLFW_KEY_W)) {
-			input.z -= _moveSpeeds.x;
-		}
-		if (InputEngine::IsKeyDown(GLFW_KEY_S)) {
-			input.z += _moveSpeeds.x;
-		}
-		if (InputEngine::IsKeyDown(GLFW_KEY_A)) {
-			input.x -= _moveSpeeds.y;
-		}
-		if (InputEngine::IsKeyDown(GLFW_KEY_D)) {
-			input.x += _moveSpeeds.y;
-		}
-		if (InputEngine::IsKeyDown(GLFW_KEY_LEFT_CONTROL)) {
-			input.y -= _moveSpeeds.z;
-		}
-		if (InputEngine::IsKeyDown(GLFW_KEY_SPACE)) {
-			input.y += _moveSpeeds.z;
-		}
+		input.z -= InputEngine::GetAxis("MoveForward") * _moveSpeeds.x;
+		input.x += InputEngine::GetAxis("MoveRight") * _moveSpeeds.y;
+		input.y += InputEngine::GetAxis("MoveUp") * _moveSpeeds.z;
 
-		if (InputEngine::IsKeyDown(GLFW_KEY_LEFT_SHIFT)) {
+		if (InputEngine::IsActionDown("Sprint")) {
 			input *= _shiftMultipler;
 		}
 
@@ -78,6 +63,14 @@ void SimpleCameraControl::RenderImGui()
 	LABEL_LEFT(ImGui::DragFloat, "Shift Multiplier ", &_shiftMultipler, 0.01f, 1.0f);
 }
 
+std::any SimpleCameraControl::CaptureState() const {
+	return _PackState(_prevMousePos, _currentRot, _isMousePressed);
+}
+
+void SimpleCameraControl::RestoreState(const std::any& state) {
+	_UnpackState(state, _prevMousePos, _currentRot, _isMousePressed);
+}
+
 nlohmann::json SimpleCameraControl::ToJson() const {
 	return {
 		{ "mouse_sensitivity", _mouseSensitivity },
@@ -18,6 +18,8 @@ public:
 
 public:
 	virtual void RenderImGui() override;
+	virtual std::any CaptureState() const override;
+	virtual void RestoreState(const std::any& state) override;
 	MAKE_TYPENAME(SimpleCameraControl);
 	virtual nlohmann::json ToJson() const override;
 	static SimpleCameraControl::Sptr FromJson(const nlohmann::json& blob);
@@ -30,6 +30,14 @@ TargetController::Sptr TargetController::FromJson(const nlohmann::json& blob)
 void TargetController::RenderImGui()
 {
 }
+std::any TargetController::CaptureState() const
+{
+	return _PackState(_occupiedPositions, _isNotSafe, _targetPosition);
+}
+void TargetController::RestoreState(const std::any& state)
+{
+	_UnpackState(state, _occupiedPositions, _isNotSafe, _targetPosition);
+}
 void TargetController::Spawntargets()
 {
 	for (int i = 0; i < TargetNames.size(); i++) {
@@ -21,6 +21,8 @@ public:
 	virtual nlohmann::json ToJson() const override;
 	static TargetController::Sptr FromJson(const nlohmann::json& blob);
 	virtual void RenderImGui() override;
+	virtual std::any CaptureState() const override;
+	virtual void RestoreState(const std::any& state) override;
 
 	//Names of Targets
 	std::vector<std::string> TargetNames;
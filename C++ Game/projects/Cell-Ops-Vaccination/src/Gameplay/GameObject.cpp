@@ -114,6 +114,7 @@ namespace Gameplay {
 	void GameObject::SetPostion(const glm::vec3& position) {
 		_position = position;
 		_isLocalTransformDirty = true;
+		MarkDirty();
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
@@ -123,6 +124,7 @@ namespace Gameplay {
 	void GameObject::SetRotation(const glm::quat& value) {
 		_rotation = value;
 		_isLocalTransformDirty = true;
+		MarkDirty();
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
@@ -132,6 +134,7 @@ namespace Gameplay {
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
 		_rotation = glm::quat(glm::radians(eulerAngles));
 		_isLocalTransformDirty = true;
+		MarkDirty();
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
@@ -141,6 +144,7 @@ namespace Gameplay {
 	void GameObject::SetScale(const glm::vec3& value) {
 		_scale = value;
 		_isLocalTransformDirty = true;
+		MarkDirty();
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
@@ -206,12 +210,6 @@ namespace Gameplay {
 	}
 
 	void GameObject::Update(float dt) {
-		for (auto& component : _components) {
-			if (component->IsEnabled) {
-				component->Update(dt);
-			}
-		}
-
 		_RecalcLocalTransform();
 		_RecalcWorldTransform();
 		_PurgeDeletedChildren();
@@ -252,6 +250,7 @@ namespace Gameplay {
 		// Append it to the binding component's storage, and invoke the OnLoad
 		_components.push_back(component);
 		component->OnLoad();
+		MarkDirty();
 
 		if (_scene->GetIsAwake()) {
 			component->Awake();
@@ -276,6 +275,8 @@ namespace Gameplay {
 			_children.push_back(child);
 			child->_parent = _selfRef.lock();
 			child->_isWorldTransformDirty = true;
+			child->MarkDirty();
+			MarkDirty();
 		}
 		else {
 			LOG_WARN("Attempting to add same child twice, ignoring: {}", child->Name);
@@ -290,6 +291,8 @@ namespace Gameplay {
 			// Clear the object's parent and remove from our list of children
 			child->_parent.Reset();
 			_children.erase(it);
+			child->MarkDirty();
+			MarkDirty();
 			return true;
 		}
 		else {
@@ -305,12 +308,29 @@ namespace Gameplay {
 		return _parent;
 	}
 
+	uint64_t GameObject::GetRevision() const {
+		// Revisions only ever increase, so the newest one out of everything stored
+		// with this object tells us if any of it has changed
+		uint64_t result = _revision;
+		for (const auto& component : _components) {
+			result = glm::max(result, component->GetRevision());
+		}
+		for (const auto& child : _children) {
+			GameObject::Sptr childPtr = child;
+			if (childPtr != nullptr) {
+				result = glm::max(result, childPtr->GetRevision());
+			}
+		}
+		return result;
+	}
+
 	void GameObject::DrawImGui(bool invokedFromScene) {
 		if (invokedFromScene && _parent != nullptr) {
 			return;
 		}
 
 		ImGui::PushID(this); // Push a new ImGui ID scope for this object
+		bool wasEdited = ImGuiHelper::IsAnyItemEditedThisFrame();
 		// Since we're allowing names to change, we need to use the ### to have a static ID for the header
 		static char buffer[256];
 		sprintf_s(buffer, 256, "%s###GO_HEADER", Name.c_str());
@@ -394,6 +414,7 @@ namespace Gameplay {
 					if (ImGuiHelper::WarningButton("Delete")) {
 						_components.erase(_components.begin() + ix);
 						ix--;
+						MarkDirty();
 					}
 					ImGui::PopID();
 				}
@@ -437,6 +458,11 @@ namespace Gameplay {
 		}
 		ImGui::PopID(); // Pop the ImGui ID scope for the object
 
+		// If any of our fields were changed, we'll need to be saved again
+		if (!wasEdited && ImGuiHelper::IsAnyItemEditedThisFrame()) {
+			MarkDirty();
+		}
+
 		// For if we're not in play mode
 		_RecalcLocalTransform();
 		_RecalcWorldTransform();
@@ -466,7 +492,7 @@ namespace Gameplay {
 
 		// Since our components are stored based on the type name, we iterate
 		// on the keys and values from the components object
-		nlohmann::json components = data["components"];
+		const nlohmann::json& components = data["components"];
 		for (auto& [typeName, value] : components.items()) {
 			// We need to reference the component registry to load our components
 			// based on the type name (note that all component types need to be
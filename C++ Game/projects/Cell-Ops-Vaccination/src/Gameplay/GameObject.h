@@ -240,7 +240,9 @@ namespace Gameplay {
 		void Awake();
 
 		/// <summary>
-		/// Calls update on all enabled components in this object
+		/// Recalculates the object's transforms and cleans up the hierarchy after components
+		/// have been updated. Component updates are dispatched by the scene per phase, see
+		/// ComponentManager::EachInPhase
 		/// </summary>
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		void Update(float dt);
@@ -300,6 +302,7 @@ namespace Gameplay {
 			// Append it to the binding component's storage, and invoke the OnLoad
 			_components.push_back(component);
 			component->OnLoad();
+			MarkDirty();
 
 			if (_scene->GetIsAwake()) {
 				component->Awake();
@@ -332,6 +335,14 @@ namespace Gameplay {
 		/// </summary>
 		nlohmann::json ToJson() const;
 
+		/// <summary>
+		/// Gets the revision of this object's serialized state, which includes its components
+		/// and children since they are stored as part of the object. Note that changes to the
+		/// Name field or a component's data from code should be followed up with a call to
+		/// MarkDirty, or they may be missed by incremental saves
+		/// </summary>
+		virtual uint64_t GetRevision() const override;
+
 	private:
 		friend class Scene;
 		friend class InspectorWindow;
@@ -1,6 +1,9 @@
 #include "Gameplay/InputEngine.h"
 #include <locale>
 #include <codecvt>
+#include <cctype>
+#include <cstdlib>
+#include "Logging.h"
 
 GLFWwindow* InputEngine::__window = nullptr;
 glm::dvec2 InputEngine::__mousePos = glm::dvec2(0.0);
@@ -10,6 +13,117 @@ std::wstring InputEngine::__inputText = LR"()";
 
 ButtonState InputEngine::__mouseState[GLFW_MOUSE_BUTTON_LAST + 1];
 ButtonState InputEngine::__keyState[GLFW_KEY_LAST + 1];
+bool InputEngine::__mouseReleasePending[GLFW_MOUSE_BUTTON_LAST + 1];
+bool InputEngine::__keyReleasePending[GLFW_KEY_LAST + 1];
+std::vector<int> InputEngine::__touchedKeys;
+bool InputEngine::__isKeyTouched[GLFW_KEY_LAST + 1];
+
+uint64_t InputEngine::__frameIndex = 0;
+std::vector<InputEvent> InputEngine::__frameEvents;
+std::vector<InputEvent> InputEngine::__pendingTickEvents;
+std::vector<InputEvent> InputEngine::__tickEvents;
+
+std::unordered_map<std::string, std::vector<InputBinding>> InputEngine::__actions;
+std::unordered_map<std::string, InputEngine::Axis> InputEngine::__axes;
+
+namespace {
+	// Keys that can't be named by a single letter, digit, or F1-F25
+	const std::unordered_map<std::string, int> KeyNames = {
+		{ "Space",        GLFW_KEY_SPACE },
+		{ "Escape",       GLFW_KEY_ESCAPE },
+		{ "Enter",        GLFW_KEY_ENTER },
+		{ "Tab",          GLFW_KEY_TAB },
+		{ "Backspace",    GLFW_KEY_BACKSPACE },
+		{ "Insert",       GLFW_KEY_INSERT },
+		{ "Delete",       GLFW_KEY_DELETE },
+		{ "Home",         GLFW_KEY_HOME },
+		{ "End",          GLFW_KEY_END },
+		{ "PageUp",       GLFW_KEY_PAGE_UP },
+		{ "PageDown",     GLFW_KEY_PAGE_DOWN },
+		{ "Left",         GLFW_KEY_LEFT },
+		{ "Right",        GLFW_KEY_RIGHT },
+		{ "Up",           GLFW_KEY_UP },
+		{ "Down",         GLFW_KEY_DOWN },
+		{ "LeftShift",    GLFW_KEY_LEFT_SHIFT },
+		{ "RightShift",   GLFW_KEY_RIGHT_SHIFT },
+		{ "LeftControl",  GLFW_KEY_LEFT_CONTROL },
+		{ "RightControl", GLFW_KEY_RIGHT_CONTROL },
+		{ "LeftAlt",      GLFW_KEY_LEFT_ALT },
+		{ "RightAlt",     GLFW_KEY_RIGHT_ALT },
+		{ "Grave",        GLFW_KEY_GRAVE_ACCENT },
+		{ "Minus",        GLFW_KEY_MINUS },
+		{ "Equal",        GLFW_KEY_EQUAL },
+		{ "Comma",        GLFW_KEY_COMMA },
+		{ "Period",       GLFW_KEY_PERIOD },
+		{ "Slash",        GLFW_KEY_SLASH }
+	};
+
+	const std::unordered_map<std::string, int> MouseButtonNames = {
+		{ "MouseLeft",   GLFW_MOUSE_BUTTON_LEFT },
+		{ "MouseRight",  GLFW_MOUSE_BUTTON_RIGHT },
+		{ "MouseMiddle", GLFW_MOUSE_BUTTON_MIDDLE }
+	};
+
+	// Turns a key or button name from the bindings into a binding, raw GLFW key codes are allowed as well
+	bool ParseBinding(const nlohmann::json& value, InputBinding& outBinding) {
+		if (value.is_number_integer()) {
+			outBinding = { InputDevice::Keyboard, value.get<int>() };
+			return outBinding.Code >= 0 && outBinding.Code <= GLFW_KEY_LAST;
+		}
+		if (!value.is_string()) {
+			return false;
+		}
+
+		const std::string name = value.get<std::string>();
+		if (name.size() == 1 && ((name[0] >= 'A' && name[0] <= 'Z') || (name[0] >= '0' && name[0] <= '9'))) {
+			// GLFW uses the ASCII codes for letters and digits
+			outBinding = { InputDevice::Keyboard, name[0] };
+			return true;
+		}
+		if (name.size() > 1 && name[0] == 'F' && std::isdigit((unsigned char)name[1])) {
+			int index = std::atoi(name.c_str() + 1);
+			if (index >= 1 && index <= 25) {
+				outBinding = { InputDevice::Keyboard, GLFW_KEY_F1 + index - 1 };
+				return true;
+			}
+		}
+
+		auto key = KeyNames.find(name);
+		if (key != KeyNames.end()) {
+			outBinding = { InputDevice::Keyboard, key->second };
+			return true;
+		}
+		auto button = MouseButtonNames.find(name);
+		if (button != MouseButtonNames.end()) {
+			outBinding = { InputDevice::Mouse, button->second };
+			return true;
+		}
+		return false;
+	}
+
+	// Accepts either a single key name or a list of them
+	std::vector<InputBinding> ParseBindings(const nlohmann::json& blob, const std::string& owner) {
+		std::vector<InputBinding> result;
+		if (!blob.is_array()) {
+			InputBinding binding;
+			if (ParseBinding(blob, binding)) {
+				result.push_back(binding);
+			} else {
+				LOG_WARN("Unknown key \"{}\" bound to \"{}\"", blob.dump(), owner);
+			}
+			return result;
+		}
+		for (const nlohmann::json& value : blob) {
+			InputBinding binding;
+			if (ParseBinding(value, binding)) {
+				result.push_back(binding);
+			} else {
+				LOG_WARN("Unknown key \"{}\" bound to \"{}\"", value.dump(), owner);
+			}
+		}
+		return result;
+	}
+}
 
 void InputEngine::Init(GLFWwindow* window)
 {
@@ -18,6 +132,11 @@ void InputEngine::Init(GLFWwindow* window)
 	glfwSetMouseButtonCallback(__window, InputEngine::__MouseButtonCallback);
 	glfwSetKeyCallback(__window, InputEngine::__KeyCallback);
 	glfwSetScrollCallback(__window, InputEngine::__MouseScrollCallback);
+
+	__touchedKeys.reserve(32);
+	__frameEvents.reserve(32);
+	__pendingTickEvents.reserve(MAX_PENDING_TICK_EVENTS);
+	__tickEvents.reserve(MAX_PENDING_TICK_EVENTS);
 }
 
 ButtonState InputEngine::GetKeyState(int keyCode) {
@@ -58,22 +177,203 @@ std::string InputEngine::GetInputTextAscii() {
 	return StringConvert.to_bytes(__inputText);
 }
 
+void InputEngine::LoadBindings(const nlohmann::json& blob) {
+	__actions.clear();
+	__axes.clear();
+
+	if (blob.contains("actions")) {
+		for (const auto& [name, keys] : blob["actions"].items()) {
+			__actions[name] = ParseBindings(keys, name);
+		}
+	}
+	if (blob.contains("axes")) {
+		for (const auto& [name, ends] : blob["axes"].items()) {
+			Axis& axis = __axes[name];
+			if (ends.contains("positive")) {
+				axis.Positive = ParseBindings(ends["positive"], name);
+			}
+			if (ends.contains("negative")) {
+				axis.Negative = ParseBindings(ends["negative"], name);
+			}
+		}
+	}
+}
+
+nlohmann::json InputEngine::GetDefaultBindings() {
+	return {
+		{ "actions", {
+			{ "Start",   { "Enter" } },
+			{ "Pause",   { "Escape" } },
+			{ "Restart", { "Tab" } },
+			{ "Cheat",   { "F2" } },
+			{ "Jump",    { "Space" } },
+			{ "Sprint",  { "LeftShift" } },
+			// Held to look around with the debug camera
+			{ "Look",    { "MouseLeft" } }
+		}},
+		{ "axes", {
+			{ "MoveForward", { { "positive", { "W" } }, { "negative", { "S" } } } },
+			{ "MoveRight",   { { "positive", { "D" } }, { "negative", { "A" } } } },
+			{ "MoveUp",      { { "positive", { "Space" } }, { "negative", { "LeftControl" } } } }
+		}}
+	};
+}
+
+ButtonState InputEngine::GetActionState(const std::string& action) {
+	auto it = __actions.find(action);
+	if (it == __actions.end()) {
+		return ButtonState::Up;
+	}
+
+	bool held = false;
+	bool pressed = false;
+	bool released = false;
+	for (const InputBinding& binding : it->second) {
+		ButtonState state = __GetBindingState(binding);
+		held     |= state == ButtonState::Down;
+		pressed  |= state == ButtonState::Pressed;
+		released |= state == ButtonState::Released;
+	}
+
+	if (held) {
+		return ButtonState::Down;
+	}
+	if (pressed) {
+		return ButtonState::Pressed;
+	}
+	return released ? ButtonState::Released : ButtonState::Up;
+}
+
+bool InputEngine::IsActionDown(const std::string& action) {
+	return *GetActionState(action) & 0b01;
+}
+
+float InputEngine::GetAxis(const std::string& axis) {
+	auto it = __axes.find(axis);
+	if (it == __axes.end()) {
+		return 0.0f;
+	}
+
+	float result = 0.0f;
+	for (const InputBinding& binding : it->second.Positive) {
+		if (*__GetBindingState(binding) & 0b01) {
+			result += 1.0f;
+			break;
+		}
+	}
+	for (const InputBinding& binding : it->second.Negative) {
+		if (*__GetBindingState(binding) & 0b01) {
+			result -= 1.0f;
+			break;
+		}
+	}
+	return result;
+}
+
+const std::vector<InputEvent>& InputEngine::GetFrameEvents() {
+	return __frameEvents;
+}
+
+void InputEngine::BeginTick() {
+	__tickEvents.clear();
+
+	double now = glfwGetTime();
+	for (const InputEvent& e : __pendingTickEvents) {
+		if (now - e.Time <= MAX_TICK_EVENT_AGE) {
+			__tickEvents.push_back(e);
+		}
+	}
+	__pendingTickEvents.clear();
+}
+
+const std::vector<InputEvent>& InputEngine::GetTickEvents() {
+	return __tickEvents;
+}
+
+bool InputEngine::WasActionPressedThisTick(const std::string& action) {
+	return __HasTickEvent(action, ButtonState::Pressed);
+}
+
+bool InputEngine::WasActionReleasedThisTick(const std::string& action) {
+	return __HasTickEvent(action, ButtonState::Released);
+}
+
 void InputEngine::EndFrame() {
 	__prevMousePos = __mousePos;
 	glfwGetCursorPos(__window, &__mousePos.x, &__mousePos.y);
 
 	__scrollDelta.x = __scrollDelta.y = 0.0;
 	__inputText.clear();
+	__frameEvents.clear();
+	__frameIndex++;
 
 	// Since we used a bit field for our enum values, we can do a quick and
-	// to convert from pressed or released to down/up
-	for (int ix = 0; ix < GLFW_KEY_LAST + 1; ix++) {
-		__keyState[ix] = (ButtonState)(*__keyState[ix] & 0b01);
+	// to convert from pressed or released to down/up. Only keys that changed
+	// this frame need to be visited, keys that were tapped within the frame
+	// stay around for one more frame so they can show up as Released
+	size_t kept = 0;
+	for (size_t ix = 0; ix < __touchedKeys.size(); ix++) {
+		int key = __touchedKeys[ix];
+		if (__keyReleasePending[key]) {
+			__keyReleasePending[key] = false;
+			__keyState[key] = ButtonState::Released;
+			__touchedKeys[kept++] = key;
+		} else {
+			__keyState[key] = (ButtonState)(*__keyState[key] & 0b01);
+			__isKeyTouched[key] = false;
+		}
 	}
+	__touchedKeys.resize(kept);
 
 	for (int ix = 0; ix < GLFW_MOUSE_BUTTON_LAST + 1; ix++) {
-		__mouseState[ix] = (ButtonState)(*__mouseState[ix] & 0b01);
+		if (__mouseReleasePending[ix]) {
+			__mouseReleasePending[ix] = false;
+			__mouseState[ix] = ButtonState::Released;
+		} else {
+			__mouseState[ix] = (ButtonState)(*__mouseState[ix] & 0b01);
+		}
+	}
+}
+
+ButtonState InputEngine::__GetBindingState(const InputBinding& binding) {
+	return binding.Device == InputDevice::Mouse ? GetMouseState(binding.Code) : GetKeyState(binding.Code);
+}
+
+bool InputEngine::__HasTickEvent(const std::string& action, ButtonState state) {
+	auto it = __actions.find(action);
+	if (it == __actions.end()) {
+		return false;
+	}
+
+	for (const InputEvent& e : __tickEvents) {
+		if (e.State != state) {
+			continue;
+		}
+		for (const InputBinding& binding : it->second) {
+			if (binding.Device == e.Device && binding.Code == e.Code) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void InputEngine::__TouchKey(int key) {
+	if (!__isKeyTouched[key]) {
+		__isKeyTouched[key] = true;
+		__touchedKeys.push_back(key);
+	}
+}
+
+void InputEngine::__PushEvent(InputDevice device, int code, ButtonState state, int mods) {
+	InputEvent e = { glfwGetTime(), __frameIndex, device, code, state, mods };
+	__frameEvents.push_back(e);
+
+	// Nothing drains the queue while physics is paused, so the oldest events make room for new ones
+	if (__pendingTickEvents.size() >= MAX_PENDING_TICK_EVENTS) {
+		__pendingTickEvents.erase(__pendingTickEvents.begin());
 	}
+	__pendingTickEvents.push_back(e);
 }
 
 
@@ -84,9 +384,19 @@ void InputEngine::__KeyCallback(GLFWwindow* window, int key, int scancode, int a
 	switch (action) {
 	case GLFW_PRESS:
 		__keyState[key] = ButtonState::Pressed;
+		__keyReleasePending[key] = false;
+		__TouchKey(key);
+		__PushEvent(InputDevice::Keyboard, key, ButtonState::Pressed, mods);
 		break;
 	case GLFW_RELEASE:
-		__keyState[key] = ButtonState::Released;
+		// If the key went down this frame, keep it Pressed so the press isn't lost, and let EndFrame release it
+		if (__keyState[key] == ButtonState::Pressed) {
+			__keyReleasePending[key] = true;
+		} else {
+			__keyState[key] = ButtonState::Released;
+		}
+		__TouchKey(key);
+		__PushEvent(InputDevice::Keyboard, key, ButtonState::Released, mods);
 		break;
 	default:
 		break;
@@ -103,9 +413,17 @@ void InputEngine::__MouseButtonCallback(GLFWwindow* window, int button, int acti
 
 	if (action == GLFW_PRESS) {
 		__mouseState[button] = ButtonState::Pressed;
+		__mouseReleasePending[button] = false;
+		__PushEvent(InputDevice::Mouse, button, ButtonState::Pressed, mods);
 	}
 	else if (action == GLFW_RELEASE) {
-		__mouseState[button] = ButtonState::Released;
+		// Same as keys, a click within a single frame is Pressed for one frame and Released for the next
+		if (__mouseState[button] == ButtonState::Pressed) {
+			__mouseReleasePending[button] = true;
+		} else {
+			__mouseState[button] = ButtonState::Released;
+		}
+		__PushEvent(InputDevice::Mouse, button, ButtonState::Released, mods);
 	}
 }
 
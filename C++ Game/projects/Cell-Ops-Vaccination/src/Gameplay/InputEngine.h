@@ -2,6 +2,10 @@
 
 #include <GLM/glm.hpp>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <json.hpp>
 #include <EnumToString.h>
 #include "GLFW/glfw3.h"
 
@@ -18,8 +22,45 @@ ENUM(CursorMode, int,
 	 Hidden   = GLFW_CURSOR_HIDDEN
 );
 
+ENUM(InputDevice, int,
+	 Keyboard = 0,
+	 Mouse    = 1
+);
+
+/// <summary>
+/// A key or mouse button that triggers an action or axis
+/// </summary>
+struct InputBinding {
+	InputDevice Device;
+	// The GLFW key code or mouse button
+	int         Code;
+};
+
+/// <summary>
+/// A single key or mouse button press or release, in the order that they happened
+/// </summary>
+struct InputEvent {
+	// The time that the event was received, in seconds since GLFW was initialized
+	double      Time;
+	// The frame that the event was received in
+	uint64_t    Frame;
+	InputDevice Device;
+	// The GLFW key code or mouse button
+	int         Code;
+	// Either Pressed or Released
+	ButtonState State;
+	// The GLFW modifier keys that were held
+	int         Mods;
+};
+
 class InputEngine {
 public:
+	// Events that are older than this are dropped rather than handed to the next fixed update,
+	// so that input doesn't pile up while physics isn't being stepped (ex: on the title screen)
+	static constexpr double MAX_TICK_EVENT_AGE = 0.25;
+	// The most events that can be waiting for a fixed update
+	static constexpr size_t MAX_PENDING_TICK_EVENTS = 256;
+
 	static void Init(GLFWwindow* window);
 
 	static ButtonState GetKeyState(int keyCode);
@@ -36,19 +77,91 @@ public:
 	static std::wstring GetInputText();
 	static std::string  GetInputTextAscii();
 
+	/// <summary>
+	/// Replaces the action and axis bindings, see GetDefaultBindings for the format.
+	/// Keys are named like "W", "Space" or "LeftShift", mouse buttons like "MouseLeft"
+	/// </summary>
+	static void LoadBindings(const nlohmann::json& blob);
+	/// <summary>
+	/// Gets the bindings that the game uses out of the box
+	/// </summary>
+	static nlohmann::json GetDefaultBindings();
+
+	/// <summary>
+	/// Gets the state of an action, combining all of the keys and buttons bound to it. The action
+	/// is only Pressed or Released if it wasn't already being held by another binding
+	/// </summary>
+	/// <param name="action">The name of the action, unknown actions are always Up</param>
+	static ButtonState GetActionState(const std::string& action);
+	static bool IsActionDown(const std::string& action);
+	/// <summary>
+	/// Gets the value of an axis, between -1 and 1, from the keys bound to either end of it
+	/// </summary>
+	/// <param name="axis">The name of the axis, unknown axes are always 0</param>
+	static float GetAxis(const std::string& axis);
+
+	/// <summary>
+	/// Gets the key and mouse button events that were received this frame, in order
+	/// </summary>
+	static const std::vector<InputEvent>& GetFrameEvents();
+
+	/// <summary>
+	/// Hands the events that have arrived since the last fixed update to the next one, called by the
+	/// scene before each physics sub-step. Every event is seen by exactly one fixed update, even if
+	/// several sub-steps (or none) run in a frame
+	/// </summary>
+	static void BeginTick();
+	/// <summary>
+	/// Gets the events for the current fixed update, in the order that they happened
+	/// </summary>
+	static const std::vector<InputEvent>& GetTickEvents();
+	/// <summary>
+	/// Checks whether any binding of an action was pressed since the last fixed update, for use in FixedUpdate
+	/// </summary>
+	static bool WasActionPressedThisTick(const std::string& action);
+	/// <summary>
+	/// Checks whether any binding of an action was released since the last fixed update, for use in FixedUpdate
+	/// </summary>
+	static bool WasActionReleasedThisTick(const std::string& action);
+
 	static void EndFrame();
 
 private:
+	struct Axis {
+		std::vector<InputBinding> Positive;
+		std::vector<InputBinding> Negative;
+	};
+
 	static GLFWwindow*  __window;
 	static ButtonState  __keyState[GLFW_KEY_LAST + 1];
 	static ButtonState  __mouseState[GLFW_MOUSE_BUTTON_LAST + 1];
+	// Set for keys and buttons that were pressed and released within the same frame, so that they
+	// show up as Pressed for one frame and Released for the next instead of being lost
+	static bool         __keyReleasePending[GLFW_KEY_LAST + 1];
+	static bool         __mouseReleasePending[GLFW_MOUSE_BUTTON_LAST + 1];
+	// Keys that are Pressed or Released, and need to be moved to Down or Up by EndFrame
+	static std::vector<int> __touchedKeys;
+	static bool         __isKeyTouched[GLFW_KEY_LAST + 1];
 	static glm::dvec2   __mousePos;
 	static glm::dvec2   __prevMousePos;
 	static glm::dvec2   __scrollDelta;
 	static std::wstring __inputText;
 
+	static uint64_t     __frameIndex;
+	static std::vector<InputEvent> __frameEvents;
+	static std::vector<InputEvent> __pendingTickEvents;
+	static std::vector<InputEvent> __tickEvents;
+
+	static std::unordered_map<std::string, std::vector<InputBinding>> __actions;
+	static std::unordered_map<std::string, Axis> __axes;
+
+	static ButtonState __GetBindingState(const InputBinding& binding);
+	static bool __HasTickEvent(const std::string& action, ButtonState state);
+	static void __TouchKey(int key);
+	static void __PushEvent(InputDevice device, int code, ButtonState state, int mods);
+
 	static void __KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 	static void __CharCallback(GLFWwindow* window, uint32_t keycode);
 	static void __MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 	static void __MouseScrollCallback(GLFWwindow* window, double x, double y);
-};
\ No newline at end of file
+};
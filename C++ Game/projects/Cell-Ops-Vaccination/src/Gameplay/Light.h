@@ -20,6 +20,13 @@ namespace Gameplay {
 		/// </summary>
 		float Range = 4.0f;
 
+		/// <summary>
+		/// Gets the attenuation factor that the shaders use for this light, derived from its range
+		/// </summary>
+		inline float GetAttenuation() const {
+			return 1.0f / (1.0f + Range);
+		}
+
 		/// <summary>
 		/// Loads a light from a JSON blob
 		/// </summary>
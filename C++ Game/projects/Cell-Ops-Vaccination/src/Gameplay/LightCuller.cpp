@@ -0,0 +1,190 @@
+#include "LightCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Utils/ImGuiHelper.h"
+
+namespace Gameplay {
+	LightCuller::LightCuller() :
+		CutoffIntensity(1.0f / 256.0f),
+		CellSize(20.0f),
+		MaxCellsPerLight(64),
+		_volumes(),
+		_cells(),
+		_globalLights(),
+		_visitedStamps(),
+		_currentStamp(0),
+		_queries(0),
+		_candidatesTested(0),
+		_lightsSelected(0),
+		_maxSelected(0)
+	{ }
+
+	float LightCuller::GetInfluenceRadius(const Light& light) const {
+		// The shaders attenuate by 1 / (1 + a * d^2), so solve for the distance where the
+		// brightest channel drops under the cutoff
+		float intensity = glm::max(light.Color.r, glm::max(light.Color.g, light.Color.b));
+		float attenuation = light.GetAttenuation();
+		if (intensity <= CutoffIntensity) {
+			return 0.0f;
+		}
+		if (attenuation <= 0.0f) {
+			return std::numeric_limits<float>::infinity();
+		}
+		return glm::sqrt((intensity / CutoffIntensity - 1.0f) / attenuation);
+	}
+
+	void LightCuller::Build(const std::vector<Light>& lights, int maxLights) {
+		_queries = 0;
+		_candidatesTested = 0;
+		_lightsSelected = 0;
+		_maxSelected = 0;
+
+		// Don't let a bad value from the editor explode the number of cells
+		CutoffIntensity = glm::max(CutoffIntensity, 0.0001f);
+		CellSize = glm::max(CellSize, 0.1f);
+
+		int count = glm::min((int)lights.size(), maxLights);
+		_volumes.resize(count);
+		_globalLights.clear();
+		// Keep the cell lists around between frames so we're not re-allocating them every frame
+		for (auto& [key, cell] : _cells) {
+			cell.clear();
+		}
+
+		for (int ix = 0; ix < count; ix++) {
+			const Light& light = lights[ix];
+			LightVolume& volume = _volumes[ix];
+			volume.Position = light.Position;
+			volume.Intensity = glm::max(light.Color.r, glm::max(light.Color.g, light.Color.b));
+			volume.Attenuation = light.GetAttenuation();
+			volume.Radius = GetInfluenceRadius(light);
+
+			if (!std::isfinite(volume.Radius)) {
+				_globalLights.push_back(ix);
+				continue;
+			}
+
+			glm::ivec3 min = _CellAt(volume.Position - glm::vec3(volume.Radius));
+			glm::ivec3 max = _CellAt(volume.Position + glm::vec3(volume.Radius));
+			glm::ivec3 span = max - min + glm::ivec3(1);
+			if ((int64_t)span.x * span.y * span.z > MaxCellsPerLight) {
+				_globalLights.push_back(ix);
+				continue;
+			}
+
+			for (int x = min.x; x <= max.x; x++) {
+				for (int y = min.y; y <= max.y; y++) {
+					for (int z = min.z; z <= max.z; z++) {
+						_cells[_PackCell(glm::ivec3(x, y, z))].push_back(ix);
+					}
+				}
+			}
+		}
+
+		// Drop cells that no light touches anymore, so moving lights don't grow the map forever
+		for (auto it = _cells.begin(); it != _cells.end();) {
+			it = it->second.empty() ? _cells.erase(it) : std::next(it);
+		}
+
+		if (_visitedStamps.size() < _volumes.size()) {
+			_visitedStamps.resize(_volumes.size(), 0);
+		}
+	}
+
+	int LightCuller::Select(const glm::vec3& center, float radius, int* outIndices) const {
+		_queries++;
+		if (_volumes.empty()) {
+			return 0;
+		}
+
+		// Stamps let us skip lights we've already tested without clearing a visited list every query
+		if (++_currentStamp == 0) {
+			std::fill(_visitedStamps.begin(), _visitedStamps.end(), 0);
+			_currentStamp = 1;
+		}
+
+		float scores[MAX_LIGHTS_PER_OBJECT];
+		int count = 0;
+
+		auto consider = [&](int index) {
+			if (_visitedStamps[index] == _currentStamp) return;
+			_visitedStamps[index] = _currentStamp;
+			_candidatesTested++;
+
+			const LightVolume& volume = _volumes[index];
+			float dist = glm::distance(center, volume.Position);
+			if (dist > volume.Radius + radius) return;
+
+			// Score by the contribution at the nearest point of the object's bounds, which is
+			// what its most brightly lit fragment would see
+			float nearest = glm::max(dist - radius, 0.0f);
+			float score = volume.Intensity / (1.0f + volume.Attenuation * nearest * nearest);
+			if (count == MAX_LIGHTS_PER_OBJECT && score <= scores[count - 1]) return;
+
+			// Insertion sort into our short list, dropping the weakest light if it's full
+			int slot = glm::min(count, MAX_LIGHTS_PER_OBJECT - 1);
+			while (slot > 0 && scores[slot - 1] < score) {
+				scores[slot] = scores[slot - 1];
+				outIndices[slot] = outIndices[slot - 1];
+				slot--;
+			}
+			scores[slot] = score;
+			outIndices[slot] = index;
+			count = glm::min(count + 1, MAX_LIGHTS_PER_OBJECT);
+		};
+
+		for (int index : _globalLights) {
+			consider(index);
+		}
+
+		glm::ivec3 min = _CellAt(center - glm::vec3(radius));
+		glm::ivec3 max = _CellAt(center + glm::vec3(radius));
+		glm::ivec3 span = max - min + glm::ivec3(1);
+		if ((int64_t)span.x * span.y * span.z > MaxCellsPerLight) {
+			// Huge objects would touch more cells than there are lights, just test everything
+			for (int ix = 0; ix < (int)_volumes.size(); ix++) {
+				consider(ix);
+			}
+		} else {
+			for (int x = min.x; x <= max.x; x++) {
+				for (int y = min.y; y <= max.y; y++) {
+					for (int z = min.z; z <= max.z; z++) {
+						auto it = _cells.find(_PackCell(glm::ivec3(x, y, z)));
+						if (it == _cells.end()) continue;
+						for (int index : it->second) {
+							consider(index);
+						}
+					}
+				}
+			}
+		}
+
+		_lightsSelected += count;
+		_maxSelected = glm::max(_maxSelected, count);
+		return count;
+	}
+
+	glm::ivec3 LightCuller::_CellAt(const glm::vec3& position) const {
+		return glm::ivec3(glm::floor(position / CellSize));
+	}
+
+	uint64_t LightCuller::_PackCell(const glm::ivec3& cell) {
+		// 21 bits per axis, far away cells can alias but that only costs an extra distance test
+		const uint64_t mask = (1ull << 21) - 1;
+		return (((uint64_t)cell.x & mask) << 42) | (((uint64_t)cell.y & mask) << 21) | ((uint64_t)cell.z & mask);
+	}
+
+	void LightCuller::RenderImGui() {
+		LABEL_LEFT(ImGui::DragFloat, "Cutoff   ", &CutoffIntensity, 0.0005f, 0.0001f, 1.0f, "%.4f");
+		LABEL_LEFT(ImGui::DragFloat, "Cell Size", &CellSize, 0.5f, 0.5f, 500.0f);
+		LABEL_LEFT(ImGui::DragInt, "Max Cells", &MaxCellsPerLight, 1.0f, 1, 4096);
+
+		ImGui::Text("Lights: %d (%d unbinned), cells: %d", (int)_volumes.size(), (int)_globalLights.size(), (int)_cells.size());
+		float queries = (float)glm::max(_queries, 1);
+		ImGui::Text("Draws: %d, lights/draw: %.2f avg, %d max", _queries, _lightsSelected / queries, _maxSelected);
+		ImGui::Text("Candidates/draw: %.2f", _candidatesTested / queries);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Light.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Picks the few lights that matter most to each object being drawn, so that fragment
+	/// shaders only loop over a short per-object list instead of every light in the scene.
+	///
+	/// Each light is turned into a sphere where its attenuated contribution is above a cutoff,
+	/// and those spheres are binned into a sparse uniform grid. Queries only test the lights
+	/// in the cells the object's bounds touch. Lights that are too large to bin usefully are
+	/// kept on a separate list that every query tests
+	/// </summary>
+	class LightCuller {
+	public:
+		// Must match MAX_OBJECT_LIGHTS in fragments/multiple_point_lights.glsl
+		static const int MAX_LIGHTS_PER_OBJECT = 8;
+
+		// Contribution below which a light is considered out of range, relative to full brightness
+		float CutoffIntensity;
+		// Size of the grid cells used to bin light volumes, in world units
+		float CellSize;
+		// Lights that would cover more than this many cells skip the grid and are always tested
+		int   MaxCellsPerLight;
+
+		LightCuller();
+
+		/// <summary>
+		/// Rebuilds the spatial grid from the given lights, and resets the query statistics. Should
+		/// be called once per frame, before any queries are made
+		/// </summary>
+		/// <param name="lights">The lights in the scene, indices into this list are returned by Select</param>
+		/// <param name="maxLights">Lights past this index are ignored (ex: because they don't fit in the UBO)</param>
+		void Build(const std::vector<Light>& lights, int maxLights);
+
+		/// <summary>
+		/// Selects the lights with the highest estimated contribution to the given bounding sphere
+		/// </summary>
+		/// <param name="center">The center of the object's bounds in world space</param>
+		/// <param name="radius">The radius of the object's bounds in world units</param>
+		/// <param name="outIndices">Receives up to MAX_LIGHTS_PER_OBJECT light indices, most influential first</param>
+		/// <returns>The number of lights that were selected</returns>
+		int Select(const glm::vec3& center, float radius, int* outIndices) const;
+
+		/// <summary>
+		/// Gets the distance from a light beyond which its contribution drops under CutoffIntensity
+		/// </summary>
+		float GetInfluenceRadius(const Light& light) const;
+
+		void RenderImGui();
+
+	private:
+		struct LightVolume {
+			glm::vec3 Position;
+			float     Radius;
+			float     Intensity;
+			float     Attenuation;
+		};
+
+		std::vector<LightVolume> _volumes;
+		// Sparse grid of light indices, keyed by packed cell coordinates
+		std::unordered_map<uint64_t, std::vector<int>> _cells;
+		// Lights that are tested by every query
+		std::vector<int> _globalLights;
+
+		// Used to avoid testing the same light twice when it spans several of the cells a query touches
+		mutable std::vector<uint32_t> _visitedStamps;
+		mutable uint32_t              _currentStamp;
+
+		// Statistics for the current frame
+		mutable int _queries;
+		mutable int _candidatesTested;
+		mutable int _lightsSelected;
+		mutable int _maxSelected;
+
+		glm::ivec3 _CellAt(const glm::vec3& position) const;
+		static uint64_t _PackCell(const glm::ivec3& cell);
+	};
+}
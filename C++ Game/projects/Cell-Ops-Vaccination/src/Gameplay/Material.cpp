@@ -10,14 +10,20 @@ namespace Gameplay {
 
 	Material::Material(const ShaderProgram::Sptr& shader) :
 		IResource(),
+		IsTransparent(false),
+		IsDeferred(false),
 		_shader(shader),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(std::unordered_map<std::string, UniformData>()),
+		_samplers(std::unordered_map<std::string, SamplerDescription>())
 	{ }
 
 	Material::Material() :
 		IResource(),
+		IsTransparent(false),
+		IsDeferred(false),
 		_shader(nullptr),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(std::unordered_map<std::string, UniformData>()),
+		_samplers(std::unordered_map<std::string, SamplerDescription>())
 	{ }
 
 	void Material::Set(const std::string& name, ShaderDataType type, const void* value, size_t arraySize)
@@ -51,6 +57,18 @@ namespace Gameplay {
 		else {
 			LOG_WARN("Failed to set parameter \"{}\" in material \"{}\", shader uniform not found", name, Name);
 		}
+		MarkDirty();
+	}
+
+	void Material::SetSampler(const std::string& name, const SamplerDescription& sampler) {
+		_samplers[name] = sampler;
+		MarkDirty();
+	}
+
+	void Material::ClearSampler(const std::string& name) {
+		if (_samplers.erase(name) > 0) {
+			MarkDirty();
+		}
 	}
 
 	const ShaderProgram::Sptr& Material::GetShader() const {
@@ -72,7 +90,17 @@ namespace Gameplay {
 				if (typeCode == ShaderDataTypecode::Texture) {
 					ITexture::Sptr texture = data.TextureAsset;
 					if (texture != nullptr) {
-						texture->Bind(textureSlot);
+						// Samplers come from the material's override if it has one, otherwise from the
+						// texture's own settings so that the global quality settings still apply
+						auto sampler = _samplers.find(name);
+						SamplerDescription textureSampler;
+						if (sampler != _samplers.end()) {
+							texture->Bind(textureSlot, sampler->second);
+						} else if (texture->GetSamplerDescription(&textureSampler)) {
+							texture->Bind(textureSlot, textureSampler);
+						} else {
+							texture->Bind(textureSlot);
+						}
 					} else {
 						ITexture::Unbind(textureSlot);
 					}
@@ -88,10 +116,22 @@ namespace Gameplay {
 		}
 	}
 
+	void Material::RequestScreenSize(float pixels) {
+		for (auto&[name, data] : _uniforms) {
+			if (data.IsTextureResource() && data.TextureAsset != nullptr) {
+				data.TextureAsset->RequestScreenSize(pixels);
+			}
+		}
+	}
+
 	void Material::RenderImGui() {
 		ImGui::PushID(this);
+		bool wasEdited = ImGuiHelper::IsAnyItemEditedThisFrame();
 
 		if (ImGui::CollapsingHeader(Name.c_str())) {
+			ImGui::Checkbox("Transparent", &IsTransparent);
+			ImGui::Checkbox("Deferred", &IsDeferred);
+
 			// Draw all of our valid uniforms
 			for (auto&[key, value] : _uniforms) {
 				if (value.Location != -2 && value.Location != -1) {
@@ -99,10 +139,44 @@ namespace Gameplay {
 				}
 			}
 
+			// Texture parameters can have their sampling overridden
+			if (ImGui::TreeNode("Samplers")) {
+				for (auto&[key, value] : _uniforms) {
+					if (value.Location < 0 || !value.IsTextureResource()) continue;
+
+					ImGui::PushID(key.c_str());
+					auto it = _samplers.find(key);
+					bool hasOverride = it != _samplers.end();
+					if (ImGui::Checkbox(key.c_str(), &hasOverride)) {
+						if (hasOverride) {
+							SamplerDescription sampler;
+							if (value.TextureAsset != nullptr) {
+								value.TextureAsset->GetSamplerDescription(&sampler);
+							}
+							_samplers[key] = sampler;
+						} else {
+							_samplers.erase(key);
+						}
+					}
+					it = _samplers.find(key);
+					if (it != _samplers.end()) {
+						ImGui::Indent();
+						it->second.RenderImGui();
+						ImGui::Unindent();
+					}
+					ImGui::PopID();
+				}
+				ImGui::TreePop();
+			}
+
 			// Slap a separator at the end 'cause why not
 			ImGui::Separator();
 		}
 
+		if (!wasEdited && ImGuiHelper::IsAnyItemEditedThisFrame()) {
+			MarkDirty();
+		}
+
 		ImGui::PopID();
 	}
 
@@ -118,6 +192,15 @@ namespace Gameplay {
 		result->OverrideGUID(Guid(data["guid"]));
 		result->Name = data["name"].get<std::string>();
 		result->_shader = ResourceManager::Get<ShaderProgram>(Guid(data["shader"]));
+		result->IsTransparent = JsonGet(data, "transparent", false);
+		result->IsDeferred = JsonGet(data, "deferred", false);
+
+		// Per-texture sampler overrides
+		if (data.contains("samplers") && data["samplers"].is_object()) {
+			for (auto& item : data["samplers"].items()) {
+				result->_samplers[item.key()] = SamplerDescription::FromJson(item.value());
+			}
+		}
 
 		// material specific parameters'
 		if (data.contains("parameters") && data["parameters"].is_object()) {
@@ -138,6 +221,8 @@ namespace Gameplay {
 			{ "guid", GetGUID().str() },
 			{ "name", Name },
 			{ "shader", _shader ? _shader->GetGUID().str() : "null" },
+			{ "transparent", IsTransparent },
+			{ "deferred", IsDeferred },
 			{ "parameters", nlohmann::json() }
 		};
 
@@ -148,6 +233,11 @@ namespace Gameplay {
 			}
 		}
 
+		// Only write samplers when we have overrides, so existing materials stay the same
+		for (auto& [key, value] : _samplers) {
+			result["samplers"][key] = value.ToJson();
+		}
+
 		return result;
 	}
 
@@ -23,6 +23,17 @@ namespace Gameplay {
 		/// A human readable name for the material
 		/// </summary>
 		std::string     Name;
+		/// <summary>
+		/// True if objects using this material are see-through, and should be drawn in the
+		/// transparent pass after all opaque objects. The shader should output through
+		/// fragments/transparency.glsl
+		/// </summary>
+		bool            IsTransparent;
+		/// <summary>
+		/// True if the material's shader outputs through fragments/surface_output.glsl, so that
+		/// it can be drawn into the G-buffer when the scene uses deferred shading
+		/// </summary>
+		bool            IsDeferred;
 
 		/// <summary>
 		/// Default constructor, to be used by Resource manager and smart pointers only
@@ -55,6 +66,19 @@ namespace Gameplay {
 		/// <param name="arraySize">The array size in the event that the value is an array</param>
 		void Set(const std::string& name, ShaderDataType type, const void* value, size_t arraySize = 1ul);
 
+		/// <summary>
+		/// Overrides how the texture in the given parameter is sampled by this material, without
+		/// changing the texture itself (ex: nearest filtering for pixel art UI)
+		/// </summary>
+		/// <param name="name">The name of the texture parameter</param>
+		/// <param name="sampler">Describes how the texture should be sampled</param>
+		void SetSampler(const std::string& name, const SamplerDescription& sampler);
+		/// <summary>
+		/// Removes a sampler override, so the texture's own sampling settings are used
+		/// </summary>
+		/// <param name="name">The name of the texture parameter</param>
+		void ClearSampler(const std::string& name);
+
 		/// <summary>
 		/// Gets the shader that this material is using
 		/// </summary>
@@ -66,6 +90,13 @@ namespace Gameplay {
 		/// </summary>
 		virtual void Apply();
 
+		/// <summary>
+		/// Tells the material's streamed textures roughly how large an object using this
+		/// material appears on screen, so they can stream in enough detail
+		/// </summary>
+		/// <param name="pixels">The approximate size of the object on screen, in pixels</param>
+		void RequestScreenSize(float pixels);
+
 		/// <summary>
 		/// Renders some UI controls for manipulating a material at runtime
 		/// </summary>
@@ -172,6 +203,10 @@ namespace Gameplay {
 		/// The uniforms that the material will be modifying
 		/// </summary>
 		std::unordered_map<std::string, UniformData> _uniforms;
+		/// <summary>
+		/// Sampler overrides for texture parameters, keyed by parameter name
+		/// </summary>
+		std::unordered_map<std::string, SamplerDescription> _samplers;
 
 		UniformData& _GetUniform(const std::string& name);
 
@@ -2,6 +2,7 @@
 #include <filesystem>
 
 #include "Utils/ObjLoader.h"
+#include "Utils/VirtualFileSystem.h"
 
 namespace Gameplay {
 	MeshResource::MeshResource() :
@@ -54,7 +55,7 @@ namespace Gameplay {
 			result->Mesh = mesh.Bake();
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
-			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
+			if (result->Filename != "null" && VirtualFileSystem::Exists(result->Filename)) {
 				#ifdef OPTIMIZED_OBJ_LOADER
 				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
 				#else
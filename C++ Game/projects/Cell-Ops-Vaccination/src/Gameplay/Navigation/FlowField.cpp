@@ -0,0 +1,143 @@
+#include "FlowField.h"
+
+#include <queue>
+#include <limits>
+#include <chrono>
+
+namespace Gameplay::Navigation {
+	namespace {
+		// Pre-computed offsets, step costs and normalized directions for all 26 neighbours of a cell
+		struct NeighbourTable {
+			glm::ivec3 Offsets[26];
+			float      Costs[26];
+			glm::vec3  Directions[26];
+
+			NeighbourTable() {
+				int ix = 0;
+				for (int z = -1; z <= 1; z++) {
+					for (int y = -1; y <= 1; y++) {
+						for (int x = -1; x <= 1; x++) {
+							if (x == 0 && y == 0 && z == 0) continue;
+							Offsets[ix] = glm::ivec3(x, y, z);
+							Costs[ix] = glm::length(glm::vec3(Offsets[ix]));
+							Directions[ix] = glm::vec3(Offsets[ix]) / Costs[ix];
+							ix++;
+						}
+					}
+				}
+			}
+		};
+
+		const NeighbourTable& Neighbours() {
+			static NeighbourTable table;
+			return table;
+		}
+
+		// Invokes callback with the index of every cell overlapping the given box
+		template <typename Func>
+		void ForEachCell(const NavGrid& grid, const NavBox& box, Func&& callback) {
+			glm::ivec3 min = grid.CellAt(box.Min);
+			glm::ivec3 max = grid.CellAt(box.Max);
+			for (int z = min.z; z <= max.z; z++) {
+				for (int y = min.y; y <= max.y; y++) {
+					for (int x = min.x; x <= max.x; x++) {
+						callback(grid.IndexOf(glm::ivec3(x, y, z)));
+					}
+				}
+			}
+		}
+	}
+
+	FlowField::Sptr FlowField::Build(const NavGrid& grid, const NavBox& goal, const std::vector<NavBox>& obstacles) {
+		auto start = std::chrono::high_resolution_clock::now();
+
+		const NeighbourTable& neighbours = Neighbours();
+		const int numCells = grid.NumCells();
+		const float INF = std::numeric_limits<float>::infinity();
+
+		FlowField::Sptr result = std::make_shared<FlowField>();
+		result->_grid = grid;
+		result->_directions.assign(numCells, NO_DIRECTION);
+		result->_isGoal.assign(numCells, false);
+
+		// Rasterize the obstacles into the grid
+		std::vector<bool> blocked(numCells, false);
+		for (const NavBox& obstacle : obstacles) {
+			ForEachCell(grid, obstacle, [&](int index) { blocked[index] = true; });
+		}
+
+		// Integration field, seeded with a cost of 0 at all goal cells
+		typedef std::pair<float, int> QueueEntry;
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+		std::vector<float> cost(numCells, INF);
+		ForEachCell(grid, goal, [&](int index) {
+			result->_isGoal[index] = true;
+			blocked[index] = false;
+			cost[index] = 0.0f;
+			open.push({ 0.0f, index });
+		});
+
+		// Dijkstra outwards from the goal, obstacles are never expanded
+		while (!open.empty()) {
+			QueueEntry entry = open.top();
+			open.pop();
+			if (entry.first > cost[entry.second]) continue;
+
+			glm::ivec3 cell(
+				entry.second % grid.Size.x,
+				(entry.second / grid.Size.x) % grid.Size.y,
+				entry.second / (grid.Size.x * grid.Size.y)
+			);
+			for (int ix = 0; ix < 26; ix++) {
+				glm::ivec3 next = cell + neighbours.Offsets[ix];
+				if (glm::any(glm::lessThan(next, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(next, grid.Size))) continue;
+
+				int nextIndex = grid.IndexOf(next);
+				if (blocked[nextIndex]) continue;
+
+				float nextCost = entry.first + neighbours.Costs[ix];
+				if (nextCost < cost[nextIndex]) {
+					cost[nextIndex] = nextCost;
+					open.push({ nextCost, nextIndex });
+				}
+			}
+		}
+
+		// Collapse the integration field into a direction per cell. Blocked cells still get a
+		// direction towards their cheapest neighbour so agents inside obstacles get pushed out
+		for (int z = 0; z < grid.Size.z; z++) {
+			for (int y = 0; y < grid.Size.y; y++) {
+				for (int x = 0; x < grid.Size.x; x++) {
+					glm::ivec3 cell(x, y, z);
+					int index = grid.IndexOf(cell);
+					if (result->_isGoal[index]) continue;
+
+					float best = blocked[index] ? INF : cost[index];
+					for (int ix = 0; ix < 26; ix++) {
+						glm::ivec3 next = cell + neighbours.Offsets[ix];
+						if (glm::any(glm::lessThan(next, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(next, grid.Size))) continue;
+
+						float nextCost = cost[grid.IndexOf(next)];
+						if (nextCost < best) {
+							best = nextCost;
+							result->_directions[index] = (uint8_t)ix;
+						}
+					}
+				}
+			}
+		}
+
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		result->_buildTimeMs = elapsed.count();
+		return result;
+	}
+
+	glm::vec3 FlowField::Sample(const glm::vec3& worldPos) const {
+		uint8_t direction = _directions[_grid.IndexOf(_grid.CellAt(worldPos))];
+		return direction == NO_DIRECTION ? glm::vec3(0.0f) : Neighbours().Directions[direction];
+	}
+
+	bool FlowField::IsAtGoal(const glm::vec3& worldPos) const {
+		return _isGoal[_grid.IndexOf(_grid.CellAt(worldPos))];
+	}
+}
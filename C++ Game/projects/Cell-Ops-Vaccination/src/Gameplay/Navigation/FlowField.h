@@ -0,0 +1,100 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Utils/Macros.h"
+
+namespace Gameplay::Navigation {
+	/// <summary>
+	/// Describes the uniform 3D grid that flow fields are built over
+	/// </summary>
+	struct NavGrid {
+		// The world space position of the minimum corner of the grid
+		glm::vec3  Origin   = glm::vec3(-80.0f, -80.0f, -80.0f);
+		// The size of a single cell along each axis, in world units
+		float      CellSize = 5.0f;
+		// The number of cells along each axis
+		glm::ivec3 Size     = glm::ivec3(32, 32, 44);
+
+		int NumCells() const { return Size.x * Size.y * Size.z; }
+
+		/// <summary>
+		/// Gets the cell coordinates containing the given world position, clamped to the grid
+		/// </summary>
+		glm::ivec3 CellAt(const glm::vec3& worldPos) const {
+			return glm::clamp(glm::ivec3(glm::floor((worldPos - Origin) / CellSize)), glm::ivec3(0), Size - 1);
+		}
+		/// <summary>
+		/// Gets the linear index of the given cell coordinates
+		/// </summary>
+		int IndexOf(const glm::ivec3& cell) const {
+			return cell.x + Size.x * (cell.y + Size.y * cell.z);
+		}
+
+		bool operator ==(const NavGrid& other) const {
+			return Origin == other.Origin && CellSize == other.CellSize && Size == other.Size;
+		}
+	};
+
+	/// <summary>
+	/// Simple world-space axis aligned box, used to describe goals and obstacles
+	/// </summary>
+	struct NavBox {
+		glm::vec3 Min;
+		glm::vec3 Max;
+
+		bool operator ==(const NavBox& other) const { return Min == other.Min && Max == other.Max; }
+		bool operator !=(const NavBox& other) const { return !(*this == other); }
+	};
+
+	/// <summary>
+	/// A flow field stores, for every cell in a NavGrid, which neighbouring cell an agent should
+	/// move to next to reach a goal along the cheapest path around obstacles. Building runs a
+	/// Dijkstra pass from the goal to get the integration (cost-to-goal) field, then collapses
+	/// that into one direction per cell, so sampling is a single lookup regardless of agent count
+	///
+	/// Fields are immutable once built, so they can be built on a worker thread and shared freely
+	/// </summary>
+	class FlowField {
+	public:
+		MAKE_PTRS(FlowField);
+
+		// Direction index used for cells that are part of the goal, or can't reach it
+		static const uint8_t NO_DIRECTION = 0xFF;
+
+		/// <summary>
+		/// Builds a new flow field towards the given goal
+		/// </summary>
+		/// <param name="grid">The grid to build over</param>
+		/// <param name="goal">The world space bounds of the goal, all cells touching it are goal cells</param>
+		/// <param name="obstacles">World space bounds of any obstacles to path around</param>
+		static FlowField::Sptr Build(const NavGrid& grid, const NavBox& goal, const std::vector<NavBox>& obstacles);
+
+		/// <summary>
+		/// Gets the normalized direction an agent at the given world position should move in,
+		/// or a zero vector if the agent has reached the goal (or the goal is unreachable)
+		/// </summary>
+		glm::vec3 Sample(const glm::vec3& worldPos) const;
+
+		/// <summary>
+		/// Returns true if the given world position lies within one of the goal cells
+		/// </summary>
+		bool IsAtGoal(const glm::vec3& worldPos) const;
+
+		const NavGrid& GetGrid() const { return _grid; }
+		/// <summary>
+		/// Gets how long the field took to build, in milliseconds
+		/// </summary>
+		float GetBuildTimeMs() const { return _buildTimeMs; }
+
+		FlowField() = default;
+
+	private:
+		NavGrid              _grid;
+		// One entry per cell, indexing into the neighbour direction table
+		std::vector<uint8_t> _directions;
+		std::vector<bool>    _isGoal;
+		float                _buildTimeMs = 0.0f;
+	};
+}
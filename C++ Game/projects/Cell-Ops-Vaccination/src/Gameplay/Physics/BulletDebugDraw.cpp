@@ -1,21 +1,71 @@
 #pragma once
 #include "Gameplay/Physics/BulletDebugDraw.h"
 
+#include <algorithm>
 #include <Logging.h>
+#include <btBulletDynamicsCommon.h>
+#include <GLM/gtc/matrix_transform.hpp>
+#include <GLM/gtc/type_ptr.hpp>
 
 #include "Graphics/DebugDraw.h"
+#include "Utils/Frustum.h"
 #include "Utils/GlmBulletConversions.h"
 #include "Utils/ImGuiHelper.h"
 
-BulletDebugDraw::BulletDebugDraw() {
+namespace {
+	// Wireframes for shapes that haven't been drawn in this many frames are deleted, the shape was most likely deleted too
+	const uint64_t MESH_EVICT_FRAMES = 300;
+
+	glm::vec4 ToColor(const btVector3& color) {
+		return glm::vec4(color.x(), color.y(), color.z(), 1.0f);
+	}
+}
+
+BulletDebugDraw::BulletDebugDraw() :
+	m_debugMode(0),
+	MaxDistance(50.0f),
+	CullToFrustum(true),
+	_unitBox(nullptr),
+	_unitSphere(nullptr),
+	_unitCylinder(nullptr),
+	_unitCone(nullptr),
+	_meshes(),
+	_shader(nullptr),
+	_frame(0),
+	_capture(nullptr),
+	_drawn(),
+	_drawnObjects(0),
+	_drawnInstances(0),
+	_drawCalls(0),
+	_drawnContacts(0)
+{
+	// Margins are included in the scale of each instance, so the unit shapes shouldn't have any
+	_unitBox = new btBoxShape(btVector3(1.0f, 1.0f, 1.0f));
+	_unitBox->setMargin(0.0f);
+	_unitSphere = new btSphereShape(1.0f);
+	_unitCylinder = new btCylinderShapeZ(btVector3(1.0f, 1.0f, 1.0f));
+	_unitCylinder->setMargin(0.0f);
+	_unitCone = new btConeShapeZ(1.0f, 1.0f);
+}
+
+BulletDebugDraw::~BulletDebugDraw() {
+	delete _unitBox;
+	delete _unitSphere;
+	delete _unitCylinder;
+	delete _unitCone;
 }
 
 void BulletDebugDraw::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
-	DebugDrawer::Get().DrawLine(ToGlm(from), ToGlm(to), ToGlm(color));
+	drawLine(from, to, color, color);
 }
 
 void BulletDebugDraw::drawLine(const btVector3& from, const btVector3& to, const btVector3& fromColor, const btVector3& toColor)
 {
+	if (_capture != nullptr) {
+		_capture->push_back(VertexPosCol(from.x(), from.y(), from.z(), 1.0f, 1.0f, 1.0f, 1.0f));
+		_capture->push_back(VertexPosCol(to.x(), to.y(), to.z(), 1.0f, 1.0f, 1.0f, 1.0f));
+		return;
+	}
 	DebugDrawer::Get().DrawLine(ToGlm(from), ToGlm(to), ToGlm(fromColor), ToGlm(toColor));
 }
 
@@ -61,3 +111,289 @@ bool BulletDebugDraw::DrawModeGui(const char* label, BulletDebugMode& mode)
 	}
 	return result;
 }
+
+void BulletDebugDraw::DrawWorld(btCollisionWorld* world, const glm::mat4& viewProjection, const glm::vec3& cameraPos, const btCollisionObject* const* alwaysDraw, size_t alwaysDrawCount) {
+	LOG_ASSERT(world->getDebugDrawer() == this, "The world must be using this debug drawer");
+
+	_frame++;
+	_drawn.clear();
+	_drawnInstances = 0;
+	_drawCalls = 0;
+	_drawnContacts = 0;
+
+	Frustum frustum(viewProjection);
+	DefaultColors colors = getDefaultColors();
+	float maxDistanceSq = MaxDistance * MaxDistance;
+
+	const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	for (int ix = 0; ix < objects.size(); ix++) {
+		const btCollisionObject* object = objects[ix];
+		if (object->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT) {
+			continue;
+		}
+
+		// The broadphase already knows the bounds of most objects
+		btVector3 aabbMin, aabbMax;
+		const btBroadphaseProxy* proxy = object->getBroadphaseHandle();
+		if (proxy != nullptr) {
+			aabbMin = proxy->m_aabbMin;
+			aabbMax = proxy->m_aabbMax;
+		} else {
+			object->getCollisionShape()->getAabb(object->getWorldTransform(), aabbMin, aabbMax);
+		}
+		glm::vec3 min = ToGlm(aabbMin);
+		glm::vec3 max = ToGlm(aabbMax);
+
+		bool isSelected = std::find(alwaysDraw, alwaysDraw + alwaysDrawCount, object) != alwaysDraw + alwaysDrawCount;
+		if (!isSelected) {
+			if (MaxDistance > 0.0f) {
+				glm::vec3 offset = glm::clamp(cameraPos, min, max) - cameraPos;
+				if (glm::dot(offset, offset) > maxDistanceSq) {
+					continue;
+				}
+			}
+			if (CullToFrustum && !frustum.IntersectsAABB(min, max)) {
+				continue;
+			}
+		}
+		_drawn.push_back(object);
+
+		if (m_debugMode & DBG_DrawWireframe) {
+			// Same colors that bullet uses, so that sleeping objects stand out
+			btVector3 color;
+			if (isSelected) {
+				color = btVector3(1.0f, 0.6f, 0.0f);
+			} else {
+				switch (object->getActivationState()) {
+					case ACTIVE_TAG:           color = colors.m_activeObject; break;
+					case ISLAND_SLEEPING:      color = colors.m_deactivatedObject; break;
+					case WANTS_DEACTIVATION:   color = colors.m_wantsDeactivationObject; break;
+					case DISABLE_DEACTIVATION: color = colors.m_disabledDeactivationObject; break;
+					case DISABLE_SIMULATION:   color = colors.m_disabledSimulationObject; break;
+					default:                   color = btVector3(1.0f, 0.0f, 0.0f); break;
+				}
+			}
+			_AddShape(world, object->getWorldTransform(), object->getCollisionShape(), ToColor(color));
+		}
+
+		if (m_debugMode & DBG_DrawAabb) {
+			drawAabb(aabbMin, aabbMax, colors.m_aabb);
+		}
+	}
+	_drawnObjects = (uint32_t)_drawn.size();
+	std::sort(_drawn.begin(), _drawn.end());
+
+	_FlushInstances();
+
+	if (m_debugMode & DBG_DrawContactPoints) {
+		_DrawContacts(world);
+	}
+	if (m_debugMode & (DBG_DrawConstraints | DBG_DrawConstraintLimits)) {
+		_DrawConstraints(world);
+	}
+
+	for (auto it = _meshes.begin(); it != _meshes.end(); ) {
+		if (it->second.LastUsedFrame + MESH_EVICT_FRAMES < _frame) {
+			it = _meshes.erase(it);
+		} else {
+			it++;
+		}
+	}
+}
+
+void BulletDebugDraw::RenderFilterImGui() {
+	LABEL_LEFT(ImGui::DragFloat, "Max Distance", &MaxDistance, 0.5f, 0.0f, 10000.0f);
+	ImGui::Checkbox("Cull to View", &CullToFrustum);
+	ImGui::Text("Drawn: %u objects, %u shapes in %u draws", _drawnObjects, _drawnInstances, _drawCalls);
+	ImGui::Text("Contacts: %u, cached wireframes: %u", _drawnContacts, (uint32_t)_meshes.size());
+}
+
+void BulletDebugDraw::_AddShape(btCollisionWorld* world, const btTransform& transform, const btCollisionShape* shape, const glm::vec4& color) {
+	if (shape->isCompound()) {
+		const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+		for (int ix = 0; ix < compound->getNumChildShapes(); ix++) {
+			_AddShape(world, transform * compound->getChildTransform(ix), compound->getChildShape(ix), color);
+		}
+		return;
+	}
+
+	// Primitives along the Z axis share a unit sized wireframe that gets scaled to fit, anything
+	// else gets a wireframe of it's own
+	const btCollisionShape* key = shape;
+	glm::vec3 scale = glm::vec3(1.0f);
+	switch (shape->getShapeType()) {
+		case BOX_SHAPE_PROXYTYPE:
+			key = _unitBox;
+			scale = ToGlm(static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin());
+			break;
+		case SPHERE_SHAPE_PROXYTYPE:
+			key = _unitSphere;
+			scale = glm::vec3(static_cast<const btSphereShape*>(shape)->getRadius());
+			break;
+		case CYLINDER_SHAPE_PROXYTYPE:
+			if (static_cast<const btCylinderShape*>(shape)->getUpAxis() == 2) {
+				key = _unitCylinder;
+				scale = ToGlm(static_cast<const btCylinderShape*>(shape)->getHalfExtentsWithMargin());
+			}
+			break;
+		case CONE_SHAPE_PROXYTYPE: {
+			const btConeShape* cone = static_cast<const btConeShape*>(shape);
+			if (cone->getConeUpIndex() == 2) {
+				key = _unitCone;
+				scale = glm::vec3(cone->getRadius(), cone->getRadius(), cone->getHeight());
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	btScalar matrix[16];
+	transform.getOpenGLMatrix(matrix);
+	_GetMesh(world, key).Pending.push_back(InstanceData{ glm::scale(glm::make_mat4(matrix), scale), color });
+}
+
+BulletDebugDraw::ShapeMesh& BulletDebugDraw::_GetMesh(btCollisionWorld* world, const btCollisionShape* shape) {
+	btTransform identity;
+	identity.setIdentity();
+	btVector3 aabbMin, aabbMax;
+	shape->getAabb(identity, aabbMin, aabbMax);
+
+	ShapeMesh& mesh = _meshes[shape];
+	mesh.LastUsedFrame = _frame;
+	if (mesh.Vao != nullptr && mesh.LocalMin == ToGlm(aabbMin) && mesh.LocalMax == ToGlm(aabbMax)) {
+		return mesh;
+	}
+
+	// Have bullet draw the shape once in it's local space, and capture the lines
+	std::vector<VertexPosCol> lines;
+	int mode = m_debugMode;
+	m_debugMode = DBG_DrawWireframe;
+	_capture = &lines;
+	world->debugDrawObject(identity, shape, btVector3(1.0f, 1.0f, 1.0f));
+	_capture = nullptr;
+	m_debugMode = mode;
+
+	mesh.Lines = VertexBuffer::Create();
+	mesh.Lines->LoadData(lines.data(), (uint32_t)lines.size());
+	// The VAO complains about buffers with different element counts, so we start the instance
+	// buffer out the same size as the vertex buffer
+	mesh.Instances = VertexBuffer::Create(BufferUsage::DynamicDraw);
+	mesh.Instances->LoadData<InstanceData>(nullptr, (uint32_t)lines.size());
+
+	const std::vector<BufferAttribute> instanceAttributes = {
+		BufferAttribute(8,  4, AttributeType::Float, sizeof(InstanceData), 0, AttribUsage::User0),
+		BufferAttribute(9,  4, AttributeType::Float, sizeof(InstanceData), 4 * sizeof(float), AttribUsage::User0),
+		BufferAttribute(10, 4, AttributeType::Float, sizeof(InstanceData), 8 * sizeof(float), AttribUsage::User0),
+		BufferAttribute(11, 4, AttributeType::Float, sizeof(InstanceData), 12 * sizeof(float), AttribUsage::User0),
+		BufferAttribute(12, 4, AttributeType::Float, sizeof(InstanceData), 16 * sizeof(float), AttribUsage::User1),
+	};
+	mesh.Vao = VertexArrayObject::Create();
+	mesh.Vao->AddVertexBuffer(mesh.Lines, VertexPosCol::V_DECL);
+	mesh.Vao->AddVertexBuffer(mesh.Instances, instanceAttributes, true);
+
+	mesh.LocalMin = ToGlm(aabbMin);
+	mesh.LocalMax = ToGlm(aabbMax);
+	return mesh;
+}
+
+void BulletDebugDraw::_FlushInstances() {
+	if (_shader == nullptr) {
+		const char* vs_source = R"LIT(#version 450
+				layout (location = 0) in vec3 inPosition;
+				layout (location = 1) in vec4 inColor;
+				layout (location = 8) in mat4 inTransform;
+				layout (location = 12) in vec4 inInstanceColor;
+
+				layout (location = 0) out vec4 outColor;
+
+				layout (location = 0) uniform mat4 u_ViewProjection;
+
+				void main() {
+					gl_Position = u_ViewProjection * inTransform * vec4(inPosition, 1.0);
+					outColor = inColor * inInstanceColor;
+				}
+			)LIT";
+		const char* fs_source = R"LIT(#version 450
+				layout (location=0) in  vec4 inColor;
+				layout (location=0) out vec4 outColor;
+
+				void main() {
+					outColor = inColor;
+				}
+			)LIT";
+
+		_shader = ShaderProgram::Create();
+		_shader->LoadShaderPart(vs_source, ShaderPartType::Vertex);
+		_shader->LoadShaderPart(fs_source, ShaderPartType::Fragment);
+		_shader->Link();
+	}
+
+	// Use the same matrix as the debug drawer, so that our lines line up with it's lines
+	glm::mat4 viewProjection = DebugDrawer::Get().GetViewProjection();
+	_shader->Bind();
+	_shader->SetUniformMatrix(0, &viewProjection);
+
+	int restorePoint = 0;
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
+	VertexArrayObject::Unbind();
+	for (auto& [shape, mesh] : _meshes) {
+		if (mesh.Pending.empty()) {
+			continue;
+		}
+		mesh.Instances->LoadData(mesh.Pending.data(), (uint32_t)mesh.Pending.size());
+		mesh.Vao->DrawInstanced((uint32_t)mesh.Pending.size(), DrawMode::LineList);
+		_drawnInstances += (uint32_t)mesh.Pending.size();
+		_drawCalls++;
+		mesh.Pending.clear();
+	}
+	if (restorePoint != 0) {
+		glBindVertexArray(restorePoint);
+	}
+}
+
+void BulletDebugDraw::_DrawContacts(btCollisionWorld* world) {
+	// Rather than a line for every contact point, each touching pair gets a single line from
+	// the middle of it's contacts along their average normal, longer for pairs with more contacts
+	DefaultColors colors = getDefaultColors();
+	btDispatcher* dispatcher = world->getDispatcher();
+	for (int ix = 0; ix < dispatcher->getNumManifolds(); ix++) {
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+		int count = manifold->getNumContacts();
+		if (count == 0 || (!_WasDrawn(manifold->getBody0()) && !_WasDrawn(manifold->getBody1()))) {
+			continue;
+		}
+
+		btVector3 position(0.0f, 0.0f, 0.0f);
+		btVector3 normal(0.0f, 0.0f, 0.0f);
+		for (int point = 0; point < count; point++) {
+			const btManifoldPoint& contact = manifold->getContactPoint(point);
+			position += contact.getPositionWorldOnB();
+			normal += contact.m_normalWorldOnB;
+		}
+		position /= (btScalar)count;
+		if (normal.length2() > SIMD_EPSILON) {
+			normal.normalize();
+		}
+
+		drawLine(position, position + normal * (0.25f + 0.1f * count), colors.m_contactPoint);
+		_drawnContacts += (uint32_t)count;
+	}
+}
+
+void BulletDebugDraw::_DrawConstraints(btCollisionWorld* world) {
+	btDiscreteDynamicsWorld* dynamicsWorld = dynamic_cast<btDiscreteDynamicsWorld*>(world);
+	if (dynamicsWorld == nullptr) {
+		return;
+	}
+	for (int ix = 0; ix < dynamicsWorld->getNumConstraints(); ix++) {
+		btTypedConstraint* constraint = dynamicsWorld->getConstraint(ix);
+		if (_WasDrawn(&constraint->getRigidBodyA()) || _WasDrawn(&constraint->getRigidBodyB())) {
+			dynamicsWorld->debugDrawConstraint(constraint);
+		}
+	}
+}
+
+bool BulletDebugDraw::_WasDrawn(const btCollisionObject* object) const {
+	return std::binary_search(_drawn.begin(), _drawn.end(), object);
+}
@@ -1,6 +1,22 @@
 #pragma once
 #include "LinearMath/btIDebugDraw.h"
 #include <EnumToString.h>
+#include <vector>
+#include <unordered_map>
+#include <GLM/glm.hpp>
+
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/ShaderProgram.h"
+#include "Graphics/VertexTypes.h"
+
+class btCollisionWorld;
+class btCollisionObject;
+class btCollisionShape;
+class btTransform;
+class btBoxShape;
+class btSphereShape;
+class btCylinderShape;
+class btConeShape;
 
 /// <summary>
 /// Represents the options for debug drawing with bullet
@@ -28,6 +44,12 @@ ENUM(BulletDebugMode, int,
 /// <summary>
 /// Implements the btIDebugDraw interface, allowing us to draw physics debug UI
 /// for our scenes
+///
+/// Rather than having bullet draw the whole world one line at a time, DrawWorld only draws
+/// objects near the camera, inside its view or selected in the editor. The wireframe for each
+/// kind of shape is built once and drawn with instancing, boxes, spheres, cylinders and cones
+/// share a unit sized wireframe that gets scaled to fit each shape. Contacts are drawn as one
+/// averaged line per pair of touching objects
 /// </summary>
 class BulletDebugDraw : public btIDebugDraw
 {
@@ -35,7 +57,28 @@ private:
 	int m_debugMode;
 
 public:
+	// Only objects within this distance of the camera are drawn, or 0 to ignore distance
+	float MaxDistance;
+	// Only objects inside the camera's view are drawn
+	bool  CullToFrustum;
+
 	BulletDebugDraw();
+	virtual ~BulletDebugDraw();
+
+	/// <summary>
+	/// Draws the objects in the world that pass the distance and frustum filters
+	/// </summary>
+	/// <param name="world">The world to draw</param>
+	/// <param name="viewProjection">The camera's view projection, used for culling</param>
+	/// <param name="cameraPos">The camera's position, used for the distance filter</param>
+	/// <param name="alwaysDraw">Objects that are drawn no matter where they are, ex: the selected object</param>
+	/// <param name="alwaysDrawCount">The number of objects in alwaysDraw</param>
+	void DrawWorld(btCollisionWorld* world, const glm::mat4& viewProjection, const glm::vec3& cameraPos, const btCollisionObject* const* alwaysDraw, size_t alwaysDrawCount);
+
+	/// <summary>
+	/// Renders ImGui controls for the filters, and stats from the last draw
+	/// </summary>
+	void RenderFilterImGui();
 
 	// Inherited from btIDebugDraw
 
@@ -48,4 +91,51 @@ public:
 	virtual int getDebugMode() const { return m_debugMode; }
 
 	static bool DrawModeGui(const char* label, BulletDebugMode& mode);
+
+private:
+	struct InstanceData {
+		glm::mat4 Transform;
+		glm::vec4 Color;
+	};
+
+	// A wireframe in the shape's local space, along with the instances to draw this frame
+	struct ShapeMesh {
+		VertexBuffer::Sptr        Lines;
+		VertexBuffer::Sptr        Instances;
+		VertexArrayObject::Sptr   Vao;
+		std::vector<InstanceData> Pending;
+		// Used to tell if a shape was changed after it's wireframe was built
+		glm::vec3                 LocalMin;
+		glm::vec3                 LocalMax;
+		uint64_t                  LastUsedFrame;
+	};
+
+	// Unit sized shapes, used as the keys for the shared wireframes
+	btBoxShape*      _unitBox;
+	btSphereShape*   _unitSphere;
+	btCylinderShape* _unitCylinder;
+	btConeShape*     _unitCone;
+
+	// Wireframes keyed by one of the unit shapes above, or by the shape itself for other shapes
+	std::unordered_map<const btCollisionShape*, ShapeMesh> _meshes;
+	ShaderProgram::Sptr _shader;
+	uint64_t            _frame;
+
+	// While building a wireframe, lines are sent here instead of to the DebugDrawer
+	std::vector<VertexPosCol>* _capture;
+	// Objects drawn this frame, sorted so that contacts can look them up
+	std::vector<const btCollisionObject*> _drawn;
+
+	// Stats from the last draw
+	uint32_t _drawnObjects;
+	uint32_t _drawnInstances;
+	uint32_t _drawCalls;
+	uint32_t _drawnContacts;
+
+	void _AddShape(btCollisionWorld* world, const btTransform& transform, const btCollisionShape* shape, const glm::vec4& color);
+	ShapeMesh& _GetMesh(btCollisionWorld* world, const btCollisionShape* shape);
+	void _DrawContacts(btCollisionWorld* world);
+	void _DrawConstraints(btCollisionWorld* world);
+	void _FlushInstances();
+	bool _WasDrawn(const btCollisionObject* object) const;
 };
\ No newline at end of file
@@ -21,6 +21,14 @@ namespace Gameplay::Physics {
 		return new btBoxShape(btVector3(_extents.x, _extents.y, _extents.z));
 	}
 
+	bool BoxCollider::UpdateShape(btCollisionShape* shape) const {
+		// Boxes store their scaled extents without the margin, same as what the constructor does
+		btBoxShape* box = static_cast<btBoxShape*>(shape);
+		btVector3 margin(box->getMargin(), box->getMargin(), box->getMargin());
+		box->setImplicitShapeDimensions(btVector3(_extents.x, _extents.y, _extents.z) * box->getLocalScaling() - margin);
+		return true;
+	}
+
 	void BoxCollider::FromJson(const nlohmann::json& data) {
 		_extents = data["extents"];
 	}
@@ -37,5 +37,6 @@ namespace Gameplay::Physics {
 		glm::vec3 _extents;
 
 		virtual btCollisionShape* CreateShape() const override;
+		virtual bool UpdateShape(btCollisionShape* shape) const override;
 	};
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Gameplay/Components/RenderComponent.h"
 
 #include "Utils/GlmBulletConversions.h"
+#include "Graphics/GpuReadback.h"
 
 namespace Gameplay::Physics {
 	ConvexMeshCollider::Sptr ConvexMeshCollider::Create() {
@@ -16,7 +17,8 @@ namespace Gameplay::Physics {
 
 	ConvexMeshCollider::ConvexMeshCollider() :
 		ICollider(ColliderType::ConvexMesh),
-		_triMesh(nullptr)
+		_triMesh(nullptr),
+		_selfRef(std::make_shared<ConvexMeshCollider*>(this))
 	{ }
 
 	btCollisionShape* ConvexMeshCollider::CreateShape() const {
@@ -92,74 +94,89 @@ namespace Gameplay::Physics {
 				IndexBuffer::Sptr indexBuff = vao->GetIndexBuffer();
 				VertexBuffer::Sptr vertexBuff = vertBuff->GetBuffer();
 
-				// Create the bullet physics triangle mesh
-				_triMesh = new btTriangleMesh();
-
-				// Helper for extracting an int from a raw index buffer datastore
-				auto getBufferIndex = [](IndexBuffer::Sptr buff, uint8_t* dataStore, int offset) {
-					switch (buff->GetElementType())
-					{
-					case IndexType::UByte:
-						return (int)*(dataStore + offset);
-					case IndexType::UShort:
-						return (int)*(reinterpret_cast<uint16_t*>(dataStore) + offset);
-					case IndexType::UInt:
-						return (int)*(reinterpret_cast<uint32_t*>(dataStore) + offset);
-					case IndexType::Unknown:
-					default:
-						return 0;
+				// Reading the buffers back from the GPU takes a few frames, so we build the mesh
+				// once both have arrived and mark ourselves dirty so the body picks up the new shape
+				std::weak_ptr<ConvexMeshCollider*> selfRef = _selfRef;
+				std::shared_ptr<std::vector<uint8_t>> vertexStore = std::make_shared<std::vector<uint8_t>>();
+				auto onDataReady = [selfRef, mesh, vertexStore, vertexBuff, indexBuff, posAttrib](const uint8_t* indexStore) {
+					// Another collider may have built the mesh while we were waiting
+					if (mesh->BulletTriMesh == nullptr) {
+						mesh->BulletTriMesh = std::shared_ptr<btTriangleMesh>(_BuildTriMesh(vertexStore->data(), vertexBuff->GetElementCount(), posAttrib, indexBuff, indexStore));
 					}
-				};
-
-				// Allocate some space to read data from OpenGL and read our buffer data back into CPU memory
-				uint8_t* vertexStore = reinterpret_cast<uint8_t*>(malloc(vertexBuff->GetTotalSize()));
-				glGetNamedBufferSubData(vertexBuff->GetHandle(), 0, vertexBuff->GetTotalSize(), vertexStore);
-				_triMesh->preallocateVertices(vao->GetVertexCount());
-
-				// If our data is indexed, we use the index buffer to add our triangles
-				if (indexBuff != nullptr) {
-					// Allocate and read space for the indices
-					uint8_t* indexStore = reinterpret_cast<uint8_t*>(malloc(indexBuff->GetTotalSize()));
-					glGetNamedBufferSubData(indexBuff->GetHandle(), 0, indexBuff->GetTotalSize(), indexStore);
-
-					// Iterate over index triangles
-					for (size_t ix = 0; ix < indexBuff->GetElementCount(); ix += 3) {
-						// Extract index from the raw data
-						int i1 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix));
-						int i2 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix + 1));
-						int i3 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix + 2));
-
-						// Find the positions for the indices
-						glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + (posAttrib.Stride * i1) + posAttrib.Offset);
-						glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + (posAttrib.Stride * i2) + posAttrib.Offset);
-						glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + (posAttrib.Stride * i3) + posAttrib.Offset);
-
-						// Add the triangle
-						_triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
+					std::shared_ptr<ConvexMeshCollider*> self = selfRef.lock();
+					if (self != nullptr) {
+						(*self)->_triMesh = mesh->BulletTriMesh.get();
+						(*self)->_isDirty = true;
 					}
+				};
 
-					// Free the data we copied the indices into
-					free(indexStore);
-
-				}
-				// We only have vertex data, create triangles sequentially
-				else {
-					// Iterate over triangles, and add each to the mesh
-					for (size_t ix = 0; ix < vertexBuff->GetElementCount(); ix += 3) {
-						glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 0) * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 1) * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 2) * posAttrib.Stride) + posAttrib.Offset);
-						_triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
+				GpuReadback::ReadBuffer(vertexBuff->GetHandle(), 0, vertexBuff->GetTotalSize(), [vertexStore, indexBuff, onDataReady](const void* data, size_t size) {
+					vertexStore->assign(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + size);
+					if (indexBuff == nullptr) {
+						onDataReady(nullptr);
 					}
+				});
+				// Reads are delivered in order, so the vertices will always be ready by the time the indices are
+				if (indexBuff != nullptr) {
+					GpuReadback::ReadBuffer(indexBuff->GetHandle(), 0, indexBuff->GetTotalSize(), [onDataReady](const void* data, size_t) {
+						onDataReady(reinterpret_cast<const uint8_t*>(data));
+					});
 				}
+			}
+		}
+	}
 
-				// free our vertex store data
-				free(vertexStore);
-
-				// Store the bullet tri mesh in the MeshResource in case we want it later
-				mesh->BulletTriMesh = std::shared_ptr<btTriangleMesh>(_triMesh);
+	btTriangleMesh* ConvexMeshCollider::_BuildTriMesh(const uint8_t* vertexStore, uint32_t vertexCount, const BufferAttribute& posAttrib, const IndexBuffer::Sptr& indexBuff, const uint8_t* indexStore) {
+		// Helper for extracting an int from a raw index buffer datastore
+		auto getBufferIndex = [](const IndexBuffer::Sptr& buff, const uint8_t* dataStore, int offset) {
+			switch (buff->GetElementType())
+			{
+			case IndexType::UByte:
+				return (int)*(dataStore + offset);
+			case IndexType::UShort:
+				return (int)*(reinterpret_cast<const uint16_t*>(dataStore) + offset);
+			case IndexType::UInt:
+				return (int)*(reinterpret_cast<const uint32_t*>(dataStore) + offset);
+			case IndexType::Unknown:
+			default:
+				return 0;
+			}
+		};
+
+		// Create the bullet physics triangle mesh
+		btTriangleMesh* result = new btTriangleMesh();
+		result->preallocateVertices(vertexCount);
+
+		// If our data is indexed, we use the index buffer to add our triangles
+		if (indexBuff != nullptr) {
+			// Iterate over index triangles
+			for (size_t ix = 0; ix < indexBuff->GetElementCount(); ix += 3) {
+				// Extract index from the raw data
+				int i1 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix));
+				int i2 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix + 1));
+				int i3 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix + 2));
+
+				// Find the positions for the indices
+				glm::vec3 p1 = *reinterpret_cast<const glm::vec3*>(vertexStore + (posAttrib.Stride * i1) + posAttrib.Offset);
+				glm::vec3 p2 = *reinterpret_cast<const glm::vec3*>(vertexStore + (posAttrib.Stride * i2) + posAttrib.Offset);
+				glm::vec3 p3 = *reinterpret_cast<const glm::vec3*>(vertexStore + (posAttrib.Stride * i3) + posAttrib.Offset);
+
+				// Add the triangle
+				result->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
 			}
 		}
+		// We only have vertex data, create triangles sequentially
+		else {
+			// Iterate over triangles, and add each to the mesh
+			for (size_t ix = 0; ix + 2 < vertexCount; ix += 3) {
+				glm::vec3 p1 = *reinterpret_cast<const glm::vec3*>(vertexStore + ((ix + 0) * posAttrib.Stride) + posAttrib.Offset);
+				glm::vec3 p2 = *reinterpret_cast<const glm::vec3*>(vertexStore + ((ix + 1) * posAttrib.Stride) + posAttrib.Offset);
+				glm::vec3 p3 = *reinterpret_cast<const glm::vec3*>(vertexStore + ((ix + 2) * posAttrib.Stride) + posAttrib.Offset);
+				result->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
+			}
+		}
+
+		return result;
 	}
 
 	void ConvexMeshCollider::FromJson(const nlohmann::json& data) {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Gameplay/Physics/ICollider.h"
+#include "Graphics/Buffers/IndexBuffer.h"
+#include "Graphics/VertexArrayObject.h"
 
 namespace Gameplay::Physics {
 	/// <summary>
@@ -20,8 +22,15 @@ namespace Gameplay::Physics {
 
 	protected:
 		btTriangleMesh* _triMesh;
+		// Lets pending GPU reads check whether we still exist when they arrive
+		std::shared_ptr<ConvexMeshCollider*> _selfRef;
 		ConvexMeshCollider();
 
+		/// <summary>
+		/// Builds a bullet triangle mesh from vertex and index data that was read back from the GPU
+		/// </summary>
+		static btTriangleMesh* _BuildTriMesh(const uint8_t* vertexStore, uint32_t vertexCount, const BufferAttribute& posAttrib, const IndexBuffer::Sptr& indexBuff, const uint8_t* indexStore);
+
 		virtual btCollisionShape* CreateShape() const override;
 	};
 }
\ No newline at end of file
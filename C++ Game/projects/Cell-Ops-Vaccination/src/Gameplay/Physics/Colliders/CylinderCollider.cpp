@@ -33,6 +33,14 @@ namespace Gameplay::Physics {
 		return new btCylinderShapeZ(ToBt(_extents));
 	}
 
+	bool CylinderCollider::UpdateShape(btCollisionShape* shape) const {
+		// Cylinders store their extents the same way boxes do
+		btCylinderShape* cylinder = static_cast<btCylinderShape*>(shape);
+		btVector3 margin(cylinder->getMargin(), cylinder->getMargin(), cylinder->getMargin());
+		cylinder->setImplicitShapeDimensions(btVector3(_extents.x, _extents.y, _extents.z) * cylinder->getLocalScaling() - margin);
+		return true;
+	}
+
 	CylinderCollider* CylinderCollider::SetHalfExtents(const glm::vec3& value) {
 		_extents = value;
 		_isDirty = true;
@@ -22,6 +22,7 @@ namespace Gameplay::Physics {
 
 	protected:
 		virtual btCollisionShape* CreateShape() const override;
+		virtual bool UpdateShape(btCollisionShape* shape) const override;
 
 	private:
 		glm::vec3 _extents;
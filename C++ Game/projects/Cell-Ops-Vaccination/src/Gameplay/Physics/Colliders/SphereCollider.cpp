@@ -18,6 +18,11 @@ namespace Gameplay::Physics {
 		return new btSphereShape(_radius);
 	}
 
+	bool SphereCollider::UpdateShape(btCollisionShape* shape) const {
+		static_cast<btSphereShape*>(shape)->setUnscaledRadius(_radius);
+		return true;
+	}
+
 	SphereCollider* SphereCollider::SetRadius(float value) {
 		_radius = value;
 		_isDirty = true;
@@ -21,6 +21,7 @@ namespace Gameplay::Physics {
 
 	protected:
 		virtual btCollisionShape* CreateShape() const override;
+		virtual bool UpdateShape(btCollisionShape* shape) const override;
 
 	private:
 		float _radius;
@@ -57,9 +57,8 @@ namespace Gameplay::Physics {
 		/// <summary>
 		/// Draws ImGui controls for this collider type. If data
 		/// has been changed, make sure to mark the shape as 
-		/// dirty! If a shape is dirty, it will be re-created on
-		/// the next physics frame (bullet cannot re-size shapes
-		/// after they have been created)
+		/// dirty! If a shape is dirty, it will be updated on the
+		/// next physics frame (see UpdateShape)
 		/// </summary>
 		virtual void DrawImGui() = 0;
 		/// <summary>
@@ -155,6 +154,14 @@ namespace Gameplay::Physics {
 		/// </summary>
 		/// <returns>A btCollisionShape allocated with new</returns>
 		virtual btCollisionShape* CreateShape() const = 0;
+		/// <summary>
+		/// Applies this collider's info to a shape that was made by CreateShape, so that
+		/// it does not need to be re-created. Shapes are always re-created for colliders
+		/// that don't override this
+		/// </summary>
+		/// <param name="shape">The shape to update, which already has it's new local scaling</param>
+		/// <returns>True if the shape was updated, false if it must be re-created</returns>
+		virtual bool UpdateShape(btCollisionShape* shape) const { return false; }
 
 	private:
 		// Allow RigidBody to access protected and private members
@@ -137,6 +137,11 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		return _collisionMask;
 	}
 
+	btCollisionObject* PhysicsBase::GetCollisionObject() {
+		btBroadphaseProxy* proxy = _GetBroadphaseHandle();
+		return proxy != nullptr ? static_cast<btCollisionObject*>(proxy->m_clientObject) : nullptr;
+	}
+
 	ICollider::Sptr PhysicsBase::AddCollider(const ICollider::Sptr& collider) {
 		if (_scene != nullptr) {
 			collider->Awake(GetGameObject());
@@ -165,15 +170,13 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 
 		// If the shape actually exists
 		if (newShape != nullptr) {
-			// We convert our shape parameters to a bullet transform
-			btTransform transform;
-			transform.setIdentity();
-			transform.setOrigin(ToBt(collider->_position));
-			transform.setRotation(ToBt(glm::quat(glm::radians(collider->_rotation))));
-			newShape->setLocalScaling(ToBt(collider->_scale));
+			// The compound shape only applies scaling to children that it already has, so we
+			// need to apply the object's scale ourselves
+			const btVector3& scale = _shape->getLocalScaling();
+			newShape->setLocalScaling(btVector3(collider->_scale.x, collider->_scale.y, collider->_scale.z) * scale);
 
 			// Add the shape to the compound shape
-			_shape->addChildShape(transform, newShape);
+			_shape->addChildShape(_GetColliderTransform(collider), newShape);
 
 			// Remove any existing collision manifolds, so that our body can properly be updated with it's new shape
 			if (_scene != nullptr) {
@@ -185,24 +188,85 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		}
 	}
 
+	btTransform PhysicsBase::_GetColliderTransform(const ICollider* collider) const {
+		const btVector3& scale = _shape->getLocalScaling();
+		btTransform transform;
+		transform.setIdentity();
+		transform.setOrigin(btVector3(collider->_position.x, collider->_position.y, collider->_position.z) * scale);
+		transform.setRotation(ToBt(glm::quat(glm::radians(collider->_rotation))));
+		return transform;
+	}
+
 	bool PhysicsBase::_HandleShapeDirty() {
 		bool wasDirty = false;
+		bool wasUpdated = false;
+
+		btTransform identity;
+		identity.setIdentity();
+		btVector3 oldMin, oldMax;
+		_shape->getAabb(identity, oldMin, oldMax);
+
 		for (auto& collider : _colliders) {
 			if (collider->_isDirty) {
-				// If the collider already had a shape, delete it
-				if (collider->_shape != nullptr) {
-					_shape->removeChildShape(collider->_shape);
-					delete collider->_shape;
+				// Find where the collider's shape lives in our compound shape
+				int index = -1;
+				for (int ix = 0; collider->_shape != nullptr && ix < _shape->getNumChildShapes(); ix++) {
+					if (_shape->getChildShape(ix) == collider->_shape) {
+						index = ix;
+						break;
+					}
+				}
+
+				// Try updating the existing shape first, this avoids re-allocating the shape and
+				// rebuilding the compound shape's tree
+				bool updated = false;
+				if (index != -1) {
+					const btVector3& scale = _shape->getLocalScaling();
+					collider->_shape->setLocalScaling(btVector3(collider->_scale.x, collider->_scale.y, collider->_scale.z) * scale);
+					updated = collider->UpdateShape(collider->_shape);
+				}
+
+				if (updated) {
+					// Bounds are recalculated once all the colliders have been updated
+					_shape->updateChildTransform(index, _GetColliderTransform(collider.get()), false);
+					wasUpdated = true;
+				} else {
+					// If the collider already had a shape, delete it
+					if (collider->_shape != nullptr) {
+						_shape->removeChildShape(collider->_shape);
+						delete collider->_shape;
+					}
+					_AddColliderToShape(collider.get());
 				}
-				_AddColliderToShape(collider.get());
 				collider->_isDirty = false;
 				wasDirty = true;
 			}
 		}
 
+		if (wasUpdated) {
+			_shape->recalculateLocalAabb();
+			_CleanPairsIfGrown(oldMin, oldMax);
+		}
+
 		return wasDirty;
 	}
 
+	void PhysicsBase::_CleanPairsIfGrown(const btVector3& oldMin, const btVector3& oldMax) {
+		if (_scene == nullptr || _GetBroadphaseHandle() == nullptr) {
+			return;
+		}
+
+		btTransform identity;
+		identity.setIdentity();
+		btVector3 newMin, newMax;
+		_shape->getAabb(identity, newMin, newMax);
+
+		if (newMin.x() < oldMin.x() || newMin.y() < oldMin.y() || newMin.z() < oldMin.z() ||
+			newMax.x() > oldMax.x() || newMax.y() > oldMax.y() || newMax.z() > oldMax.z()) {
+			_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
+		}
+	}
+
 	bool PhysicsBase::_HandleGroupDirty() {
 		// If the group or mask have changed, notify bullet
 		if (_isGroupMaskDirty) {
@@ -224,8 +288,14 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		transform.setOrigin(ToBt(context->GetPosition()));	 
 		transform.setRotation(ToBt(context->GetRotation()));
 		if (context->GetScale() != _prevScale) {
+			btTransform identity;
+			identity.setIdentity();
+			btVector3 oldMin, oldMax;
+			_shape->getAabb(identity, oldMin, oldMax);
+
+			// Scales the colliders in place, objects that pulse or shrink keep their contacts
 			_shape->setLocalScaling(ToBt(context->GetScale()));
-			_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
+			_CleanPairsIfGrown(oldMin, oldMax);
 			_prevScale = context->GetScale();
 		}
 	}
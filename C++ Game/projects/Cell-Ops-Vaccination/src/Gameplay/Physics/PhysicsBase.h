@@ -55,6 +55,12 @@ namespace Gameplay {
 			/// </summary>
 			int GetCollisionMask() const;
 
+			/// <summary>
+			/// Gets the bullet object for this component, or nullptr if it hasn't been added to
+			/// the physics world yet
+			/// </summary>
+			btCollisionObject* GetCollisionObject();
+
 			/// <summary>
 			/// Adds a new collider to this rigidbody.
 			/// Multiple colliders can be added to a rigidbody, as internally it
@@ -112,10 +118,17 @@ namespace Gameplay {
 
 			// Handles adding a collider to our compound shape
 			void _AddColliderToShape(ICollider* collider);
+			// Gets the transform of a collider within our compound shape, including the object's scale
+			btTransform _GetColliderTransform(const ICollider* collider) const;
 
-			// Handles resolving any dirty state stuff for our object
+			// Handles resolving any dirty state stuff for our object, colliders that can update
+			// their shapes in place are updated, the rest are re-created
 			bool _HandleShapeDirty();
 
+			// Clears the cached contacts for our object if the shape's local bounds grew past the
+			// given bounds. If they only shrank, bullet can keep using the pairs it has
+			void _CleanPairsIfGrown(const btVector3& oldMin, const btVector3& oldMax);
+
 			bool _HandleGroupDirty();
 
 			// Copies the gameobject's transform the the bullet transform
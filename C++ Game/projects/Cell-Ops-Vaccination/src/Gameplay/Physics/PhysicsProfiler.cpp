@@ -0,0 +1,219 @@
+#include "Gameplay/Physics/PhysicsProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <imgui.h>
+#include <btBulletDynamicsCommon.h>
+
+#include "Logging.h"
+#include "Application/FramePacer.h"
+#include "Utils/AsyncFileWriter.h"
+#include "Utils/JsonGlmHelpers.h"
+
+namespace Gameplay::Physics {
+	bool PhysicsProfiler::_isEnabled = false;
+	bool PhysicsProfiler::_isInStep = false;
+	std::thread::id PhysicsProfiler::_mainThread;
+	btEnterProfileZoneFunc* PhysicsProfiler::_prevEnterFunc = nullptr;
+	btLeaveProfileZoneFunc* PhysicsProfiler::_prevLeaveFunc = nullptr;
+
+	std::vector<PhysicsProfiler::OpenZone> PhysicsProfiler::_openZones;
+	std::vector<PhysicsProfiler::Zone>     PhysicsProfiler::_zones;
+	std::vector<PhysicsProfiler::Zone>     PhysicsProfiler::_lastZones;
+	PhysicsProfiler::Counters              PhysicsProfiler::_lastCounters = { 0, 0, 0, 0, 0 };
+	double                                 PhysicsProfiler::_stepStart = 0.0;
+	float                                  PhysicsProfiler::_lastStepMs = 0.0f;
+	std::vector<int>                       PhysicsProfiler::_islandTags;
+
+	std::string PhysicsProfiler::_exportPath = "";
+	std::vector<std::vector<float>> PhysicsProfiler::_recordedSteps;
+
+	void PhysicsProfiler::SetEnabled(bool enabled) {
+		if (enabled == _isEnabled) {
+			return;
+		}
+
+		if (enabled) {
+			_mainThread = std::this_thread::get_id();
+			_prevEnterFunc = btGetCurrentEnterProfileZoneFunc();
+			_prevLeaveFunc = btGetCurrentLeaveProfileZoneFunc();
+			btSetCustomEnterProfileZoneFunc(&PhysicsProfiler::_EnterZone);
+			btSetCustomLeaveProfileZoneFunc(&PhysicsProfiler::_LeaveZone);
+		} else {
+			btSetCustomEnterProfileZoneFunc(_prevEnterFunc);
+			btSetCustomLeaveProfileZoneFunc(_prevLeaveFunc);
+			_isInStep = false;
+			_openZones.clear();
+		}
+		_isEnabled = enabled;
+	}
+
+	void PhysicsProfiler::BeginStep() {
+		if (!_isEnabled) {
+			return;
+		}
+
+		// Zones are kept between steps so that their order stays the same, we only reset the times
+		for (Zone& zone : _zones) {
+			zone.Calls = 0;
+			zone.TimeMs = 0.0f;
+		}
+		_openZones.clear();
+		_isInStep = true;
+		_stepStart = FramePacer::Now();
+	}
+
+	void PhysicsProfiler::EndStep(btDynamicsWorld* world) {
+		if (!_isEnabled || !_isInStep) {
+			return;
+		}
+		_isInStep = false;
+		_lastStepMs = (float)((FramePacer::Now() - _stepStart) * 1000.0);
+		_lastZones = _zones;
+
+		Counters counters = { 0, 0, 0, 0, 0 };
+		btDispatcher* dispatcher = world->getDispatcher();
+		counters.Pairs = (uint32_t)world->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+		counters.Manifolds = (uint32_t)dispatcher->getNumManifolds();
+		for (int ix = 0; ix < dispatcher->getNumManifolds(); ix++) {
+			counters.Contacts += (uint32_t)dispatcher->getManifoldByIndexInternal(ix)->getNumContacts();
+		}
+
+		// Bodies that are touching share an island tag, statics don't belong to any island
+		_islandTags.clear();
+		const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+		for (int ix = 0; ix < objects.size(); ix++) {
+			const btCollisionObject* object = objects[ix];
+			if (!object->isStaticOrKinematicObject() && object->isActive()) {
+				counters.ActiveBodies++;
+			}
+			if (object->getIslandTag() >= 0) {
+				_islandTags.push_back(object->getIslandTag());
+			}
+		}
+		std::sort(_islandTags.begin(), _islandTags.end());
+		counters.Islands = (uint32_t)(std::unique(_islandTags.begin(), _islandTags.end()) - _islandTags.begin());
+		_lastCounters = counters;
+
+		if (!_exportPath.empty() && _recordedSteps.size() < MAX_RECORDED_STEPS) {
+			std::vector<float> step;
+			step.reserve(6 + _zones.size());
+			step.push_back(_lastStepMs);
+			step.push_back((float)counters.Pairs);
+			step.push_back((float)counters.Manifolds);
+			step.push_back((float)counters.Contacts);
+			step.push_back((float)counters.ActiveBodies);
+			step.push_back((float)counters.Islands);
+			for (const Zone& zone : _zones) {
+				step.push_back(zone.TimeMs);
+			}
+			_recordedSteps.push_back(std::move(step));
+		}
+	}
+
+	void PhysicsProfiler::Export() {
+		if (_exportPath.empty() || _recordedSteps.empty()) {
+			return;
+		}
+
+		// Zones that were first seen part way through the run are missing from earlier steps,
+		// those get left empty
+		std::string csv = "step,step_ms,pairs,manifolds,contacts,active_bodies,islands";
+		for (const Zone& zone : _zones) {
+			csv += ",";
+			csv += zone.Name;
+			csv += "_ms";
+		}
+		csv += "\n";
+
+		char buffer[32];
+		for (size_t ix = 0; ix < _recordedSteps.size(); ix++) {
+			const std::vector<float>& step = _recordedSteps[ix];
+			csv += std::to_string(ix);
+			for (size_t value = 0; value < step.size(); value++) {
+				// Counters are whole numbers, everything else is a time
+				snprintf(buffer, sizeof(buffer), value >= 1 && value <= 5 ? ",%.0f" : ",%.4f", step[value]);
+				csv += buffer;
+			}
+			for (size_t value = step.size(); value < _zones.size() + 6; value++) {
+				csv += ",";
+			}
+			csv += "\n";
+		}
+
+		LOG_INFO("Writing {} physics steps to {}", _recordedSteps.size(), _exportPath);
+		AsyncFileWriter::Write(_exportPath, { std::make_shared<const std::string>(std::move(csv)) });
+		_recordedSteps.clear();
+	}
+
+	void PhysicsProfiler::RenderImGui() {
+		bool enabled = _isEnabled;
+		if (ImGui::Checkbox("Enabled", &enabled)) {
+			SetEnabled(enabled);
+		}
+		if (!_isEnabled) {
+			return;
+		}
+
+		ImGui::Text("Step: %.3f ms", _lastStepMs);
+		ImGui::Text("Pairs: %u, manifolds: %u, contacts: %u", _lastCounters.Pairs, _lastCounters.Manifolds, _lastCounters.Contacts);
+		ImGui::Text("Active bodies: %u, islands: %u", _lastCounters.ActiveBodies, _lastCounters.Islands);
+		if (!_exportPath.empty()) {
+			ImGui::Text("Recorded: %u steps", (uint32_t)_recordedSteps.size());
+		}
+
+		ImGui::Separator();
+		for (const Zone& zone : _lastZones) {
+			ImGui::Text("%*s%s", zone.Depth * 2, "", zone.Name);
+			ImGui::SameLine(ImGui::GetWindowContentRegionWidth() - 120.0f);
+			ImGui::Text("%7.3f ms (%u)", zone.TimeMs, zone.Calls);
+		}
+	}
+
+	nlohmann::json PhysicsProfiler::ToJson() {
+		return {
+			{ "enabled", _isEnabled },
+			{ "export_path", _exportPath }
+		};
+	}
+
+	void PhysicsProfiler::LoadFromJson(const nlohmann::json& blob) {
+		if (!blob.is_object()) {
+			return;
+		}
+		_exportPath = JsonGet(blob, "export_path", _exportPath);
+		SetEnabled(JsonGet(blob, "enabled", _isEnabled));
+	}
+
+	void PhysicsProfiler::_EnterZone(const char* name) {
+		// Bullet can be used from other threads (ex: batched raycasts), we only time the step
+		if (!_isInStep || std::this_thread::get_id() != _mainThread) {
+			return;
+		}
+
+		// Zones with the same name at the same depth are treated as one, which merges sub-steps
+		int depth = (int)_openZones.size();
+		size_t index = 0;
+		for (; index < _zones.size(); index++) {
+			if (_zones[index].Depth == depth && (_zones[index].Name == name || strcmp(_zones[index].Name, name) == 0)) {
+				break;
+			}
+		}
+		if (index == _zones.size()) {
+			_zones.push_back(Zone{ name, depth, 0, 0.0f });
+		}
+
+		_zones[index].Calls++;
+		_openZones.push_back(OpenZone{ index, FramePacer::Now() });
+	}
+
+	void PhysicsProfiler::_LeaveZone() {
+		if (!_isInStep || std::this_thread::get_id() != _mainThread || _openZones.empty()) {
+			return;
+		}
+
+		const OpenZone& open = _openZones.back();
+		_zones[open.Index].TimeMs += (float)((FramePacer::Now() - open.Start) * 1000.0);
+		_openZones.pop_back();
+	}
+}
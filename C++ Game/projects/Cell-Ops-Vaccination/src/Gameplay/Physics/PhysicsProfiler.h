@@ -0,0 +1,129 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <json.hpp>
+#include <LinearMath/btQuickprof.h>
+
+class btDynamicsWorld;
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// Breaks down how long each physics step takes, and counts the pairs, contacts and bodies
+	/// that bullet had to deal with.
+	///
+	/// Bullet marks the phases of a step with BT_PROFILE zones, which end up calling whatever
+	/// functions were given to btSetCustomEnterProfileZoneFunc. While enabled, the profiler
+	/// installs its own functions and times every zone entered between BeginStep and EndStep, and
+	/// Scene::DoPhysics adds zones of its own for the engine side of the step. The prebuilt
+	/// bullet libraries don't have CProfileManager compiled in, so this is the only way in. While
+	/// disabled, bullet's own empty functions are left in place.
+	///
+	/// If an export path is set, every step is recorded and written out as CSV when the
+	/// application closes, so that runs without the editor can be profiled as well.
+	///
+	/// All functions must be called from the main thread
+	/// </summary>
+	class PhysicsProfiler {
+	public:
+		PhysicsProfiler() = delete;
+
+		// Largest number of steps recorded for export, about 10 minutes at 60 steps per second
+		static const size_t MAX_RECORDED_STEPS = 36000;
+
+		/// <summary>
+		/// The time spent in a single profiling zone during a step
+		/// </summary>
+		struct Zone {
+			// Name passed to BT_PROFILE
+			const char* Name;
+			// Number of zones this one was nested in
+			int         Depth;
+			uint32_t    Calls;
+			float       TimeMs;
+		};
+
+		/// <summary>
+		/// Counts of what the physics world looked like at the end of a step
+		/// </summary>
+		struct Counters {
+			uint32_t Pairs;
+			uint32_t Manifolds;
+			uint32_t Contacts;
+			uint32_t ActiveBodies;
+			uint32_t Islands;
+		};
+
+		/// <summary>
+		/// Starts or stops collecting timings and counters
+		/// </summary>
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled() { return _isEnabled; }
+
+		/// <summary>
+		/// Sets the file that recorded steps are written to by Export, or an empty string to not
+		/// record steps
+		/// </summary>
+		static void SetExportPath(const std::string& path) { _exportPath = path; }
+		static const std::string& GetExportPath() { return _exportPath; }
+
+		/// <summary>
+		/// Marks the start of a physics step, called by the scene
+		/// </summary>
+		static void BeginStep();
+		/// <summary>
+		/// Marks the end of a physics step and collects counters from the world, called by the scene
+		/// </summary>
+		static void EndStep(btDynamicsWorld* world);
+
+		/// <summary>
+		/// Gets the zones from the last step, in the order they were first entered
+		/// </summary>
+		static const std::vector<Zone>& GetLastZones() { return _lastZones; }
+		static const Counters& GetLastCounters() { return _lastCounters; }
+		static float GetLastStepTime() { return _lastStepMs; }
+
+		/// <summary>
+		/// Queues the recorded steps to be written to the export path as CSV, with one row per
+		/// step. Does nothing if no export path is set or nothing was recorded
+		/// </summary>
+		static void Export();
+
+		/// <summary>
+		/// Renders ImGui controls and the breakdown of the last step
+		/// </summary>
+		static void RenderImGui();
+
+		static nlohmann::json ToJson();
+		static void LoadFromJson(const nlohmann::json& blob);
+
+	private:
+		struct OpenZone {
+			size_t Index;
+			double Start;
+		};
+
+		static bool _isEnabled;
+		static bool _isInStep;
+		static std::thread::id _mainThread;
+		static btEnterProfileZoneFunc* _prevEnterFunc;
+		static btLeaveProfileZoneFunc* _prevLeaveFunc;
+
+		static std::vector<OpenZone> _openZones;
+		static std::vector<Zone>     _zones;
+		static std::vector<Zone>     _lastZones;
+		static Counters              _lastCounters;
+		static double                _stepStart;
+		static float                 _lastStepMs;
+		// Scratch space for counting islands, kept around so that we don't allocate every step
+		static std::vector<int>      _islandTags;
+
+		static std::string _exportPath;
+		// Each recorded step is the step time, the counters, then the time of each zone in _zones
+		static std::vector<std::vector<float>> _recordedSteps;
+
+		static void _EnterZone(const char* name);
+		static void _LeaveZone();
+	};
+}
@@ -0,0 +1,396 @@
+#include "Gameplay/Physics/PhysicsQueries.h"
+
+#include <algorithm>
+#include <imgui.h>
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+
+#include "Application/FramePacer.h"
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Physics/PhysicsBase.h"
+#include "Utils/GlmBulletConversions.h"
+
+namespace Gameplay::Physics {
+	namespace {
+		// Each thread walks the broadphase with its own stack, bullet's own raycasts share a single
+		// stack and can't be run from more than one thread at a time
+		thread_local btAlignedObjectArray<const btDbvtNode*> RayStack;
+
+		// Returns true if a query with the given mask should consider the given object
+		bool PassesFilter(const btCollisionObject* collider, int mask, bool hitTriggers) {
+			const btBroadphaseProxy* proxy = collider->getBroadphaseHandle();
+			if (proxy == nullptr || (proxy->m_collisionFilterGroup & mask) == 0) {
+				return false;
+			}
+			return hitTriggers || collider->hasContactResponse();
+		}
+
+		btVector3 ToBtVec(const glm::vec3& value) {
+			return btVector3(value.x, value.y, value.z);
+		}
+
+		btTransform ToBtTransform(const glm::vec3& position, const glm::quat& rotation) {
+			return btTransform(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w), ToBtVec(position));
+		}
+
+		// Tests a ray against every broadphase leaf that the ray passes through
+		struct RayLeafCallback : public btDbvt::ICollide {
+			const RayQuery& Query;
+			btTransform     From;
+			btTransform     To;
+			btCollisionWorld::ClosestRayResultCallback Result;
+
+			RayLeafCallback(const RayQuery& query, const btVector3& from, const btVector3& to) :
+				Query(query),
+				From(btQuaternion::getIdentity(), from),
+				To(btQuaternion::getIdentity(), to),
+				Result(from, to)
+			{ }
+
+			virtual void Process(const btDbvtNode* leaf) override {
+				const btBroadphaseProxy* proxy = static_cast<const btBroadphaseProxy*>(leaf->data);
+				btCollisionObject* collider = static_cast<btCollisionObject*>(proxy->m_clientObject);
+				if (PassesFilter(collider, Query.Mask, Query.HitTriggers)) {
+					btCollisionWorld::rayTestSingle(From, To, collider, collider->getCollisionShape(), collider->getWorldTransform(), Result);
+				}
+			}
+		};
+
+		// Used when the world isn't using a btDbvtBroadphase, so we have to go through bullet
+		struct FilteredRayCallback : public btCollisionWorld::ClosestRayResultCallback {
+			int  Mask;
+			bool HitTriggers;
+
+			FilteredRayCallback(const btVector3& from, const btVector3& to, int mask, bool hitTriggers) :
+				ClosestRayResultCallback(from, to),
+				Mask(mask),
+				HitTriggers(hitTriggers)
+			{ }
+
+			virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+				return PassesFilter(static_cast<const btCollisionObject*>(proxy->m_clientObject), Mask, HitTriggers);
+			}
+		};
+
+		// Collects the unique objects that touch the query object
+		struct OverlapCallback : public btCollisionWorld::ContactResultCallback {
+			const btCollisionObject* Self;
+			OverlapHit* Hits;
+			size_t      MaxHits;
+			size_t      Count;
+			int         Mask;
+			bool        HitTriggers;
+
+			OverlapCallback(const btCollisionObject* self, OverlapHit* hits, size_t maxHits, int mask, bool hitTriggers) :
+				ContactResultCallback(),
+				Self(self),
+				Hits(hits),
+				MaxHits(maxHits),
+				Count(0),
+				Mask(mask),
+				HitTriggers(hitTriggers)
+			{ }
+
+			virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+				return PassesFilter(static_cast<const btCollisionObject*>(proxy->m_clientObject), Mask, HitTriggers);
+			}
+
+			virtual btScalar addSingleResult(btManifoldPoint& point, const btCollisionObjectWrapper* a, int, int, const btCollisionObjectWrapper* b, int, int) override {
+				// Points that are only close are reported as well, we only care about ones that touch
+				if (point.getDistance() > 0.0f) {
+					return 0.0f;
+				}
+
+				// Objects get a point for every contact, so only keep the first one
+				const btCollisionObject* other = a->getCollisionObject() == Self ? b->getCollisionObject() : a->getCollisionObject();
+				for (size_t ix = 0; ix < Count; ix++) {
+					if (Hits[ix].Collider == other) {
+						return 0.0f;
+					}
+				}
+				if (Count < MaxHits) {
+					Hits[Count++].Collider = other;
+				}
+				return 0.0f;
+			}
+		};
+
+		struct SweepCallback : public btCollisionWorld::ClosestConvexResultCallback {
+			int  Mask;
+			bool HitTriggers;
+
+			SweepCallback(const btVector3& from, const btVector3& to, int mask, bool hitTriggers) :
+				ClosestConvexResultCallback(from, to),
+				Mask(mask),
+				HitTriggers(hitTriggers)
+			{ }
+
+			virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+				return PassesFilter(static_cast<const btCollisionObject*>(proxy->m_clientObject), Mask, HitTriggers);
+			}
+		};
+	}
+
+	PhysicsQueries::PhysicsQueries(btCollisionWorld* world) :
+		_world(world),
+		_broadphase(nullptr),
+		_queryObject(nullptr),
+		_sphere(nullptr),
+		_box(nullptr),
+		_thisFrame({ 0, 0, 0, 0, 0.0f }),
+		_lastFrame({ 0, 0, 0, 0, 0.0f }),
+		_workers(),
+		_mutex(),
+		_workReady(),
+		_workDone(),
+		_batchId(0),
+		_busyWorkers(0),
+		_isStopping(false),
+		_batchRays(nullptr),
+		_batchHits(nullptr),
+		_batchCount(0),
+		_nextChunk(0)
+	{
+		_broadphase = dynamic_cast<btDbvtBroadphase*>(_world->getBroadphase());
+
+		// Unit shapes get scaled to fit each query, so we never have to create new ones
+		_queryObject = new btCollisionObject();
+		_sphere = new btSphereShape(1.0f);
+		_box = new btBoxShape(btVector3(1.0f, 1.0f, 1.0f));
+	}
+
+	PhysicsQueries::~PhysicsQueries() {
+		_StopWorkers();
+		delete _queryObject;
+		delete _sphere;
+		delete _box;
+	}
+
+	bool PhysicsQueries::Raycast(const RayQuery& ray, RaycastHit& outHit) {
+		return RaycastBatch(&ray, 1, &outHit) > 0;
+	}
+
+	size_t PhysicsQueries::RaycastBatch(const RayQuery* rays, size_t count, RaycastHit* outHits) {
+		double start = FramePacer::Now();
+
+		if (count >= PARALLEL_THRESHOLD && _broadphase != nullptr && std::thread::hardware_concurrency() > 1) {
+			if (_workers.empty()) {
+				_StartWorkers();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_batchRays = rays;
+				_batchHits = outHits;
+				_batchCount = count;
+				_nextChunk = 0;
+				_busyWorkers = (int)_workers.size();
+				_batchId++;
+			}
+			_workReady.notify_all();
+
+			// Pitch in while we wait, nobody else can touch the world until we return
+			_RunChunks();
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_workDone.wait(lock, [this]() { return _busyWorkers == 0; });
+			}
+			_thisFrame.ParallelBatches++;
+		} else {
+			for (size_t ix = 0; ix < count; ix++) {
+				_CastRay(rays[ix], outHits[ix], RayStack);
+			}
+		}
+
+		// Owners are looked up back on the main thread, so the workers never touch any components
+		size_t hits = 0;
+		for (size_t ix = 0; ix < count; ix++) {
+			if (outHits[ix].Hit) {
+				_ResolveOwner(outHits[ix].Collider, outHits[ix].Object, outHits[ix].Body);
+				hits++;
+			}
+		}
+
+		_thisFrame.Rays += (uint32_t)count;
+		_thisFrame.TimeMs += (float)((FramePacer::Now() - start) * 1000.0);
+		return hits;
+	}
+
+	size_t PhysicsQueries::OverlapSphere(const glm::vec3& center, float radius, OverlapHit* outHits, size_t maxHits, int mask, bool hitTriggers) {
+		_sphere->setUnscaledRadius(radius);
+		return _Overlap(_sphere, center, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), outHits, maxHits, mask, hitTriggers);
+	}
+
+	size_t PhysicsQueries::OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::quat& rotation, OverlapHit* outHits, size_t maxHits, int mask, bool hitTriggers) {
+		_box->setLocalScaling(ToBtVec(halfExtents));
+		return _Overlap(_box, center, rotation, outHits, maxHits, mask, hitTriggers);
+	}
+
+	bool PhysicsQueries::SweepSphere(const glm::vec3& from, const glm::vec3& to, float radius, RaycastHit& outHit, int mask, bool hitTriggers) {
+		_sphere->setUnscaledRadius(radius);
+		return _Sweep(_sphere, from, to, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), outHit, mask, hitTriggers);
+	}
+
+	bool PhysicsQueries::SweepBox(const glm::vec3& from, const glm::vec3& to, const glm::vec3& halfExtents, const glm::quat& rotation, RaycastHit& outHit, int mask, bool hitTriggers) {
+		_box->setLocalScaling(ToBtVec(halfExtents));
+		return _Sweep(_box, from, to, rotation, outHit, mask, hitTriggers);
+	}
+
+	void PhysicsQueries::BeginFrame() {
+		_lastFrame = _thisFrame;
+		_thisFrame = { 0, 0, 0, 0, 0.0f };
+	}
+
+	void PhysicsQueries::RenderImGui() {
+		ImGui::Text("Rays: %u (%u parallel batches)", _lastFrame.Rays, _lastFrame.ParallelBatches);
+		ImGui::Text("Overlaps: %u, sweeps: %u", _lastFrame.Overlaps, _lastFrame.Sweeps);
+		ImGui::Text("Time: %.3f ms on %u workers", _lastFrame.TimeMs, (uint32_t)_workers.size());
+	}
+
+	void PhysicsQueries::_CastRay(const RayQuery& ray, RaycastHit& outHit, btAlignedObjectArray<const btDbvtNode*>& stack) const {
+		outHit = RaycastHit();
+
+		btVector3 from = ToBtVec(ray.From);
+		btVector3 to = ToBtVec(ray.To);
+		btVector3 direction = to - from;
+		btScalar length = direction.length();
+		if (length <= SIMD_EPSILON) {
+			return;
+		}
+
+		const btCollisionWorld::ClosestRayResultCallback* result = nullptr;
+		RayLeafCallback leafCallback(ray, from, to);
+		FilteredRayCallback filteredCallback(from, to, ray.Mask, ray.HitTriggers);
+
+		if (_broadphase != nullptr) {
+			// Same setup that btDbvtBroadphase::rayTest does, but with our own stack
+			direction /= length;
+			btVector3 inverse(
+				direction[0] == 0.0f ? BT_LARGE_FLOAT : 1.0f / direction[0],
+				direction[1] == 0.0f ? BT_LARGE_FLOAT : 1.0f / direction[1],
+				direction[2] == 0.0f ? BT_LARGE_FLOAT : 1.0f / direction[2]);
+			unsigned int signs[3] = { inverse[0] < 0.0f, inverse[1] < 0.0f, inverse[2] < 0.0f };
+
+			// Set 0 holds the moving objects and set 1 the static ones
+			for (int set = 0; set < 2; set++) {
+				const btDbvt& tree = _broadphase->m_sets[set];
+				tree.rayTestInternal(tree.m_root, from, to, inverse, signs, length, btVector3(0.0f, 0.0f, 0.0f), btVector3(0.0f, 0.0f, 0.0f), stack, leafCallback);
+			}
+			result = &leafCallback.Result;
+		} else {
+			_world->rayTest(from, to, filteredCallback);
+			result = &filteredCallback;
+		}
+
+		if (result->hasHit()) {
+			outHit.Hit = true;
+			outHit.Fraction = result->m_closestHitFraction;
+			outHit.Point = ToGlm(result->m_hitPointWorld);
+			outHit.Normal = ToGlm(result->m_hitNormalWorld.normalized());
+			outHit.Collider = result->m_collisionObject;
+		}
+	}
+
+	void PhysicsQueries::_RunChunks() {
+		const size_t chunks = (_batchCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		for (size_t chunk = _nextChunk++; chunk < chunks; chunk = _nextChunk++) {
+			size_t end = std::min(_batchCount, (chunk + 1) * CHUNK_SIZE);
+			for (size_t ix = chunk * CHUNK_SIZE; ix < end; ix++) {
+				_CastRay(_batchRays[ix], _batchHits[ix], RayStack);
+			}
+		}
+	}
+
+	void PhysicsQueries::_WorkerMain() {
+		uint64_t lastBatch = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_workReady.wait(lock, [&]() { return _isStopping || _batchId != lastBatch; });
+				if (_isStopping) return;
+				lastBatch = _batchId;
+			}
+
+			_RunChunks();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_busyWorkers--;
+			}
+			_workDone.notify_one();
+		}
+	}
+
+	void PhysicsQueries::_StartWorkers() {
+		// The main thread works on batches too, so leave a core for it
+		unsigned int count = std::clamp(std::thread::hardware_concurrency(), 2u, 8u) - 1;
+		_isStopping = false;
+		for (unsigned int ix = 0; ix < count; ix++) {
+			_workers.emplace_back(&PhysicsQueries::_WorkerMain, this);
+		}
+	}
+
+	void PhysicsQueries::_StopWorkers() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isStopping = true;
+		}
+		_workReady.notify_all();
+		for (std::thread& worker : _workers) {
+			worker.join();
+		}
+		_workers.clear();
+	}
+
+	size_t PhysicsQueries::_Overlap(btConvexShape* shape, const glm::vec3& center, const glm::quat& rotation, OverlapHit* outHits, size_t maxHits, int mask, bool hitTriggers) {
+		double start = FramePacer::Now();
+
+		_queryObject->setCollisionShape(shape);
+		_queryObject->setWorldTransform(ToBtTransform(center, rotation));
+
+		OverlapCallback callback(_queryObject, outHits, maxHits, mask, hitTriggers);
+		_world->contactTest(_queryObject, callback);
+		for (size_t ix = 0; ix < callback.Count; ix++) {
+			_ResolveOwner(outHits[ix].Collider, outHits[ix].Object, outHits[ix].Body);
+		}
+
+		_thisFrame.Overlaps++;
+		_thisFrame.TimeMs += (float)((FramePacer::Now() - start) * 1000.0);
+		return callback.Count;
+	}
+
+	bool PhysicsQueries::_Sweep(const btConvexShape* shape, const glm::vec3& from, const glm::vec3& to, const glm::quat& rotation, RaycastHit& outHit, int mask, bool hitTriggers) {
+		double start = FramePacer::Now();
+		outHit = RaycastHit();
+
+		SweepCallback callback(ToBtVec(from), ToBtVec(to), mask, hitTriggers);
+		_world->convexSweepTest(shape, ToBtTransform(from, rotation), ToBtTransform(to, rotation), callback);
+		if (callback.hasHit()) {
+			outHit.Hit = true;
+			outHit.Fraction = callback.m_closestHitFraction;
+			outHit.Point = ToGlm(callback.m_hitPointWorld);
+			outHit.Normal = ToGlm(callback.m_hitNormalWorld.normalized());
+			outHit.Collider = callback.m_hitCollisionObject;
+			_ResolveOwner(outHit.Collider, outHit.Object, outHit.Body);
+		}
+
+		_thisFrame.Sweeps++;
+		_thisFrame.TimeMs += (float)((FramePacer::Now() - start) * 1000.0);
+		return outHit.Hit;
+	}
+
+	void PhysicsQueries::_ResolveOwner(const btCollisionObject* collider, GameObject*& outObject, PhysicsBase*& outBody) {
+		outObject = nullptr;
+		outBody = nullptr;
+		if (collider == nullptr || collider->getUserPointer() == nullptr) {
+			return;
+		}
+
+		// Physics components store a weak pointer to themselves on their bullet objects
+		IComponent::Sptr component = reinterpret_cast<std::weak_ptr<IComponent>*>(collider->getUserPointer())->lock();
+		if (component != nullptr) {
+			outObject = component->GetGameObject();
+			outBody = dynamic_cast<PhysicsBase*>(component.get());
+		}
+	}
+}
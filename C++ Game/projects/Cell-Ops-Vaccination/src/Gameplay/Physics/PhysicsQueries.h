@@ -0,0 +1,187 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+
+#include "Utils/Macros.h"
+
+class btCollisionObject;
+class btCollisionWorld;
+class btDbvtBroadphase;
+class btSphereShape;
+class btBoxShape;
+class btConvexShape;
+struct btDbvtNode;
+template <typename T> class btAlignedObjectArray;
+
+namespace Gameplay {
+	class GameObject;
+
+	namespace Physics {
+		class PhysicsBase;
+
+		/// <summary>
+		/// A single ray to cast into the physics world
+		/// </summary>
+		struct RayQuery {
+			glm::vec3 From;
+			glm::vec3 To;
+			// Only bodies in one of these collision groups are hit, see PhysicsBase::SetCollisionGroup
+			int       Mask = -1;
+			// True if trigger volumes should be hit as well as rigid bodies
+			bool      HitTriggers = false;
+		};
+
+		/// <summary>
+		/// The closest thing that a ray or sweep ran into
+		/// </summary>
+		struct RaycastHit {
+			// False if nothing was hit, in which case the rest of the fields are not set
+			bool         Hit = false;
+			// How far along the ray the hit was, between 0 (From) and 1 (To)
+			float        Fraction = 1.0f;
+			glm::vec3    Point = glm::vec3(0.0f);
+			glm::vec3    Normal = glm::vec3(0.0f);
+			// The object and physics component that were hit, only valid until objects are added or removed
+			GameObject*  Object = nullptr;
+			PhysicsBase* Body = nullptr;
+			// The bullet object that was hit
+			const btCollisionObject* Collider = nullptr;
+		};
+
+		/// <summary>
+		/// An object that overlaps a shape
+		/// </summary>
+		struct OverlapHit {
+			GameObject*  Object = nullptr;
+			PhysicsBase* Body = nullptr;
+			const btCollisionObject* Collider = nullptr;
+		};
+
+		/// <summary>
+		/// Answers raycasts, overlaps and sweeps against a scene's physics world, see Scene::GetPhysicsQueries.
+		///
+		/// Results are written into buffers provided by the caller, and none of the queries allocate
+		/// once they are warmed up. Large raycast batches are split across worker threads, which walk
+		/// the broadphase with their own stacks, while the calling thread waits. The world can't change
+		/// while it waits, so every ray in a batch sees the same world. Queries see the world as of the
+		/// last physics step, so they're best made from Update or LateUpdate.
+		///
+		/// Must only be used from the main thread
+		/// </summary>
+		class PhysicsQueries {
+		public:
+			NO_COPY(PhysicsQueries);
+			NO_MOVE(PhysicsQueries);
+
+			struct Stats {
+				uint32_t Rays;
+				uint32_t Overlaps;
+				uint32_t Sweeps;
+				uint32_t ParallelBatches;
+				float    TimeMs;
+			};
+
+			// Batches with at least this many rays are split across worker threads
+			static const size_t PARALLEL_THRESHOLD = 256;
+			// Number of rays each worker grabs at a time
+			static const size_t CHUNK_SIZE = 64;
+
+			PhysicsQueries(btCollisionWorld* world);
+			~PhysicsQueries();
+
+			/// <summary>
+			/// Casts a single ray, finding the closest thing it hits
+			/// </summary>
+			/// <returns>True if the ray hit something</returns>
+			bool Raycast(const RayQuery& ray, RaycastHit& outHit);
+			/// <summary>
+			/// Casts many rays at once, finding the closest hit for each of them
+			/// </summary>
+			/// <param name="rays">The rays to cast</param>
+			/// <param name="count">The number of rays</param>
+			/// <param name="outHits">Receives the hit for each ray, must have room for count hits</param>
+			/// <returns>The number of rays that hit something</returns>
+			size_t RaycastBatch(const RayQuery* rays, size_t count, RaycastHit* outHits);
+
+			/// <summary>
+			/// Finds the objects that overlap a sphere
+			/// </summary>
+			/// <param name="outHits">Receives the overlapping objects, each object is only reported once</param>
+			/// <param name="maxHits">The number of hits that outHits has room for, any extra objects are ignored</param>
+			/// <returns>The number of hits written to outHits</returns>
+			size_t OverlapSphere(const glm::vec3& center, float radius, OverlapHit* outHits, size_t maxHits, int mask = -1, bool hitTriggers = false);
+			/// <summary>
+			/// Finds the objects that overlap an oriented box, see OverlapSphere
+			/// </summary>
+			size_t OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::quat& rotation, OverlapHit* outHits, size_t maxHits, int mask = -1, bool hitTriggers = false);
+
+			/// <summary>
+			/// Moves a sphere from one point to another, finding the first thing it runs into
+			/// </summary>
+			/// <returns>True if the sphere hit something</returns>
+			bool SweepSphere(const glm::vec3& from, const glm::vec3& to, float radius, RaycastHit& outHit, int mask = -1, bool hitTriggers = false);
+			/// <summary>
+			/// Moves an oriented box from one point to another, see SweepSphere
+			/// </summary>
+			bool SweepBox(const glm::vec3& from, const glm::vec3& to, const glm::vec3& halfExtents, const glm::quat& rotation, RaycastHit& outHit, int mask = -1, bool hitTriggers = false);
+
+			/// <summary>
+			/// Resets the per-frame statistics, called by the scene before each physics step
+			/// </summary>
+			void BeginFrame();
+			/// <summary>
+			/// Gets statistics for the queries made during the last frame
+			/// </summary>
+			const Stats& GetLastFrameStats() const { return _lastFrame; }
+
+			void RenderImGui();
+
+		private:
+			btCollisionWorld* _world;
+			// Null if the world doesn't use a dynamic AABB tree, in which case rays go through bullet one at a time
+			btDbvtBroadphase* _broadphase;
+
+			// Shapes and an object that get reused for every overlap and sweep
+			btCollisionObject* _queryObject;
+			btSphereShape*     _sphere;
+			btBoxShape*        _box;
+
+			Stats _thisFrame;
+			Stats _lastFrame;
+
+			// Worker threads for large raycast batches, only started once a large batch comes along
+			std::vector<std::thread> _workers;
+			std::mutex               _mutex;
+			std::condition_variable  _workReady;
+			std::condition_variable  _workDone;
+			uint64_t                 _batchId;
+			int                      _busyWorkers;
+			bool                     _isStopping;
+
+			// The batch currently being cast, only changed while the workers are idle
+			const RayQuery*     _batchRays;
+			RaycastHit*         _batchHits;
+			size_t              _batchCount;
+			std::atomic<size_t> _nextChunk;
+
+			void _CastRay(const RayQuery& ray, RaycastHit& outHit, btAlignedObjectArray<const btDbvtNode*>& stack) const;
+			void _RunChunks();
+			void _WorkerMain();
+			void _StartWorkers();
+			void _StopWorkers();
+
+			size_t _Overlap(btConvexShape* shape, const glm::vec3& center, const glm::quat& rotation, OverlapHit* outHits, size_t maxHits, int mask, bool hitTriggers);
+			bool _Sweep(const btConvexShape* shape, const glm::vec3& from, const glm::vec3& to, const glm::quat& rotation, RaycastHit& outHit, int mask, bool hitTriggers);
+
+			/// <summary>
+			/// Fills in the object and body of a hit from its collider
+			/// </summary>
+			static void _ResolveOwner(const btCollisionObject* collider, GameObject*& outObject, PhysicsBase*& outBody);
+		};
+	}
+}
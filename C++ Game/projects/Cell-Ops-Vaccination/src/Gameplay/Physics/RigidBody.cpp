@@ -244,6 +244,17 @@ namespace Gameplay::Physics {
 		_RenderImGuiBase();
 	}
 
+	std::any RigidBody::CaptureState() const {
+		return _PackState(_linearVelocity, _angularVelocity);
+	}
+
+	void RigidBody::RestoreState(const std::any& state) {
+		_UnpackState(state, _linearVelocity, _angularVelocity);
+		// Our transform will be pushed to bullet on the next pre-step, velocities need to be re-applied
+		_linearVelocityDirty  = true;
+		_angularVelocityDirty = true;
+	}
+
 	nlohmann::json RigidBody::ToJson() const {
 		nlohmann::json result;
 		// Write out RigidBody data
@@ -168,6 +168,8 @@ namespace Gameplay::Physics {
 		// Inherited from IComponent
 		virtual void Awake() override;
 		virtual void RenderImGui() override;
+		virtual std::any CaptureState() const override;
+		virtual void RestoreState(const std::any& state) override;
 		virtual nlohmann::json ToJson() const override;
 		static RigidBody::Sptr FromJson(const nlohmann::json& data);
 		MAKE_TYPENAME(RigidBody)
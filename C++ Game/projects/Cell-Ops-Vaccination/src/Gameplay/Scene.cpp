@@ -3,12 +3,17 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <chrono>
 
 #include "Utils/FileHelpers.h"
 #include "Utils/GlmBulletConversions.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/JsonSaxReader.h"
+#include "Utils/AsyncFileWriter.h"
 
 #include "Gameplay/Physics/RigidBody.h"
 #include "Gameplay/Physics/TriggerVolume.h"
+#include "Gameplay/Physics/PhysicsProfiler.h"
 #include "Gameplay/MeshResource.h"
 
 #include "Graphics/DebugDraw.h"
@@ -31,6 +36,7 @@ namespace Gameplay {
 		Enemies(std::vector<GameObject::Sptr>()),
 		PlayerLastPosition(glm::vec3(0.0f)),
 		IsPlaying(false),
+		UseDeferredShading(false),
 		IsPaused(false),
 		IsPauseUIUp(false),
 		IsGameEnd(false),
@@ -42,6 +48,7 @@ namespace Gameplay {
 		IsCheatActivated(false),
 		GameRound(0),
 		EnemiesKilled(0),
+		Random(),
 		MainCamera(nullptr),
 		DefaultMaterial(nullptr),
 		_isAwake(false),
@@ -81,7 +88,7 @@ namespace Gameplay {
 	GameObject::Sptr Scene::FindTarget()
 	{
 		if (Targets.size() != 0) {
-			GameObject::Sptr Target = Targets.at(rand() % Targets.size());
+			GameObject::Sptr Target = Targets.at(Random.GetStream("targets").Range(0, (int)Targets.size()));
 			return Target;
 		}
 		else
@@ -303,8 +310,8 @@ namespace Gameplay {
 
 	void Scene::SetSkyboxRotation(const glm::mat3& value) {
 		_skyboxRotation = value;
-		_lightingUbo->GetData().EnvironmentRotation = value;
-		_lightingUbo->Update();
+		_lightingUbo->Set(&LightingUboStruct::EnvironmentRotation, glm::mat4(value));
+		_lightingUbo->Flush();
 	}
 
 	const glm::mat3& Scene::GetSkyboxRotation() const {
@@ -340,8 +347,8 @@ namespace Gameplay {
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
-		_lightingUbo->GetData().AmbientCol = glm::vec3(0.1f);
-		_lightingUbo->Update();
+		_lightingUbo->Set(&LightingUboStruct::AmbientCol, glm::vec3(0.1f));
+		_lightingUbo->Flush();
 	}
 
 	const glm::vec3& Scene::GetAmbientLight() const {
@@ -377,32 +384,61 @@ namespace Gameplay {
 		UiControllerObject = FindObjectByName("UI");
 		TargetSpawnerObject = FindObjectByName("Target Spawner");
 		EnemySpawnerObject = FindObjectByName("Enemy Spawner");
+		NavigationObject = FindObjectByName("Navigation");
 	}
 
 	void Scene::DoPhysics(float dt) {
-		_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-			body->PhysicsPreStep(dt);
-			});
-		_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-			body->PhysicsPreStep(dt);
-			});
-
-		if (IsPlaying) {
-
-			_physicsWorld->stepSimulation(dt, 15);
+		_physicsQueries->BeginFrame();
+		Physics::PhysicsProfiler::BeginStep();
 
+		// The BT_PROFILE zones show up next to bullet's own zones in the physics profiler
+		{
+			BT_PROFILE("RigidBody::PhysicsPreStep");
 			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-				body->PhysicsPostStep(dt);
+				body->PhysicsPreStep(dt);
 				});
+		}
+		{
+			BT_PROFILE("TriggerVolume::PhysicsPreStep");
 			_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-				body->PhysicsPostStep(dt);
+				body->PhysicsPreStep(dt);
 				});
 		}
+
+		if (IsPlaying) {
+
+			_physicsWorld->stepSimulation(dt, 15);
+
+			{
+				BT_PROFILE("RigidBody::PhysicsPostStep");
+				_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+					body->PhysicsPostStep(dt);
+					});
+			}
+			{
+				BT_PROFILE("TriggerVolume::PhysicsPostStep");
+				_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
+					body->PhysicsPostStep(dt);
+					});
+			}
+		}
+
+		Physics::PhysicsProfiler::EndStep(_physicsWorld);
 	}
 
 	void Scene::DrawPhysicsDebug() {
-		if (_bulletDebugDraw->getDebugMode() != btIDebugDraw::DBG_NoDebug) {
-			_physicsWorld->debugDrawWorld();
+		if (_bulletDebugDraw->getDebugMode() != btIDebugDraw::DBG_NoDebug && MainCamera != nullptr) {
+			// Whatever is selected in the hierarchy gets drawn, even if it's far away or off screen
+			const btCollisionObject* selected[2] = { nullptr, nullptr };
+			GameObject::Sptr selectedObject = Application::Get().EditorState.SelectedObject.lock();
+			if (selectedObject != nullptr) {
+				Physics::RigidBody::Sptr body = selectedObject->Get<Physics::RigidBody>();
+				Physics::TriggerVolume::Sptr trigger = selectedObject->Get<Physics::TriggerVolume>();
+				selected[0] = body != nullptr ? body->GetCollisionObject() : nullptr;
+				selected[1] = trigger != nullptr ? trigger->GetCollisionObject() : nullptr;
+			}
+
+			_bulletDebugDraw->DrawWorld(_physicsWorld, MainCamera->GetViewProjection(), MainCamera->GetGameObject()->GetPosition(), selected, 2);
 			DebugDrawer::Get().FlushAll();
 		}
 	}
@@ -411,14 +447,14 @@ namespace Gameplay {
 		if (!IsGameEnd)
 		{
 			//Cheats
-			if ((InputEngine::GetKeyState(GLFW_KEY_F2) == ButtonState::Pressed) && IsPaused) {
+			if ((InputEngine::GetActionState("Cheat") == ButtonState::Pressed) && IsPaused) {
 				if (!IsCheatActivated) {
 					EnemiesKilled = 100;
 					IsCheatActivated = true;
 				}
 			}
 			// Pause
-			if (InputEngine::GetKeyState(GLFW_KEY_ESCAPE) == ButtonState::Pressed) {
+			if (InputEngine::GetActionState("Pause") == ButtonState::Pressed) {
 				if (IsPaused && IsPauseUIUp)
 				{
 					IsPaused = false;
@@ -432,7 +468,7 @@ namespace Gameplay {
 
 			}
 			//Start
-			if (InputEngine::IsKeyDown(GLFW_KEY_ENTER)) {
+			if (InputEngine::IsActionDown("Start")) {
 				if (!IsPlaying && !GameStarted)
 				{
 					IsPlaying = true;
@@ -443,6 +479,13 @@ namespace Gameplay {
 			_FlushDeleteQueue();
 			if (IsPlaying) {
 				if (!IsPaused) {
+					// Only component types that override the phase are visited, see ComponentManager::RegisterType
+					_components.EachInPhase(ComponentPhases::Update, [dt](const IComponent::Sptr& component) {
+						component->Update(dt);
+					});
+					_components.EachInPhase(ComponentPhases::LateUpdate, [dt](const IComponent::Sptr& component) {
+						component->LateUpdate(dt);
+					});
 					for (auto& obj : _objects) {
 						obj->Update(dt);
 					}
@@ -479,7 +522,7 @@ namespace Gameplay {
 			/// TODO: Major lag after restart cause:Unkown
 			/// </summary>
 			/// <param name="dt"></param>
-			if (InputEngine::GetKeyState(GLFW_KEY_TAB) == ButtonState::Pressed) {
+			if (InputEngine::GetActionState("Restart") == ButtonState::Pressed) {
 				
 				Lights.clear();
 				Enemies.clear();
@@ -498,6 +541,7 @@ namespace Gameplay {
 
 	void Scene::PreRender() {
 		_lightingUbo->Bind(LIGHT_UBO_BINDING);
+		_lightCuller.Build(Lights, MAX_LIGHTS);
 	}
 
 	void Scene::RenderGUI()
@@ -512,96 +556,293 @@ namespace Gameplay {
 
 	void Scene::SetShaderLight(int index, bool update /*= true*/) {
 		if (index >= 0 && index < Lights.size() && index < MAX_LIGHTS) {
-			// Get a reference to the light UBO data so we can update it
-			LightingUboStruct& data = _lightingUbo->GetData();
+			// Get a reference to just this light in the UBO, so only it gets re-uploaded
+			LightingUboStruct::Light& data = _lightingUbo->ModifyElement(&LightingUboStruct::Lights, index);
 			Light& light = Lights[index];
 
 			// Copy to the ubo data
-			data.Lights[index].Position = light.Position;
-			data.Lights[index].Color = light.Color;
-			data.Lights[index].Attenuation = 1.0f / (1.0f + light.Range);
+			data.Position = light.Position;
+			data.Color = light.Color;
+			data.Attenuation = light.GetAttenuation();
 
 			// If requested, send the new data to the UBO
-			if (update)	_lightingUbo->Update();
+			if (update)	_lightingUbo->Flush();
 		}
 	}
 
 	void Scene::SetupShaderAndLights() {
-		// Get a reference to the light UBO data so we can update it
-		LightingUboStruct& data = _lightingUbo->GetData();
 		// Send in how many active lights we have and the global lighting settings
-		data.AmbientCol = glm::vec3(0.1f);
-		data.NumLights = Lights.size();
+		_lightingUbo->Set(&LightingUboStruct::AmbientCol, glm::vec3(0.1f));
+		_lightingUbo->Set(&LightingUboStruct::NumLights, (float)Lights.size());
 
 		// Iterate over all lights that are enabled and configure them
 		for (int ix = 0; ix < Lights.size(); ix++) {
 			SetShaderLight(ix, false);
 		}
 
-		// Send updated data to OpenGL
-		_lightingUbo->Update();
+		// Send only the parts that changed to OpenGL
+		_lightingUbo->Flush();
 	}
 
 	btDynamicsWorld* Scene::GetPhysicsWorld() const {
 		return _physicsWorld;
 	}
 
+	/// <summary>
+	/// Stores everything that gameplay is allowed to change on a scene, all other state
+	/// (resources, skybox, physics world) is left untouched by play mode
+	/// </summary>
+	struct Scene::StateSnapshot {
+		struct ComponentState {
+			IComponent::Sptr Component;
+			bool             IsEnabled;
+			std::any         State;
+		};
+
+		struct ObjectState {
+			GameObject::Sptr            Object;
+			std::string                 Name;
+			bool                        HideInHierarchy;
+			glm::vec3                   Position;
+			glm::quat                   Rotation;
+			glm::vec3                   Scale;
+			GameObject::WeakRef         Parent;
+			std::vector<GameObject::WeakRef> Children;
+			std::vector<ComponentState> Components;
+		};
+
+		std::vector<ObjectState>      Objects;
+		std::vector<Light>            Lights;
+		Camera::Sptr                  MainCamera;
+
+		std::vector<GameObject::Sptr> Targets;
+		std::vector<GameObject::Sptr> Enemies;
+		std::vector<GameObject::Sptr> BackgroundObjects;
+		GameObject::Sptr EnemySpawnerObject;
+		GameObject::Sptr TargetSpawnerObject;
+		GameObject::Sptr UiControllerObject;
+		glm::vec3 PlayerLastPosition;
+		bool IsPlaying;
+		bool IsPaused;
+		bool IsPauseUIUp;
+		bool IsGameEnd;
+		bool IsGameWon;
+		bool GameStarted;
+		bool IsCheatActivated;
+		bool IsTitleUp;
+		bool IsWinScreenUp;
+		bool IsLoseScreenUp;
+		int  GameRound;
+		int  EnemiesKilled;
+		RandomService Random;
+	};
+
+	std::shared_ptr<Scene::StateSnapshot> Scene::CaptureState() const
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		std::shared_ptr<StateSnapshot> result = std::make_shared<StateSnapshot>();
+		result->Objects.reserve(_objects.size());
+		for (const auto& object : _objects) {
+			StateSnapshot::ObjectState& state = result->Objects.emplace_back();
+			state.Object          = object;
+			state.Name            = object->Name;
+			state.HideInHierarchy = object->HideInHierarchy;
+			state.Position        = object->_position;
+			state.Rotation        = object->_rotation;
+			state.Scale           = object->_scale;
+			state.Parent          = object->_parent;
+			state.Children        = object->_children;
+
+			state.Components.reserve(object->_components.size());
+			for (const auto& component : object->_components) {
+				state.Components.push_back({ component, component->IsEnabled, component->CaptureState() });
+			}
+		}
+
+		result->Lights              = Lights;
+		result->MainCamera          = MainCamera;
+		result->Targets             = Targets;
+		result->Enemies             = Enemies;
+		result->BackgroundObjects   = BackgroundObjects;
+		result->EnemySpawnerObject  = EnemySpawnerObject;
+		result->TargetSpawnerObject = TargetSpawnerObject;
+		result->UiControllerObject  = UiControllerObject;
+		result->PlayerLastPosition  = PlayerLastPosition;
+		result->IsPlaying           = IsPlaying;
+		result->IsPaused            = IsPaused;
+		result->IsPauseUIUp         = IsPauseUIUp;
+		result->IsGameEnd           = IsGameEnd;
+		result->IsGameWon           = IsGameWon;
+		result->GameStarted         = GameStarted;
+		result->IsCheatActivated    = IsCheatActivated;
+		result->IsTitleUp           = IsTitleUp;
+		result->IsWinScreenUp       = IsWinScreenUp;
+		result->IsLoseScreenUp      = IsLoseScreenUp;
+		result->GameRound           = GameRound;
+		result->EnemiesKilled       = EnemiesKilled;
+		result->Random              = Random;
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		LOG_INFO("Captured scene state for {} objects in {:.3f}ms", result->Objects.size(), elapsed.count());
+		return result;
+	}
+
+	void Scene::RestoreState(const std::shared_ptr<StateSnapshot>& snapshot)
+	{
+		if (snapshot == nullptr) return;
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// Anything queued for deletion during play either no longer exists after the
+		// restore, or is being brought back by it
+		_deletionQueue.clear();
+
+		// Put back the object list, hierarchy and transforms first, so that components
+		// can safely look up other objects when restoring their own state
+		_objects.clear();
+		_objects.reserve(snapshot->Objects.size());
+		for (const auto& state : snapshot->Objects) {
+			const GameObject::Sptr& object = state.Object;
+			object->Name                   = state.Name;
+			object->HideInHierarchy        = state.HideInHierarchy;
+			object->_position              = state.Position;
+			object->_rotation              = state.Rotation;
+			object->_scale                 = state.Scale;
+			object->_isLocalTransformDirty = true;
+			object->_isWorldTransformDirty = true;
+			object->_parent                = state.Parent;
+			object->_children              = state.Children;
+
+			object->_components.clear();
+			for (const auto& component : state.Components) {
+				object->_components.push_back(component.Component);
+			}
+			_objects.push_back(object);
+		}
+
+		for (const auto& state : snapshot->Objects) {
+			for (const auto& component : state.Components) {
+				component.Component->IsEnabled = component.IsEnabled;
+				component.Component->RestoreState(component.State);
+			}
+		}
+
+		Lights              = snapshot->Lights;
+		MainCamera          = snapshot->MainCamera;
+		Targets             = snapshot->Targets;
+		Enemies             = snapshot->Enemies;
+		BackgroundObjects   = snapshot->BackgroundObjects;
+		EnemySpawnerObject  = snapshot->EnemySpawnerObject;
+		TargetSpawnerObject = snapshot->TargetSpawnerObject;
+		UiControllerObject  = snapshot->UiControllerObject;
+		PlayerLastPosition  = snapshot->PlayerLastPosition;
+		IsPlaying           = snapshot->IsPlaying;
+		IsPaused            = snapshot->IsPaused;
+		IsPauseUIUp         = snapshot->IsPauseUIUp;
+		IsGameEnd           = snapshot->IsGameEnd;
+		IsGameWon           = snapshot->IsGameWon;
+		GameStarted         = snapshot->GameStarted;
+		IsCheatActivated    = snapshot->IsCheatActivated;
+		IsTitleUp           = snapshot->IsTitleUp;
+		IsWinScreenUp       = snapshot->IsWinScreenUp;
+		IsLoseScreenUp      = snapshot->IsLoseScreenUp;
+		GameRound           = snapshot->GameRound;
+		EnemiesKilled       = snapshot->EnemiesKilled;
+		Random              = snapshot->Random;
+
+		// Lights may have been re-baked during play
+		SetupShaderAndLights();
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		LOG_INFO("Restored scene state for {} objects in {:.3f}ms", _objects.size(), elapsed.count());
+	}
+
 	Scene::Sptr Scene::FromJson(const nlohmann::json& data)
 	{
 
 		Scene::Sptr result = std::make_shared<Scene>();
 		result->MainCamera = nullptr;
 		result->_objects.clear();
-		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
 
-		if (data.contains("ambient")) {
-			result->SetAmbientLight((data["ambient"]));
+		// Make sure the scene has objects, then load them all in!
+		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
+		for (auto& object : data["objects"]) {
+			result->_LoadObjectJson(object);
 		}
 
-		if (data.contains("skybox") && data["skybox"].is_object()) {
-			nlohmann::json& blob = data["skybox"].get<nlohmann::json>();
-			result->_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
-			result->SetSkyboxShader(ResourceManager::Get<ShaderProgram>(Guid(blob["shader"])));
-			result->SetSkyboxTexture(ResourceManager::Get<TextureCube>(Guid(blob["texture"])));
-			result->SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
+		// Make sure the scene has lights, then load all
+		LOG_ASSERT(data["lights"].is_array(), "Lights not present in scene!");
+		for (auto& light : data["lights"]) {
+			result->Lights.push_back(Light::FromJson(light));
 		}
 
-		// Make sure the scene has objects, then load them all in!
-		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
-		for (auto& object : data["objects"]) {
-			GameObject::Sptr obj = GameObject::FromJson(result.get(), object);
-			obj->_scene = result.get();
-			obj->_parent.SceneContext = result.get();
-			obj->_selfRef = obj;
-			result->_objects.push_back(obj);
+		result->_FinishLoadJson(data);
+		return result;
+	}
+
+	void Scene::_LoadObjectJson(const nlohmann::json& data) {
+		GameObject::Sptr obj = GameObject::FromJson(this, data);
+		obj->_scene = this;
+		obj->_parent.SceneContext = this;
+		obj->_selfRef = obj;
+		_objects.push_back(obj);
+	}
+
+	void Scene::_FinishLoadJson(const nlohmann::json& data) {
+		DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
+
+		if (data.contains("ambient")) {
+			SetAmbientLight((data["ambient"]));
+		}
+
+		UseDeferredShading = JsonGet(data, "deferred_shading", false);
+
+		if (data.contains("skybox") && data["skybox"].is_object()) {
+			const nlohmann::json& blob = data["skybox"];
+			_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
+			SetSkyboxShader(ResourceManager::Get<ShaderProgram>(Guid(blob["shader"])));
+			SetSkyboxTexture(ResourceManager::Get<TextureCube>(Guid(blob["texture"])));
+			SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
 		}
 
 		// Re-build the parent hierarchy 
-		for (const auto& object : result->_objects) {
+		for (const auto& object : _objects) {
 			if (object->GetParent() != nullptr) {
 				object->GetParent()->AddChild(object);
 			}
 		}
 
-		// Make sure the scene has lights, then load all
-		LOG_ASSERT(data["lights"].is_array(), "Lights not present in scene!");
-		for (auto& light : data["lights"]) {
-			result->Lights.push_back(Light::FromJson(light));
-		}
-
 		// Create and load camera config
-		result->MainCamera = result->_components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
+		MainCamera = _components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
 
-		return result;
+		if (data.contains("random")) {
+			Random.LoadFromJson(data["random"]);
+		}
 	}
 
 	nlohmann::json Scene::ToJson() const
+	{
+		nlohmann::json blob = _SettingsToJson();
+
+		// Save renderables
+		std::vector<nlohmann::json> objects;
+		objects.resize(_objects.size());
+		for (int ix = 0; ix < _objects.size(); ix++) {
+			objects[ix] = _objects[ix]->ToJson();
+		}
+		blob["objects"] = objects;
+
+		return blob;
+	}
+
+	nlohmann::json Scene::_SettingsToJson() const
 	{
 		nlohmann::json blob;
 		// Save the default shader (really need a material class)
 		blob["default_material"] = DefaultMaterial ? DefaultMaterial->GetGUID().str() : "null";
 
 		blob["ambient"] = GetAmbientLight();
+		blob["deferred_shading"] = UseDeferredShading;
 
 		blob["skybox"] = nlohmann::json();
 		blob["skybox"]["mesh"] = _skyboxMesh ? _skyboxMesh->GetGUID().str() : "null";
@@ -609,14 +850,6 @@ namespace Gameplay {
 		blob["skybox"]["texture"] = _skyboxTexture ? _skyboxTexture->GetGUID().str() : "null";
 		blob["skybox"]["orientation"] = (glm::quat)_skyboxRotation;
 
-		// Save renderables
-		std::vector<nlohmann::json> objects;
-		objects.resize(_objects.size());
-		for (int ix = 0; ix < _objects.size(); ix++) {
-			objects[ix] = _objects[ix]->ToJson();
-		}
-		blob["objects"] = objects;
-
 		// Save lights
 		std::vector<nlohmann::json> lights;
 		lights.resize(Lights.size());
@@ -628,22 +861,75 @@ namespace Gameplay {
 		// Save camera info
 		blob["main_camera"] = MainCamera != nullptr ? MainCamera->GetGUID().str() : "null";
 
+		blob["random"] = Random.ToJson();
+
 		return blob;
 	}
 
 	void Scene::Save(const std::string& path) {
+		double startTime = glfwGetTime();
 		_filePath = path;
-		// Save data to file
-		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
-		LOG_INFO("Saved scene to \"{}\"", path);
+
+		// The settings are small so we always serialize those, then strip off the closing
+		// brace so we can add the objects on the end
+		std::string settings = JsonChunkCache::Dump(_SettingsToJson(), 0);
+		settings.resize(settings.size() - 2);
+		settings += ",\n\t\"objects\": [";
+
+		// Objects that haven't changed since the last save just re-use their old text
+		static const JsonChunkCache::Chunk separator = JsonChunkCache::MakeChunk(",");
+		static const JsonChunkCache::Chunk footer = JsonChunkCache::MakeChunk("\n\t]\n}");
+		std::vector<JsonChunkCache::Chunk> chunks;
+		chunks.reserve(_objects.size() * 2 + 2);
+		chunks.push_back(JsonChunkCache::MakeChunk(settings));
+		for (int ix = 0; ix < _objects.size(); ix++) {
+			const GameObject::Sptr& object = _objects[ix];
+			if (ix > 0) {
+				chunks.push_back(separator);
+			}
+			chunks.push_back(_saveCache.Get(object->GetGUID(), object->GetRevision(), "\n\t\t", 2, [&]() { return object->ToJson(); }));
+		}
+		chunks.push_back(footer);
+
+		size_t rebuilt = _saveCache.GetRebuildCount();
+		_saveCache.Prune();
+
+		// The chunks are immutable, so the rest of the save can happen off the main thread
+		AsyncFileWriter::Write(path, std::move(chunks));
+		LOG_INFO("Saving scene to \"{}\", serialized {} of {} objects in {:.2f}ms", path, rebuilt, _objects.size(), (glfwGetTime() - startTime) * 1000.0);
 	}
 
 	Scene::Sptr Scene::Load(const std::string& path)
 	{
 		LOG_INFO("Loading scene from \"{}\"", path);
+		// Make sure we're not reading a file that's still being saved
+		AsyncFileWriter::Flush();
 		std::string content = FileHelpers::ReadFile(path);
-		nlohmann::json blob = nlohmann::json::parse(content);
-		Scene::Sptr result = FromJson(blob);
+
+		Scene::Sptr result = std::make_shared<Scene>();
+		result->MainCamera = nullptr;
+		result->_objects.clear();
+
+		// Rather than parsing the whole file into a JSON tree first, we build objects and lights
+		// one at a time as the parser reaches them. The rest of the top level values are small,
+		// so we hang onto those and apply them once everything is loaded
+		nlohmann::json settings = nlohmann::json::object();
+		JsonSaxReader<nlohmann::json> reader({ { "objects", "*" }, { "lights", "*" }, { "*" } },
+			[&](const JsonSaxReader<nlohmann::json>::Path& jsonPath, nlohmann::json& value) {
+				if (jsonPath[0] == "objects") {
+					result->_LoadObjectJson(value);
+				} else if (jsonPath[0] == "lights") {
+					result->Lights.push_back(Light::FromJson(value));
+				} else {
+					settings[jsonPath[0]] = std::move(value);
+				}
+			});
+		if (!nlohmann::json::sax_parse(content, &reader)) {
+			LOG_ERROR("Failed to parse scene \"{}\"", path);
+			return nullptr;
+		}
+
+		result->_FinishLoadJson(settings);
 		result->_filePath = path;
 		return result;
 	}
@@ -670,13 +956,27 @@ namespace Gameplay {
 			_collisionConfig
 		);
 		_physicsWorld->setGravity(ToBt(_gravity));
+		// Lets us invoke FixedUpdate on components for every internal physics sub-step
+		_physicsWorld->setInternalTickCallback(&Scene::_PhysicsPreTick, this, true);
 		// TODO bullet debug drawing
 		_bulletDebugDraw = new BulletDebugDraw();
 		_physicsWorld->setDebugDrawer(_bulletDebugDraw);
 		_bulletDebugDraw->setDebugMode(btIDebugDraw::DBG_NoDebug);
+
+		_physicsQueries = new Physics::PhysicsQueries(_physicsWorld);
+	}
+
+	void Scene::_PhysicsPreTick(btDynamicsWorld* world, btScalar timeStep) {
+		BT_PROFILE("FixedUpdate");
+		InputEngine::BeginTick();
+		ComponentManager::EachInPhase(ComponentPhases::FixedUpdate, [timeStep](const IComponent::Sptr& component) {
+			component->FixedUpdate(timeStep);
+		});
 	}
 
 	void Scene::_CleanupPhysics() {
+		delete _physicsQueries;
+		delete _bulletDebugDraw;
 		delete _physicsWorld;
 		delete _constraintSolver;
 		delete _broadphaseInterface;
@@ -689,9 +989,16 @@ namespace Gameplay {
 	void Scene::_FlushDeleteQueue() {
 		for (auto& weakPtr : _deletionQueue) {
 			if (weakPtr.expired()) continue;
-			auto& it = std::find(_objects.begin(), _objects.end(), weakPtr.lock());
+			GameObject::Sptr object = weakPtr.lock();
+			auto& it = std::find(_objects.begin(), _objects.end(), object);
 			if (it != _objects.end()) {
 				_objects.erase(it);
+
+				// The object may be kept alive by an editor snapshot, so make sure its
+				// components stop rendering and simulating until they're restored
+				for (const auto& component : object->_components) {
+					component->IsEnabled = false;
+				}
 			}
 		}
 		_deletionQueue.clear();
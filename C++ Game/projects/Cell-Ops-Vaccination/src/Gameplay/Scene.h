@@ -5,11 +5,16 @@
 #include "Gameplay/Components/Camera.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Light.h"
+#include "Gameplay/LightCuller.h"
 
 #include "Physics/BulletDebugDraw.h"
+#include "Physics/PhysicsQueries.h"
 
 #include "Graphics/Buffers/UniformBuffer.h"
 
+#include "Utils/Random.h"
+#include "Utils/JsonChunkCache.h"
+
 
 struct GLFWwindow;
 
@@ -40,7 +45,10 @@ namespace Gameplay {
 
 		typedef std::shared_ptr<Scene> Sptr;
 
-		static const int MAX_LIGHTS = 8;
+		// In-memory copy of the mutable parts of the scene, see CaptureState
+		struct StateSnapshot;
+
+		static const int MAX_LIGHTS = 64;
 		static const int LIGHT_UBO_BINDING = 2;
 
 		// Stores all the lights in our scene
@@ -53,6 +61,9 @@ namespace Gameplay {
 
 		// Whether the application is in "play mode", lets us leverage editors!
 		bool                       IsPlaying;
+		// Whether opaque objects with deferred materials are lit in a single screen space pass,
+		// which is faster for scenes with lots of lights. Other materials are still drawn forward
+		bool                       UseDeferredShading;
 		/// Things I added for our game
 		std::vector<GameObject::Sptr> Targets;
 		std::vector<GameObject::Sptr> Enemies;
@@ -60,6 +71,7 @@ namespace Gameplay {
 		GameObject::Sptr EnemySpawnerObject;
 		GameObject::Sptr TargetSpawnerObject;
 		GameObject::Sptr UiControllerObject;
+		GameObject::Sptr NavigationObject;
 		glm::vec3 PlayerLastPosition;
 		bool IsPaused;
 		bool IsPauseUIUp;
@@ -73,6 +85,9 @@ namespace Gameplay {
 		int GameRound;
 		int EnemiesKilled;
 
+		// Seeded random streams for gameplay systems, use these instead of rand() so runs are reproducible
+		RandomService Random;
+
 
 		Scene();
 		~Scene();
@@ -114,6 +129,10 @@ namespace Gameplay {
 
 		void SetPhysicsDebugDrawMode(BulletDebugMode mode);
 		BulletDebugMode GetPhysicsDebugDrawMode() const;
+		/// <summary>
+		/// Gets the debug drawer for the physics world, which has settings for which objects are drawn
+		/// </summary>
+		BulletDebugDraw& GetPhysicsDebugDraw() { return *_bulletDebugDraw; }
 
 		void SetSkyboxShader(const std::shared_ptr<ShaderProgram>& shader);
 		std::shared_ptr<ShaderProgram> GetSkyboxShader() const;
@@ -203,10 +222,17 @@ namespace Gameplay {
 		void Update(float dt);
 
 		/// <summary>
-		/// Performs setup before rendering
+		/// Performs setup before rendering, including rebuilding the light culler from the
+		/// scene's lights
 		/// </summary>
 		void PreRender();
 
+		/// <summary>
+		/// Gets the light culler used to pick the lights that affect each object, only valid
+		/// after PreRender has been called for the frame
+		/// </summary>
+		LightCuller& GetLightCuller() { return _lightCuller; }
+
 		/// <summary>
 		/// Draws all GUI objects in the scene
 		/// </summary>
@@ -236,6 +262,25 @@ namespace Gameplay {
 		/// Gets the scene's Bullet physics world
 		/// </summary>
 		btDynamicsWorld* GetPhysicsWorld() const;
+		/// <summary>
+		/// Gets the service used to make raycasts, overlaps and sweeps against this scene's
+		/// physics world
+		/// </summary>
+		Physics::PhysicsQueries& GetPhysicsQueries() { return *_physicsQueries; }
+
+		/// <summary>
+		/// Captures the mutable state of the scene (object transforms, hierarchy, component
+		/// lists and runtime state, lights and game state) without serializing anything. Objects
+		/// and components are kept alive by the snapshot, so restoring does not reload resources
+		/// </summary>
+		/// <returns>A snapshot that can be passed to RestoreState</returns>
+		std::shared_ptr<StateSnapshot> CaptureState() const;
+		/// <summary>
+		/// Rolls the scene back in place to a state captured by CaptureState. Objects created
+		/// since the capture are dropped, and objects removed since the capture are brought back
+		/// </summary>
+		/// <param name="snapshot">The snapshot to restore</param>
+		void RestoreState(const std::shared_ptr<StateSnapshot>& snapshot);
 
 		/// <summary>
 		/// Loads a scene from a JSON blob
@@ -250,7 +295,9 @@ namespace Gameplay {
 		const ComponentManager& Components() const { return _components; }
 
 		/// <summary>
-		/// Saves this scene to an output JSON file
+		/// Saves this scene to an output JSON file. Only objects that have changed since the
+		/// last save are serialized again, and the file itself is written on a background
+		/// thread (see AsyncFileWriter)
 		/// </summary>
 		/// <param name="path">The path of the file to write to</param>
 		void Save(const std::string& path);
@@ -286,9 +333,13 @@ namespace Gameplay {
 		btGhostPairCallback* _ghostCallback;
 
 		BulletDebugDraw* _bulletDebugDraw;
+		// Answers raycasts and overlaps against the physics world
+		Physics::PhysicsQueries* _physicsQueries;
 
 		// The path that we've saved or loaded this scene from
 		std::string             _filePath;
+		// The serialized text of our objects as of the last save
+		JsonChunkCache          _saveCache;
 
 		// Our physics scene's global gravity, default matches earth's gravity (m/s^2)
 		glm::vec3 _gravity;
@@ -333,6 +384,7 @@ namespace Gameplay {
 			glm::mat4 EnvironmentRotation;
 		};
 		UniformBuffer<LightingUboStruct>::Sptr _lightingUbo;
+		LightCuller                _lightCuller;
 
 		bool                       _isAwake;
 
@@ -344,7 +396,25 @@ namespace Gameplay {
 		/// Handles cleaning up bullet physics for this scene
 		/// </summary>
 		void _CleanupPhysics();
+		/// <summary>
+		/// Invoked by bullet before each internal sub-step, dispatches FixedUpdate to components
+		/// </summary>
+		static void _PhysicsPreTick(btDynamicsWorld* world, btScalar timeStep);
 
 		void _FlushDeleteQueue();
+
+		/// <summary>
+		/// Loads a single game object from JSON and adds it to the scene
+		/// </summary>
+		void _LoadObjectJson(const nlohmann::json& data);
+		/// <summary>
+		/// Applies the scene level settings (materials, skybox, camera, etc...) once all
+		/// objects have been loaded, and rebuilds the object hierarchy
+		/// </summary>
+		void _FinishLoadJson(const nlohmann::json& data);
+		/// <summary>
+		/// Gets the JSON for everything in the scene except for the objects
+		/// </summary>
+		nlohmann::json _SettingsToJson() const;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "UpdateRateLod.h"
+
+#include "Application/Timing.h"
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Scene.h"
+#include "Utils/ImGuiHelper.h"
+#include "Utils/JsonGlmHelpers.h"
+
+namespace Gameplay {
+	uint32_t      UpdateRateLod::_nextStaggerOffset = 0;
+	uint64_t      UpdateRateLod::_cachedFrame       = UINT64_MAX;
+	const Camera* UpdateRateLod::_cachedCamera      = nullptr;
+	glm::vec3     UpdateRateLod::_cachedCameraPos   = glm::vec3(0.0f);
+	Frustum       UpdateRateLod::_cachedFrustum     = Frustum();
+
+	UpdateRateLod::UpdateRateLod() :
+		Enabled(true),
+		FullRateDistance(20.0f),
+		HalfRateDistance(40.0f),
+		QuarterRateDistance(70.0f),
+		EighthRateDistance(120.0f),
+		PauseBeyondRange(false),
+		HiddenInterval(8),
+		BoundingRadius(1.0f),
+		_accumulatedTime(0.0f),
+		_interval(1),
+		_staggerOffset(_nextStaggerOffset++)
+	{ }
+
+	bool UpdateRateLod::ShouldTick(const GameObject* object, float deltaTime, float& outDeltaTime) {
+		_interval = Enabled ? _CalculateInterval(object) : 1;
+
+		// Paused components don't get to catch up on time when they resume, otherwise
+		// they would jump by however long they were paused for
+		if (_interval == 0) {
+			_accumulatedTime = 0.0f;
+			return false;
+		}
+
+		_accumulatedTime += deltaTime;
+
+		// Intervals are always powers of 2, so we can mask instead of mod
+		uint64_t frame = Timing::Current().FrameCount();
+		if (((frame + _staggerOffset) & (uint64_t)(_interval - 1)) != 0) {
+			return false;
+		}
+
+		outDeltaTime = _accumulatedTime;
+		_accumulatedTime = 0.0f;
+		return true;
+	}
+
+	int UpdateRateLod::_CalculateInterval(const GameObject* object) {
+		const Camera* camera = object->GetScene()->MainCamera.get();
+		if (camera == nullptr) {
+			return 1;
+		}
+
+		// Refresh the shared camera state at most once per frame
+		uint64_t frame = Timing::Current().FrameCount();
+		if (frame != _cachedFrame || camera != _cachedCamera) {
+			_cachedFrame = frame;
+			_cachedCamera = camera;
+			_cachedCameraPos = camera->GetGameObject()->GetPosition();
+			_cachedFrustum = Frustum(camera->GetViewProjection());
+		}
+
+		const glm::vec3& position = object->GetPosition();
+		if (!_cachedFrustum.IntersectsSphere(position, BoundingRadius)) {
+			// Round down to a power of 2 (or 0) so ShouldTick can mask it
+			return HiddenInterval >= 8 ? 8 : HiddenInterval >= 4 ? 4 : HiddenInterval >= 2 ? 2 : glm::max(HiddenInterval, 0);
+		}
+
+		// Compare squared distances to avoid the sqrt
+		glm::vec3 toCamera = position - _cachedCameraPos;
+		float distSqr = glm::dot(toCamera, toCamera);
+		if (distSqr <= FullRateDistance * FullRateDistance)       return 1;
+		if (distSqr <= HalfRateDistance * HalfRateDistance)       return 2;
+		if (distSqr <= QuarterRateDistance * QuarterRateDistance) return 4;
+		if (distSqr <= EighthRateDistance * EighthRateDistance)   return 8;
+		return PauseBeyondRange ? 0 : 8;
+	}
+
+	void UpdateRateLod::RenderImGui() {
+		ImGui::PushID(this);
+		if (ImGui::CollapsingHeader("Update Rate LOD")) {
+			ImGui::Checkbox("Enabled", &Enabled);
+			LABEL_LEFT(ImGui::DragFloat, "Full Rate Dist   ", &FullRateDistance, 0.1f, 0.0f);
+			LABEL_LEFT(ImGui::DragFloat, "Half Rate Dist   ", &HalfRateDistance, 0.1f, 0.0f);
+			LABEL_LEFT(ImGui::DragFloat, "Quarter Rate Dist", &QuarterRateDistance, 0.1f, 0.0f);
+			LABEL_LEFT(ImGui::DragFloat, "Eighth Rate Dist ", &EighthRateDistance, 0.1f, 0.0f);
+			ImGui::Checkbox("Pause Beyond Range", &PauseBeyondRange);
+			LABEL_LEFT(ImGui::SliderInt, "Hidden Interval  ", &HiddenInterval, 0, 8);
+			LABEL_LEFT(ImGui::DragFloat, "Bounding Radius  ", &BoundingRadius, 0.1f, 0.0f);
+			ImGui::Text("Current interval: %d", _interval);
+		}
+		ImGui::PopID();
+	}
+
+	nlohmann::json UpdateRateLod::ToJson() const {
+		return {
+			{ "enabled", Enabled },
+			{ "full_rate_distance", FullRateDistance },
+			{ "half_rate_distance", HalfRateDistance },
+			{ "quarter_rate_distance", QuarterRateDistance },
+			{ "eighth_rate_distance", EighthRateDistance },
+			{ "pause_beyond_range", PauseBeyondRange },
+			{ "hidden_interval", HiddenInterval },
+			{ "bounding_radius", BoundingRadius }
+		};
+	}
+
+	void UpdateRateLod::LoadFromJson(const nlohmann::json& blob) {
+		if (!blob.is_object()) {
+			return;
+		}
+		Enabled             = JsonGet(blob, "enabled", Enabled);
+		FullRateDistance    = JsonGet(blob, "full_rate_distance", FullRateDistance);
+		HalfRateDistance    = JsonGet(blob, "half_rate_distance", HalfRateDistance);
+		QuarterRateDistance = JsonGet(blob, "quarter_rate_distance", QuarterRateDistance);
+		EighthRateDistance  = JsonGet(blob, "eighth_rate_distance", EighthRateDistance);
+		PauseBeyondRange    = JsonGet(blob, "pause_beyond_range", PauseBeyondRange);
+		HiddenInterval      = JsonGet(blob, "hidden_interval", HiddenInterval);
+		BoundingRadius      = JsonGet(blob, "bounding_radius", BoundingRadius);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <GLM/glm.hpp>
+#include "json.hpp"
+
+#include "Utils/Frustum.h"
+
+namespace Gameplay {
+	class GameObject;
+	class Camera;
+
+	/// <summary>
+	/// Per-component policy that lowers how often a behaviour ticks when its object is far
+	/// from the main camera or outside of its view. Components embed one of these and ask it
+	/// at the start of Update whether to run, and with how much accumulated time
+	///
+	/// Ticks are staggered between instances, so that objects sharing a rate don't all
+	/// land on the same frame
+	/// </summary>
+	class UpdateRateLod {
+	public:
+		// Set to false to always tick every frame
+		bool  Enabled;
+		// Distances from the camera up to which the component ticks every 1st, 2nd, 4th and 8th frame
+		float FullRateDistance;
+		float HalfRateDistance;
+		float QuarterRateDistance;
+		float EighthRateDistance;
+		// If true, components beyond EighthRateDistance stop ticking entirely, otherwise they keep
+		// ticking every 8th frame
+		bool  PauseBeyondRange;
+		// Frame interval to use when the object is outside of the camera's view, 0 to pause
+		int   HiddenInterval;
+		// Radius of the object's bounds, used when testing against the camera frustum
+		float BoundingRadius;
+
+		UpdateRateLod();
+
+		/// <summary>
+		/// Determines whether the owning component should tick this frame. Time from skipped frames
+		/// is accumulated and handed over when the component does tick, time spent paused is dropped
+		/// </summary>
+		/// <param name="object">The object that the component is attached to</param>
+		/// <param name="deltaTime">The time since the last frame, in seconds</param>
+		/// <param name="outDeltaTime">Receives the time since the component last ticked</param>
+		/// <returns>True if the component should update this frame</returns>
+		bool ShouldTick(const GameObject* object, float deltaTime, float& outDeltaTime);
+
+		/// <summary>
+		/// Gets the frame interval chosen on the last call to ShouldTick, 0 if paused
+		/// </summary>
+		int GetInterval() const { return _interval; }
+
+		void RenderImGui();
+		nlohmann::json ToJson() const;
+		/// <summary>
+		/// Loads the policy from a JSON blob, keeping the current values for any missing keys
+		/// </summary>
+		void LoadFromJson(const nlohmann::json& blob);
+
+	private:
+		float    _accumulatedTime;
+		int      _interval;
+		uint32_t _staggerOffset;
+
+		// Used to hand out stagger offsets to new instances
+		static uint32_t _nextStaggerOffset;
+
+		// The camera state is shared by all instances, so only calculate it once per frame
+		static uint64_t      _cachedFrame;
+		static const Camera* _cachedCamera;
+		static glm::vec3     _cachedCameraPos;
+		static Frustum       _cachedFrustum;
+
+		int _CalculateInterval(const GameObject* object);
+	};
+}
@@ -1,5 +1,8 @@
 #include "UniformBuffer.h"
 #include "Logging.h"
+#include <algorithm>
+
+uint64_t AbstractUniformBuffer::_totalBytesUploaded = 0;
 
 AbstractUniformBuffer::~AbstractUniformBuffer() {
 	delete[] _rawData;
@@ -7,7 +10,9 @@ AbstractUniformBuffer::~AbstractUniformBuffer() {
 
 AbstractUniformBuffer::AbstractUniformBuffer(uint32_t sizeInBytes, BufferUsage usage /*= BufferUsage::DynamicDraw*/) :
 	IBuffer(BufferType::Uniform, usage),
-	_rawData(nullptr)
+	_rawData(nullptr),
+	_dirtyRanges(),
+	_bytesUploaded(0)
 {
 	_rawData = new uint8_t[sizeInBytes];
 	_size = sizeInBytes;
@@ -21,7 +26,11 @@ void AbstractUniformBuffer::LoadData(const void* data, uint32_t elementSize, uin
 	// Copy data from the data given to our internal buffer
 	memcpy(_rawData, data, dataSize);
 	// Upload data to the OpenGL buffer
-	glNamedBufferSubData(_rendererId, 0, dataSize, _rawData);
+	_Upload(0, (uint32_t)dataSize);
+	// Anything dirty past the end of the new data still needs to go up
+	if (dataSize >= _size) {
+		_dirtyRanges.clear();
+	}
 }
 
 void AbstractUniformBuffer::Bind() const {
@@ -33,3 +42,57 @@ void AbstractUniformBuffer::Bind(int slot) const
 	glBindBufferBase(GL_UNIFORM_BUFFER, slot, _rendererId);
 }
 
+void AbstractUniformBuffer::MarkDirty(uint32_t offset, uint32_t size) {
+	LOG_ASSERT(offset + size <= _size, "Dirty range exceeds the bounds of this UBO");
+	if (size == 0) return;
+
+	DirtyRange range = { offset, offset + size };
+
+	// Find the first range that could touch ours, then swallow every range that overlaps
+	// or sits within the merge gap
+	auto it = std::lower_bound(_dirtyRanges.begin(), _dirtyRanges.end(), range, [](const DirtyRange& a, const DirtyRange& b) {
+		return a.End + MERGE_GAP < b.Begin;
+	});
+	auto end = it;
+	while (end != _dirtyRanges.end() && end->Begin <= range.End + MERGE_GAP) {
+		range.Begin = std::min(range.Begin, end->Begin);
+		range.End = std::max(range.End, end->End);
+		end++;
+	}
+	it = _dirtyRanges.erase(it, end);
+	_dirtyRanges.insert(it, range);
+
+	if (_dirtyRanges.size() > MAX_RANGES) {
+		DirtyRange all = { _dirtyRanges.front().Begin, _dirtyRanges.back().End };
+		_dirtyRanges.clear();
+		_dirtyRanges.push_back(all);
+	}
+}
+
+void AbstractUniformBuffer::MarkDirty(const void* ptr, uint32_t size) {
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(ptr);
+	LOG_ASSERT(bytes >= _rawData && bytes < _rawData + _size, "Pointer is not within this UBO");
+	MarkDirty((uint32_t)(bytes - _rawData), size);
+}
+
+void AbstractUniformBuffer::MarkAllDirty() {
+	_dirtyRanges.clear();
+	_dirtyRanges.push_back({ 0, _size });
+}
+
+uint32_t AbstractUniformBuffer::Flush() {
+	uint32_t total = 0;
+	for (const DirtyRange& range : _dirtyRanges) {
+		_Upload(range.Begin, range.End - range.Begin);
+		total += range.End - range.Begin;
+	}
+	_dirtyRanges.clear();
+	return total;
+}
+
+void AbstractUniformBuffer::_Upload(uint32_t offset, uint32_t size) {
+	glNamedBufferSubData(_rendererId, offset, size, _rawData + offset);
+	_bytesUploaded += size;
+	_totalBytesUploaded += size;
+}
+
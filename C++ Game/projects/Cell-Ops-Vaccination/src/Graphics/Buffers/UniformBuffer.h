@@ -1,6 +1,8 @@
 #pragma once
 #include "IBuffer.h"
 #include <memory>
+#include <vector>
+#include <cstring>
 
 /// <summary>
 /// A uniform buffer that operates on raw data
@@ -41,10 +43,68 @@ public :
 	/// <param name="slot">The buffer binding slot to bind to</param>
 	void Bind(int slot) const;
 
+	/// <summary>
+	/// Marks a range of the buffer as modified, so that it will be sent to
+	/// OpenGL on the next Flush. Nearby ranges are merged together
+	/// </summary>
+	/// <param name="offset">The offset of the range, in bytes</param>
+	/// <param name="size">The size of the range, in bytes</param>
+	void MarkDirty(uint32_t offset, uint32_t size);
+	/// <summary>
+	/// Marks the memory at the given pointer as modified, the pointer must point into
+	/// this buffer's data
+	/// </summary>
+	void MarkDirty(const void* ptr, uint32_t size);
+	/// <summary>
+	/// Marks the entire buffer as modified
+	/// </summary>
+	void MarkAllDirty();
+
+	/// <summary>
+	/// Returns true if there are any modified ranges waiting to be uploaded
+	/// </summary>
+	bool IsDirty() const { return !_dirtyRanges.empty(); }
+
+	/// <summary>
+	/// Uploads only the modified ranges of the buffer to OpenGL, does nothing
+	/// if the buffer is clean
+	/// </summary>
+	/// <returns>The number of bytes that were uploaded</returns>
+	uint32_t Flush();
+
+	/// <summary>
+	/// Gets the total number of bytes this buffer has uploaded since it was created
+	/// </summary>
+	uint64_t GetBytesUploaded() const { return _bytesUploaded; }
+	/// <summary>
+	/// Gets the total number of bytes all uniform buffers have uploaded, useful
+	/// for measuring upload volume per frame
+	/// </summary>
+	static uint64_t GetTotalBytesUploaded() { return _totalBytesUploaded; }
+
 protected:
+	// Ranges further apart than this get uploaded separately, closer ones are merged
+	// since a few extra bytes are cheaper than another driver call
+	static const uint32_t MERGE_GAP = 64;
+	// Past this many separate ranges, we collapse them into one span
+	static const uint32_t MAX_RANGES = 8;
+
+	struct DirtyRange {
+		uint32_t Begin;
+		uint32_t End;
+	};
+
 	// Will contain the backing data store for the buffer
 	uint8_t* _rawData;
 	uint32_t _size;
+
+	// Sorted, non-overlapping ranges that have changed since the last upload
+	std::vector<DirtyRange> _dirtyRanges;
+	uint64_t _bytesUploaded;
+
+	static uint64_t _totalBytesUploaded;
+
+	void _Upload(uint32_t offset, uint32_t size);
 };
 
 /// <summary>
@@ -102,11 +162,69 @@ public:
 		Update();
 	}
 
+	/// <summary>
+	/// Sets a single field in the structure, marking it as dirty only if the
+	/// value actually changed. Call Flush to send changes to OpenGL
+	/// </summary>
+	/// <param name="member">The field to set, ex: &amp;MyStruct::Color</param>
+	/// <param name="value">The new value for the field</param>
+	template <typename T>
+	void Set(T Structure::* member, const T& value) {
+		T& field = GetData().*member;
+		if (memcmp(&field, &value, sizeof(T)) != 0) {
+			field = value;
+			MarkDirty(&field, sizeof(T));
+		}
+	}
+
+	/// <summary>
+	/// Sets a single element of an array field, marking it as dirty only if the
+	/// value actually changed. Call Flush to send changes to OpenGL
+	/// </summary>
+	/// <param name="member">The array field, ex: &amp;MyStruct::Lights</param>
+	/// <param name="index">The index of the element to set</param>
+	/// <param name="value">The new value for the element</param>
+	template <typename T, size_t N>
+	void SetElement(T (Structure::* member)[N], size_t index, const T& value) {
+		T& element = (GetData().*member)[index];
+		if (memcmp(&element, &value, sizeof(T)) != 0) {
+			element = value;
+			MarkDirty(&element, sizeof(T));
+		}
+	}
+
+	/// <summary>
+	/// Gets a field in the structure for modification, marking it as dirty.
+	/// Call Flush to send changes to OpenGL
+	/// </summary>
+	/// <param name="member">The field to modify, ex: &amp;MyStruct::Color</param>
+	template <typename T>
+	T& Modify(T Structure::* member) {
+		T& field = GetData().*member;
+		MarkDirty(&field, sizeof(T));
+		return field;
+	}
+
+	/// <summary>
+	/// Gets a single element of an array field for modification, marking only that
+	/// element as dirty. Call Flush to send changes to OpenGL
+	/// </summary>
+	/// <param name="member">The array field, ex: &amp;MyStruct::Lights</param>
+	/// <param name="index">The index of the element to modify</param>
+	template <typename T, size_t N>
+	T& ModifyElement(T (Structure::* member)[N], size_t index) {
+		T& element = (GetData().*member)[index];
+		MarkDirty(&element, sizeof(T));
+		return element;
+	}
+
 	/// <summary>
 	/// Notifies OpenGL that the data has been updated and requires
-	/// a resync with the GL side buffer
+	/// a resync with the GL side buffer. This always sends the entire
+	/// structure, prefer Set/Modify and Flush when only some fields change
 	/// </summary>
 	void Update() {
-		glNamedBufferSubData(_rendererId, 0, sizeof(Structure), _rawData);
+		MarkAllDirty();
+		Flush();
 	}
 };
@@ -124,6 +124,10 @@ public:
 	/// Set the view projection matrix used by this debug drawer
 	/// </summary>
 	void SetViewProjection(const glm::mat4& viewProjection);
+	/// <summary>
+	/// Gets the view projection matrix used by this debug drawer
+	/// </summary>
+	const glm::mat4& GetViewProjection() const { return _viewProjection; }
 
 protected:
 	DebugDrawer();
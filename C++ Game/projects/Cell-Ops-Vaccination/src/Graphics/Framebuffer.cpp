@@ -1,5 +1,7 @@
 #include "Graphics/Framebuffer.h"
 
+#include <algorithm>
+
 #include "Graphics/RenderBuffer.h"
 #include "Utils/JsonGlmHelpers.h"
 
@@ -95,6 +97,17 @@ void Framebuffer::Resize(uint32_t width, uint32_t height) {
 		_description.Width  = width;
 		_description.Height = height;
 
+		// Borrowed targets are the wrong size now, their owners will have to attach new ones
+		std::vector<RenderTargetAttachment> borrowed;
+		for (const auto& kvp : _targets) {
+			if (kvp.second.IsBorrowed) {
+				borrowed.push_back(kvp.first);
+			}
+		}
+		for (RenderTargetAttachment attachment : borrowed) {
+			Detach(attachment);
+		}
+
 		// Re-attach all our rendertargets (releasing our references and re-creating them)
 		for (const auto& kvp : _targets) {
 			_AddAttachment(kvp.first, kvp.second.Description);
@@ -127,32 +140,44 @@ void Framebuffer::_AddAttachment(RenderTargetAttachment attachment, const Render
 	RenderTarget& buffer = _targets[attachment];
 	buffer.Description = target;
 	buffer.IsRenderBuffer = !target.UseTexture;
+	buffer.IsBorrowed = false;
+	buffer.Resource = CreateRenderTarget(GetSize(), _description.SampleCount, target);
 
-	// Handle creating render buffers 
+	// Handle attaching render buffers 
 	if (buffer.IsRenderBuffer) {
-		RenderbufferDescription descriptor = RenderbufferDescription();
-		// Per-framebuffer parameters
-		descriptor.Width            = _description.Width;
-		descriptor.Height           = _description.Height;
-		descriptor.MultisampleCount = _description.SampleCount;
+		glNamedFramebufferRenderbuffer(_rendererId, *attachment, GL_RENDERBUFFER, buffer.Resource->GetHandle());
+	}
+	// It's a texture
+	else {
+		// Attach texture to the framebuffer
+		glNamedFramebufferTexture(_rendererId, *attachment, buffer.Resource->GetHandle(), 0);
 
-		// Per-attachment parameters
-		descriptor.Format = target.Format;
+		// If this is a multisampled framebuffer and we want an unsampled version
+		// we'll need to create another texture
+		if (_description.SampleCount > 1 && _description.GenerateUnsampled) {
+			_unsampledFramebuffer->_AddAttachment(attachment, target);
+		}
+	}
+}
 
-		// Create and store the render buffer
-		buffer.Resource = std::make_shared<Renderbuffer>(descriptor);
-		glNamedFramebufferRenderbuffer(_rendererId, *attachment, GL_RENDERBUFFER, buffer.Resource->GetHandle());
+IGraphicsResource::Sptr Framebuffer::CreateRenderTarget(const glm::ivec2& size, uint8_t samples, const RenderTargetDescriptor& target) {
+	// Handle creating render buffers 
+	if (!target.UseTexture) {
+		RenderbufferDescription descriptor = RenderbufferDescription();
+		descriptor.Width            = size.x;
+		descriptor.Height           = size.y;
+		descriptor.MultisampleCount = samples;
+		descriptor.Format           = target.Format;
+
+		return std::make_shared<Renderbuffer>(descriptor);
 	}
 	// It's a texture
 	else {
 		Texture2DDescription descriptor = Texture2DDescription();
-		// Per-framebuffer parameters
-		descriptor.Width            = _description.Width;
-		descriptor.Height           = _description.Height;
-		descriptor.MultisampleCount = _description.SampleCount;
-
-		// Per-attachment parameters
-		descriptor.Format = (InternalFormat)target.Format;
+		descriptor.Width            = size.x;
+		descriptor.Height           = size.y;
+		descriptor.MultisampleCount = samples;
+		descriptor.Format           = (InternalFormat)target.Format;
 
 		// Common parameters
 		descriptor.GenerateMipMaps    = false;
@@ -160,18 +185,41 @@ void Framebuffer::_AddAttachment(RenderTargetAttachment attachment, const Render
 		descriptor.HorizontalWrap     = WrapMode::ClampToEdge;
 		descriptor.VerticalWrap       = WrapMode::ClampToEdge;
 
-		// Create image and store in the buffer
-		Texture2D::Sptr image = std::make_shared<Texture2D>(descriptor);
-		buffer.Resource = image;
+		return std::make_shared<Texture2D>(descriptor);
+	}
+}
 
-		// Attach texture to the framebuffer
-		glNamedFramebufferTexture(_rendererId, *attachment, image->GetHandle(), 0);
+void Framebuffer::Attach(RenderTargetAttachment attachment, const IGraphicsResource::Sptr& resource) {
+	LOG_ASSERT(resource != nullptr, "Cannot attach a null resource, use Detach instead");
 
-		// If this is a multisampled framebuffer and we want an unsampled version
-		// we'll need to create another texture
-		if (_description.SampleCount > 1 && _description.GenerateUnsampled) {
-			_unsampledFramebuffer->_AddAttachment(attachment, target);
-		}
+	RenderTarget& buffer = _targets[attachment];
+	buffer.Resource = resource;
+	buffer.IsRenderBuffer = resource->GetResourceClass() == GlResourceType::RenderBuffer;
+	buffer.IsBorrowed = true;
+	buffer.Description.UseTexture = !buffer.IsRenderBuffer;
+
+	if (buffer.IsRenderBuffer) {
+		buffer.Description.Format = std::static_pointer_cast<Renderbuffer>(resource)->GetFormat();
+		glNamedFramebufferRenderbuffer(_rendererId, *attachment, GL_RENDERBUFFER, resource->GetHandle());
+	} else {
+		buffer.Description.Format = (RenderTargetType)std::static_pointer_cast<Texture2D>(resource)->GetFormat();
+		glNamedFramebufferTexture(_rendererId, *attachment, resource->GetHandle(), 0);
+	}
+}
+
+void Framebuffer::Detach(RenderTargetAttachment attachment) {
+	auto it = _targets.find(attachment);
+	if (it == _targets.end()) {
+		return;
+	}
+
+	// A texture name of 0 detaches whatever is attached, renderbuffers included
+	glNamedFramebufferTexture(_rendererId, *attachment, 0, 0);
+	_targets.erase(it);
+
+	auto drawBuffer = std::find(_drawBuffers.begin(), _drawBuffers.end(), attachment);
+	if (drawBuffer != _drawBuffers.end()) {
+		_drawBuffers.erase(drawBuffer);
 	}
 }
 
@@ -222,6 +270,14 @@ bool Framebuffer::BindAttachment(RenderTargetAttachment attachment, int slot) co
 	return false;
 }
 
+void Framebuffer::SetDrawBuffers(const std::vector<RenderTargetAttachment>& buffers) {
+	glNamedFramebufferDrawBuffers(_rendererId, (GLsizei)buffers.size(), reinterpret_cast<const GLenum*>(buffers.data()));
+}
+
+void Framebuffer::ResetDrawBuffers() {
+	SetDrawBuffers(_drawBuffers);
+}
+
 void Framebuffer::Bind(FramebufferBinding bindMode /*= FramebufferBinding::Draw*/) const {
 	_currentBinding = bindMode;
 	glBindFramebuffer(*bindMode, _rendererId);
@@ -319,6 +375,10 @@ void Framebuffer::SetDebugName(const std::string& name) {
 
 	// We'll also update the name for all our children
 	for (const auto& attachment : _targets) {
+		// Borrowed targets get named by whoever owns them
+		if (attachment.second.IsBorrowed) {
+			continue;
+		}
 		static char buffer[256];
 		sprintf_s(buffer, 256, "%s_%s", name.c_str(), (~attachment.first).c_str());
 		attachment.second.Resource->SetDebugName(buffer);
@@ -340,6 +400,11 @@ nlohmann::json Framebuffer::ToJson() const {
 
 	// Iterate over our attachments and serialize them
 	for (const auto& kvp : _targets) {
+		// Borrowed targets belong to someone else, they aren't part of our configuration
+		if (kvp.second.IsBorrowed) {
+			continue;
+		}
+
 		// We'll create a separate JSON object for the RenderTargetDescriptor
 		nlohmann::json attachmentInfo = nlohmann::json();
 		attachmentInfo["use-texture"] = kvp.second.Description.UseTexture;
@@ -386,5 +451,6 @@ Framebuffer::Sptr Framebuffer::FromJson(const nlohmann::json& blob) {
 Framebuffer::RenderTarget::RenderTarget() :
 	Resource(nullptr),
 	IsRenderBuffer(false),
+	IsBorrowed(false),
 	Description(RenderTargetDescriptor())
 { }
@@ -96,6 +96,23 @@ public:
 	 */
 	void Resize(const glm::ivec2& size);
 
+	/**
+	 * Attaches a texture or renderbuffer that is owned by something else, such as a target borrowed
+	 * from the RenderTargetPool. Borrowed attachments are not recreated when the framebuffer is resized
+	 * (they are detached instead), and are not part of the default draw buffers, so use SetDrawBuffers
+	 * to draw to them
+	 *
+	 * @param attachment The attachment point to attach to, replacing anything that is already there
+	 * @param resource   The texture or renderbuffer to attach, should be the same size as the framebuffer
+	 */
+	void Attach(RenderTargetAttachment attachment, const IGraphicsResource::Sptr& resource);
+	/**
+	 * Removes the texture or renderbuffer at the given attachment point, if there is one
+	 *
+	 * @param attachment The attachment point to clear
+	 */
+	void Detach(RenderTargetAttachment attachment);
+
 	/**
 	 * Validates the framebuffer and returns true if it is ready for use in rendering
 	 */
@@ -110,6 +127,19 @@ public:
 	 */
 	bool BindAttachment(RenderTargetAttachment attachment, int slot) const;
 
+	/**
+	 * Selects which color attachments fragment shader outputs are written to. Output location N
+	 * is written to the Nth attachment in the list, use Unknown to discard an output
+	 *
+	 * @param buffers The attachments to draw to, in output location order
+	 */
+	void SetDrawBuffers(const std::vector<RenderTargetAttachment>& buffers);
+	/**
+	 * Restores the default draw buffers, where every color attachment is drawn to in the
+	 * order they were added
+	 */
+	void ResetDrawBuffers();
+
 	/**
 	 * Binds this framebuffer to the given framebuffer binding slot
 	 * 
@@ -144,6 +174,15 @@ public:
 	 */
 	static void Blit(const glm::ivec4& srcBounds, const glm::ivec4& dstBounds, BufferFlags flags = BufferFlags::All, MagFilter filter = MagFilter::Linear);
 
+	/**
+	 * Creates a texture or renderbuffer that can be attached to a framebuffer
+	 *
+	 * @param size    The size of the render target in pixels
+	 * @param samples The number of samples per pixel, 1 for no multisampling
+	 * @param target  Describes the format of the target, and whether it is a texture or renderbuffer
+	 */
+	static IGraphicsResource::Sptr CreateRenderTarget(const glm::ivec2& size, uint8_t samples, const RenderTargetDescriptor& target);
+
 	/**
 	 * Creates a copy of this framebuffer's configuration. Note that this copy will
 	 * contain empty textures and renderbuffers
@@ -182,6 +221,8 @@ protected:
 		IGraphicsResource::Sptr Resource;
 		// True if the resource is a renderbuffer, false for textures
 		bool                    IsRenderBuffer;
+		// True if the resource was attached with Attach, and is owned by someone else
+		bool                    IsBorrowed;
 		// The descriptor for this render target
 		RenderTargetDescriptor  Description;
 
@@ -17,6 +17,7 @@ ENUM(ShaderPartType, GLint,
 	 TessControl  = GL_TESS_CONTROL_SHADER,
 	 TessEval     = GL_TESS_EVALUATION_SHADER,
 	 Geometry     = GL_GEOMETRY_SHADER,
+	 Compute      = GL_COMPUTE_SHADER,
 	 Unknown      = GL_NONE // Usually good practice to have an "unknown" or "none" state for enums
 )
 
@@ -862,8 +863,10 @@ ENUM(RenderTargetType, uint32_t,
 	 ColorRgb8    = GL_RGB8,
 	 ColorRG8     = GL_RG8,
 	 ColorRed8    = GL_R8,
+	 ColorRed16F  = GL_R16F,
 	 ColorRgb16F  = GL_RGB16F,
 	 ColorRgba16F = GL_RGBA16F,
+	 ColorRg16F   = GL_RG16F,
 	 DepthStencil = GL_DEPTH24_STENCIL8,
 	 Depth16      = GL_DEPTH_COMPONENT16,
 	 Depth24      = GL_DEPTH_COMPONENT24,
@@ -0,0 +1,144 @@
+#include "Graphics/GlUploadThread.h"
+
+#include <GLFW/glfw3.h>
+
+#include "Logging.h"
+
+GLFWwindow*                           GlUploadThread::_context = nullptr;
+std::thread                           GlUploadThread::_worker;
+bool                                  GlUploadThread::_isStopping = false;
+std::mutex                            GlUploadThread::_mutex;
+std::condition_variable               GlUploadThread::_jobReady;
+std::deque<GlUploadThread::PendingJob> GlUploadThread::_jobs;
+std::vector<GlUploadThread::Completion> GlUploadThread::_finished;
+std::vector<GlUploadThread::Completion> GlUploadThread::_inFlight;
+
+bool GlUploadThread::Init(GLFWwindow* mainWindow) {
+	if (_context != nullptr) {
+		return true;
+	}
+
+	// GLFW only lets us make a context along with a window, so we make a tiny hidden one
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	_context = glfwCreateWindow(1, 1, "Upload Context", nullptr, mainWindow);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+	if (_context == nullptr) {
+		LOG_WARN("Failed to create a shared context for the upload thread, uploads will happen on the main thread");
+		return false;
+	}
+
+	_isStopping = false;
+	_worker = std::thread(&GlUploadThread::_WorkerMain);
+	LOG_INFO("Started GL upload thread");
+	return true;
+}
+
+void GlUploadThread::Shutdown() {
+	if (_context == nullptr) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+		_jobs.clear();
+	}
+	_jobReady.notify_one();
+	_worker.join();
+
+	// The fences are shared between the contexts, so we can clean them up from here
+	for (Completion& completion : _finished) {
+		glDeleteSync(completion.Fence);
+	}
+	for (Completion& completion : _inFlight) {
+		glDeleteSync(completion.Fence);
+	}
+	_finished.clear();
+	_inFlight.clear();
+
+	glfwDestroyWindow(_context);
+	_context = nullptr;
+}
+
+bool GlUploadThread::IsEnabled() {
+	return _context != nullptr;
+}
+
+void GlUploadThread::Submit(const Job& job, const Job& onComplete) {
+	if (!IsEnabled()) {
+		job();
+		if (onComplete) {
+			onComplete();
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_jobs.push_back(PendingJob{ job, onComplete });
+	}
+	_jobReady.notify_one();
+}
+
+void GlUploadThread::Poll() {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (Completion& completion : _finished) {
+			_inFlight.push_back(std::move(completion));
+		}
+		_finished.clear();
+	}
+
+	// Fences complete in order, so we can stop at the first one that hasn't been reached
+	size_t completed = 0;
+	for (; completed < _inFlight.size(); completed++) {
+		Completion& completion = _inFlight[completed];
+		GLenum status = glClientWaitSync(completion.Fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+			break;
+		}
+		glDeleteSync(completion.Fence);
+		if (completion.OnComplete) {
+			completion.OnComplete();
+		}
+	}
+	_inFlight.erase(_inFlight.begin(), _inFlight.begin() + completed);
+}
+
+size_t GlUploadThread::GetPendingCount() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _jobs.size() + _finished.size() + _inFlight.size();
+}
+
+void GlUploadThread::_WorkerMain() {
+	// GL function pointers are shared by the contexts, so we don't need to load glad again
+	glfwMakeContextCurrent(_context);
+
+	while (true) {
+		PendingJob job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobReady.wait(lock, []() { return _isStopping || !_jobs.empty(); });
+			if (_isStopping) break;
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		job.Work();
+
+		// Flushing makes sure the fence actually gets to the GPU, otherwise the main thread could
+		// be waiting on it forever
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_finished.push_back(Completion{ fence, job.OnComplete });
+	}
+
+	glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <glad/glad.h>
+
+struct GLFWwindow;
+
+/// <summary>
+/// Runs GL resource creation and uploads on a background thread with its own context, which
+/// shares objects with the main context. This keeps big texture and buffer uploads (and
+/// mipmap generation) from competing with rendering on the main thread.
+///
+/// Each job is followed by a fence, and the job's completion callback is only run on the
+/// main thread once the GPU has passed that fence, so the main thread never has to wait
+/// on the upload to start using the results.
+///
+/// Only buffers, textures, samplers and other shareable objects may be created in jobs,
+/// container objects like VAOs and framebuffers belong to the context that made them and
+/// must be created in the completion callback instead
+/// </summary>
+class GlUploadThread {
+public:
+	GlUploadThread() = delete;
+
+	typedef std::function<void()> Job;
+
+	/// <summary>
+	/// Creates the upload context and starts the thread, must be called from the main thread
+	/// after the main window has been created
+	/// </summary>
+	/// <param name="mainWindow">The window whose context the upload context will share objects with</param>
+	/// <returns>True if the upload thread was started</returns>
+	static bool Init(GLFWwindow* mainWindow);
+	/// <summary>
+	/// Stops the upload thread and destroys its context, any uploads that have not completed
+	/// are dropped. Must be called from the main thread before the main window is destroyed
+	/// </summary>
+	static void Shutdown();
+
+	/// <summary>
+	/// Returns true if the upload thread is running. When it isn't, jobs run immediately on the
+	/// calling thread instead
+	/// </summary>
+	static bool IsEnabled();
+
+	/// <summary>
+	/// Queues some GL work to run on the upload thread
+	/// </summary>
+	/// <param name="job">The work to perform on the upload context, must not touch state that the main thread uses</param>
+	/// <param name="onComplete">Invoked on the main thread once the GPU has finished the job, may be null</param>
+	static void Submit(const Job& job, const Job& onComplete = nullptr);
+
+	/// <summary>
+	/// Invokes the completion callbacks for any jobs that the GPU has finished. This never waits
+	/// on the GPU, should be called once per frame from the main thread
+	/// </summary>
+	static void Poll();
+
+	/// <summary>
+	/// Gets the number of jobs that have been submitted but have not completed yet
+	/// </summary>
+	static size_t GetPendingCount();
+
+private:
+	struct Completion {
+		GLsync Fence;
+		Job    OnComplete;
+	};
+	struct PendingJob {
+		Job Work;
+		Job OnComplete;
+	};
+
+	static GLFWwindow*             _context;
+	static std::thread             _worker;
+	static bool                    _isStopping;
+
+	// Shared with the worker thread, guarded by _mutex
+	static std::mutex              _mutex;
+	static std::condition_variable _jobReady;
+	static std::deque<PendingJob>  _jobs;
+	static std::vector<Completion> _finished;
+
+	// Only touched from the main thread, jobs the worker has finished but the GPU might not have
+	static std::vector<Completion> _inFlight;
+
+	static void _WorkerMain();
+};
@@ -0,0 +1,167 @@
+#include "Graphics/GpuReadback.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+std::vector<GpuReadback::StagingBuffer> GpuReadback::_freeBuffers;
+std::deque<GpuReadback::Request>        GpuReadback::_pending;
+uint64_t                                GpuReadback::_frameIndex = 0;
+uint32_t                                GpuReadback::_blockingReadsThisFrame = 0;
+GpuReadback::Stats                      GpuReadback::_stats = { 0, 0, 0, 0.0f, 0, 0 };
+
+namespace {
+	// Staging buffers are rounded up to a power of two so they can be reused for similar sized reads
+	const size_t MinStagingSize = 256;
+	// How many unused staging buffers we keep around before we start freeing them
+	const size_t MaxFreeBuffers = 16;
+
+	size_t RoundUpPow2(size_t value) {
+		size_t result = MinStagingSize;
+		while (result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+}
+
+void GpuReadback::ReadBuffer(uint32_t buffer, size_t offset, size_t size, const Callback& callback) {
+	if (size == 0) {
+		return;
+	}
+	StagingBuffer staging = _AcquireStaging(size);
+	glCopyNamedBufferSubData(buffer, staging.Handle, offset, 0, size);
+	_Submit(staging, size, callback);
+}
+
+void GpuReadback::ReadQuery(uint32_t query, const std::function<void(uint32_t)>& callback) {
+	StagingBuffer staging = _AcquireStaging(sizeof(GLuint));
+	// Writing the result into a buffer makes the GPU wait on the query instead of us
+	glGetQueryBufferObjectuiv(query, staging.Handle, GL_QUERY_RESULT, 0);
+	_Submit(staging, sizeof(GLuint), [callback](const void* data, size_t) {
+		callback(*reinterpret_cast<const GLuint*>(data));
+	});
+}
+
+void GpuReadback::ReadTexture(uint32_t texture, int level, int x, int y, int width, int height, PixelFormat format, PixelType type, const Callback& callback) {
+	size_t size = GetTexelSize(format, type) * width * height;
+	if (size == 0) {
+		return;
+	}
+	StagingBuffer staging = _AcquireStaging(size);
+
+	// With a pack buffer bound, the "pixels" pointer becomes an offset into that buffer
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, staging.Handle);
+	glGetTextureSubImage(texture, level, x, y, 0, width, height, 1, *format, *type, (GLsizei)size, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	_Submit(staging, size, callback);
+}
+
+void GpuReadback::ReadBufferBlocking(uint32_t buffer, size_t offset, size_t size, void* result) {
+	glGetNamedBufferSubData(buffer, offset, size, result);
+	_blockingReadsThisFrame++;
+	_stats.BlockingReads++;
+}
+
+void GpuReadback::Poll() {
+	_frameIndex++;
+	_stats.BlockingReadsLastFrame = _blockingReadsThisFrame;
+	_blockingReadsThisFrame = 0;
+
+	// Fences are signaled in order, so we can stop at the first one the GPU hasn't reached
+	while (!_pending.empty()) {
+		Request& request = _pending.front();
+		GLenum status = glClientWaitSync(request.Fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+			break;
+		}
+		glDeleteSync(request.Fence);
+
+		// Pop before invoking, callbacks are allowed to queue more reads
+		Request done = std::move(request);
+		_pending.pop_front();
+
+		float latency = (float)(_frameIndex - done.QueuedFrame);
+		_stats.AverageLatencyFrames = _stats.Completed == 0 ? latency : _stats.AverageLatencyFrames + (latency - _stats.AverageLatencyFrames) * 0.05f;
+		_stats.Completed++;
+		_stats.BytesRead += done.Size;
+
+		if (done.OnComplete) {
+			done.OnComplete(done.Staging.Mapped, done.Size);
+		}
+		_ReleaseStaging(done.Staging);
+	}
+	_stats.Pending = _pending.size();
+}
+
+void GpuReadback::Shutdown() {
+	for (Request& request : _pending) {
+		glDeleteSync(request.Fence);
+		glDeleteBuffers(1, &request.Staging.Handle);
+	}
+	_pending.clear();
+	for (StagingBuffer& staging : _freeBuffers) {
+		glDeleteBuffers(1, &staging.Handle);
+	}
+	_freeBuffers.clear();
+	_stats.Pending = 0;
+}
+
+const GpuReadback::Stats& GpuReadback::GetStats() {
+	return _stats;
+}
+
+GpuReadback::StagingBuffer GpuReadback::_AcquireStaging(size_t size) {
+	// Take the smallest free buffer that fits
+	auto best = _freeBuffers.end();
+	for (auto it = _freeBuffers.begin(); it != _freeBuffers.end(); it++) {
+		if (it->Capacity >= size && (best == _freeBuffers.end() || it->Capacity < best->Capacity)) {
+			best = it;
+		}
+	}
+	if (best != _freeBuffers.end()) {
+		StagingBuffer result = *best;
+		_freeBuffers.erase(best);
+		return result;
+	}
+
+	// Persistent + coherent mapping means we never have to map or unmap, once the fence has
+	// been signaled the data can be read straight out of the pointer
+	const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	StagingBuffer result;
+	result.Capacity = RoundUpPow2(size);
+	glCreateBuffers(1, &result.Handle);
+	glNamedBufferStorage(result.Handle, result.Capacity, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+	result.Mapped = glMapNamedBufferRange(result.Handle, 0, result.Capacity, flags);
+	return result;
+}
+
+void GpuReadback::_ReleaseStaging(const StagingBuffer& staging) {
+	if (_freeBuffers.size() >= MaxFreeBuffers) {
+		// Drop the smallest buffer, the bigger ones are more expensive to re-create
+		auto smallest = std::min_element(_freeBuffers.begin(), _freeBuffers.end(), [](const StagingBuffer& a, const StagingBuffer& b) {
+			return a.Capacity < b.Capacity;
+		});
+		if (smallest->Capacity > staging.Capacity) {
+			glDeleteBuffers(1, &staging.Handle);
+			return;
+		}
+		glDeleteBuffers(1, &smallest->Handle);
+		_freeBuffers.erase(smallest);
+	}
+	_freeBuffers.push_back(staging);
+}
+
+void GpuReadback::_Submit(const StagingBuffer& staging, size_t size, const Callback& callback) {
+	Request request;
+	request.Staging     = staging;
+	request.Fence       = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	request.Size        = size;
+	request.OnComplete  = callback;
+	request.QueuedFrame = _frameIndex;
+	_pending.push_back(std::move(request));
+	_stats.Pending = _pending.size();
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <glad/glad.h>
+
+#include "Graphics/GlEnums.h"
+
+/// <summary>
+/// Reads data back from the GPU without stalling the pipeline. Requests are copied into a
+/// pooled, persistently mapped staging buffer and fenced, then the callback is invoked from
+/// Poll a few frames later once the GPU has actually finished the copy.
+///
+/// Staging buffers are recycled between requests, so steady state readbacks (like a query
+/// read every frame) don't allocate any GL objects.
+///
+/// All functions must be called from the main thread
+/// </summary>
+class GpuReadback {
+public:
+	GpuReadback() = delete;
+
+	/// <summary>
+	/// Invoked with the data that was read back, the pointer is only valid for the duration of the call
+	/// </summary>
+	typedef std::function<void(const void* data, size_t size)> Callback;
+
+	/// <summary>
+	/// Statistics about the readbacks that have been performed
+	/// </summary>
+	struct Stats {
+		// Number of requests waiting on the GPU
+		size_t   Pending;
+		// Total number of requests that have been delivered
+		uint64_t Completed;
+		// Total number of bytes that have been delivered
+		uint64_t BytesRead;
+		// Rolling average of the number of frames between a request and its delivery
+		float    AverageLatencyFrames;
+		// Total number of blocking reads, and the number performed during the last frame
+		uint64_t BlockingReads;
+		uint32_t BlockingReadsLastFrame;
+	};
+
+	/// <summary>
+	/// Queues a read of a range of a buffer
+	/// </summary>
+	/// <param name="buffer">The GL handle of the buffer to read from</param>
+	/// <param name="offset">The offset in bytes to start reading from</param>
+	/// <param name="size">The number of bytes to read</param>
+	/// <param name="callback">Invoked with the data once it is available</param>
+	static void ReadBuffer(uint32_t buffer, size_t offset, size_t size, const Callback& callback);
+	/// <summary>
+	/// Queues a read of a query object's result. The GPU waits for the query result, not the CPU
+	/// </summary>
+	/// <param name="query">The GL handle of the query to read</param>
+	/// <param name="callback">Invoked with the query result once it is available</param>
+	static void ReadQuery(uint32_t query, const std::function<void(uint32_t)>& callback);
+	/// <summary>
+	/// Queues a read of a region of a texture, such as for screenshots. Rows are tightly packed
+	/// </summary>
+	/// <param name="texture">The GL handle of the texture to read from</param>
+	/// <param name="level">The mip level to read from</param>
+	/// <param name="x">The left edge of the region to read</param>
+	/// <param name="y">The bottom edge of the region to read</param>
+	/// <param name="width">The width of the region, in texels</param>
+	/// <param name="height">The height of the region, in texels</param>
+	/// <param name="format">The format to convert the texels to</param>
+	/// <param name="type">The data type to convert the texels to</param>
+	/// <param name="callback">Invoked with the texels once they are available</param>
+	static void ReadTexture(uint32_t texture, int level, int x, int y, int width, int height, PixelFormat format, PixelType type, const Callback& callback);
+
+	/// <summary>
+	/// Reads a range of a buffer immediately, forcing the CPU to wait on the GPU. This is only
+	/// for tools and load time work, these reads are tracked so they can be spotted in the
+	/// frame timing window
+	/// </summary>
+	/// <param name="buffer">The GL handle of the buffer to read from</param>
+	/// <param name="offset">The offset in bytes to start reading from</param>
+	/// <param name="size">The number of bytes to read</param>
+	/// <param name="result">The memory to copy the data into, must be at least size bytes</param>
+	static void ReadBufferBlocking(uint32_t buffer, size_t offset, size_t size, void* result);
+
+	/// <summary>
+	/// Delivers any requests that the GPU has finished with, never waits on the GPU. Should be
+	/// called once per frame
+	/// </summary>
+	static void Poll();
+	/// <summary>
+	/// Drops any pending requests and frees all staging buffers, must be called before the
+	/// GL context is destroyed
+	/// </summary>
+	static void Shutdown();
+
+	/// <summary>
+	/// Gets statistics about the readbacks that have been performed
+	/// </summary>
+	static const Stats& GetStats();
+
+private:
+	struct StagingBuffer {
+		GLuint Handle;
+		size_t Capacity;
+		void*  Mapped;
+	};
+	struct Request {
+		StagingBuffer Staging;
+		GLsync        Fence;
+		size_t        Size;
+		Callback      OnComplete;
+		uint64_t      QueuedFrame;
+	};
+
+	static std::vector<StagingBuffer> _freeBuffers;
+	static std::deque<Request>        _pending;
+	static uint64_t                   _frameIndex;
+	static uint32_t                   _blockingReadsThisFrame;
+	static Stats                      _stats;
+
+	/// <summary>
+	/// Grabs a staging buffer that can fit the given number of bytes from the pool, or makes a new one
+	/// </summary>
+	static StagingBuffer _AcquireStaging(size_t size);
+	/// <summary>
+	/// Returns a staging buffer to the pool once we are done reading from it
+	/// </summary>
+	static void _ReleaseStaging(const StagingBuffer& staging);
+	/// <summary>
+	/// Fences the commands that copy into the staging buffer and queues the request
+	/// </summary>
+	static void _Submit(const StagingBuffer& staging, size_t size, const Callback& callback);
+};
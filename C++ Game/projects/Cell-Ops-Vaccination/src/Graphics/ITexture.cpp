@@ -30,11 +30,21 @@ void ITexture::Bind(int slot) {
 	if (_rendererId != 0) {
 		// Instead of glActiveTexture + glBindTexture, we can one line it now :D
 		glBindTextureUnit(slot, _rendererId); 
+		// Make sure a sampler from a previous bind doesn't override our settings
+		SamplerCache::Unbind(slot);
+	}
+}
+
+void ITexture::Bind(int slot, const SamplerDescription& sampler) {
+	if (_rendererId != 0) {
+		glBindTextureUnit(slot, _rendererId);
+		SamplerCache::Bind(slot, sampler);
 	}
 }
 
 void ITexture::Unbind(int slot) {
 	glBindTextureUnit(slot, 0);
+	SamplerCache::Unbind(slot);
 }
 
 void ITexture::Clear(const glm::vec4& color) {
@@ -6,6 +6,7 @@
 #include "Utils/ResourceManager/IResource.h"
 #include "Graphics/IGraphicsResource.h"
 #include "Graphics/GLenums.h"
+#include "Graphics/SamplerCache.h"
 
 /// <summary>
 /// The abstract base class for all our textures that we'll be implementing
@@ -37,6 +38,13 @@ public:
 	/// <param name="slot">The slot to bind, 0 &lt;= slot &lt; MAX_TEXTURE_UNITS</param>
 	virtual void Bind(int slot);
 	/// <summary>
+	/// Binds this texture to the given texture slot, along with a shared sampler that overrides
+	/// the texture's own filtering and wrap settings
+	/// </summary>
+	/// <param name="slot">The slot to bind, 0 &lt;= slot &lt; MAX_TEXTURE_UNITS</param>
+	/// <param name="sampler">Describes how the texture should be sampled</param>
+	void Bind(int slot, const SamplerDescription& sampler);
+	/// <summary>
 	/// Unbinds all textures from the given texture slot
 	/// </summary>
 	/// <param name="slot">The slot to unbind, 0 &lt;= slot &lt; MAX_TEXTURE_UNITS</param>
@@ -48,6 +56,21 @@ public:
 	/// <param name="color">The color to clear to</param>
 	void Clear(const glm::vec4& color);
 
+	/// <summary>
+	/// Gets a sampler description that matches how this texture samples by default, so it can
+	/// be bound through the SamplerCache and have the global quality settings apply to it
+	/// </summary>
+	/// <param name="result">The description to populate</param>
+	/// <returns>True if this texture type can be sampled through a sampler object</returns>
+	virtual bool GetSamplerDescription(SamplerDescription* result) const { return false; }
+
+	/// <summary>
+	/// Lets streamed textures know how large they are being drawn this frame, so they can
+	/// decide which mip levels need to be resident. Does nothing for other textures
+	/// </summary>
+	/// <param name="pixels">The approximate size on screen that the texture is being stretched over, in pixels</param>
+	virtual void RequestScreenSize(float pixels) { }
+
 	// Inherited from IGraphicsResource
 
 	virtual GlResourceType GetResourceClass() const override;
@@ -0,0 +1,125 @@
+#include "Graphics/RenderTargetPool.h"
+
+#include <algorithm>
+#include <imgui.h>
+
+#include "Logging.h"
+#include "Utils/ImGuiHelper.h"
+
+std::vector<RenderTargetPool::Entry> RenderTargetPool::_entries;
+uint64_t                RenderTargetPool::_frameIndex = 0;
+uint32_t                RenderTargetPool::_releaseAfterFrames = 60;
+RenderTargetPool::Stats RenderTargetPool::_stats = { 0, 0, 0, 0, 0, 0 };
+
+namespace {
+	// Gets roughly how many bytes a single sample of a render target takes up, drivers are free to pad these
+	size_t GetSampleBytes(RenderTargetType format) {
+		switch (format) {
+			case RenderTargetType::ColorRed8:
+			case RenderTargetType::Stencil4:
+			case RenderTargetType::Stencil8:
+				return 1;
+			case RenderTargetType::ColorRG8:
+			case RenderTargetType::ColorRed16F:
+			case RenderTargetType::Depth16:
+			case RenderTargetType::Stencil16:
+				return 2;
+			case RenderTargetType::ColorRgb8:
+				return 3;
+			case RenderTargetType::ColorRgb16F:
+				return 6;
+			case RenderTargetType::ColorRgba16F:
+				return 8;
+			default:
+				return 4;
+		}
+	}
+}
+
+IGraphicsResource::Sptr RenderTargetPool::Acquire(const glm::ivec2& size, const RenderTargetDescriptor& target, uint8_t samples) {
+	LOG_ASSERT(size.x * size.y > 0, "Width and height must both be > 0");
+
+	for (Entry& entry : _entries) {
+		if (!entry.InUse &&
+			entry.Size == size &&
+			entry.Samples == samples &&
+			entry.Target.UseTexture == target.UseTexture &&
+			entry.Target.Format == target.Format) {
+			entry.InUse = true;
+			entry.LastUsedFrame = _frameIndex;
+			_stats.InUse++;
+			_stats.Reuses++;
+			return entry.Resource;
+		}
+	}
+
+	Entry entry;
+	entry.Resource      = Framebuffer::CreateRenderTarget(size, samples, target);
+	entry.Size          = size;
+	entry.Target        = target;
+	entry.Samples       = samples;
+	entry.Bytes         = GetSampleBytes(target.Format) * size.x * size.y * samples;
+	entry.InUse         = true;
+	entry.LastUsedFrame = _frameIndex;
+	_entries.push_back(entry);
+
+	_stats.Targets++;
+	_stats.InUse++;
+	_stats.Allocations++;
+	_stats.Bytes += entry.Bytes;
+	_stats.PeakBytes = std::max(_stats.PeakBytes, _stats.Bytes);
+	return entry.Resource;
+}
+
+Texture2D::Sptr RenderTargetPool::AcquireTexture(const glm::ivec2& size, RenderTargetType format, uint8_t samples) {
+	return std::static_pointer_cast<Texture2D>(Acquire(size, { true, format }, samples));
+}
+
+void RenderTargetPool::Release(const IGraphicsResource::Sptr& target) {
+	for (Entry& entry : _entries) {
+		if (entry.Resource == target) {
+			LOG_ASSERT(entry.InUse, "Render target was released twice");
+			entry.InUse = false;
+			entry.LastUsedFrame = _frameIndex;
+			_stats.InUse--;
+			return;
+		}
+	}
+	LOG_WARN("Released a render target that did not come from the pool");
+}
+
+void RenderTargetPool::NextFrame() {
+	_frameIndex++;
+
+	// Targets that haven't been borrowed in a while are most likely the wrong size, or belong to a
+	// pass that got turned off
+	for (size_t ix = 0; ix < _entries.size(); ) {
+		const Entry& entry = _entries[ix];
+		if (!entry.InUse && entry.LastUsedFrame + _releaseAfterFrames < _frameIndex) {
+			_stats.Bytes -= entry.Bytes;
+			_stats.Targets--;
+			_entries[ix] = _entries.back();
+			_entries.pop_back();
+		} else {
+			ix++;
+		}
+	}
+}
+
+void RenderTargetPool::RenderImGui() {
+	int releaseAfter = (int)_releaseAfterFrames;
+	if (LABEL_LEFT(ImGui::DragInt, "Release After (frames)", &releaseAfter, 1.0f, 1, 10000)) {
+		_releaseAfterFrames = (uint32_t)std::max(1, releaseAfter);
+	}
+
+	ImGui::Text("Targets: %u (%u in use)", _stats.Targets, _stats.InUse);
+	ImGui::Text("Memory: %.2f MB, peak %.2f MB", _stats.Bytes / (1024.0f * 1024.0f), _stats.PeakBytes / (1024.0f * 1024.0f));
+	ImGui::Text("Allocations: %llu, reuses: %llu", _stats.Allocations, _stats.Reuses);
+}
+
+void RenderTargetPool::Shutdown() {
+	_entries.clear();
+	_stats.Targets = 0;
+	_stats.InUse = 0;
+	_stats.Bytes = 0;
+}
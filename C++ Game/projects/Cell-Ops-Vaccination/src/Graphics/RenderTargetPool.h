@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <GLM/glm.hpp>
+
+#include "Graphics/Framebuffer.h"
+
+/// <summary>
+/// Hands out textures and renderbuffers for passes that only need a render target for part of
+/// a frame, such as a G-buffer or a blur target.
+///
+/// Once a pass releases a target, any later pass asking for the same size, format and sample
+/// count gets that same target back, so passes that don't overlap share their memory. Targets
+/// that go unused for a while (ex: after the window was resized) are deleted in NextFrame.
+///
+/// All functions must be called from the main thread
+/// </summary>
+class RenderTargetPool {
+public:
+	RenderTargetPool() = delete;
+
+	struct Stats {
+		// Number of targets that exist, and how many of those are borrowed right now
+		uint32_t Targets;
+		uint32_t InUse;
+		// Video memory used by all targets in the pool, and the most it has ever used
+		size_t   Bytes;
+		size_t   PeakBytes;
+		// Number of times a target had to be created, and the number of times one was reused
+		uint64_t Allocations;
+		uint64_t Reuses;
+	};
+
+	/// <summary>
+	/// Borrows a texture or renderbuffer from the pool, creating one if none are free. Contents are
+	/// undefined, so the caller should clear it if needed
+	/// </summary>
+	/// <param name="size">The size of the target in pixels</param>
+	/// <param name="target">The format of the target, and whether it should be a texture or renderbuffer</param>
+	/// <param name="samples">The number of samples per pixel, 1 for no multisampling</param>
+	static IGraphicsResource::Sptr Acquire(const glm::ivec2& size, const RenderTargetDescriptor& target, uint8_t samples = 1);
+	/// <summary>
+	/// Borrows a texture from the pool, see Acquire
+	/// </summary>
+	static Texture2D::Sptr AcquireTexture(const glm::ivec2& size, RenderTargetType format, uint8_t samples = 1);
+	/// <summary>
+	/// Returns a target to the pool, so that it can be handed to the next pass that needs one like it.
+	/// The target must not be used after it has been released
+	/// </summary>
+	static void Release(const IGraphicsResource::Sptr& target);
+
+	/// <summary>
+	/// Deletes targets that haven't been used in a while, should be called once per frame
+	/// </summary>
+	static void NextFrame();
+
+	/// <summary>
+	/// Sets how many frames a target can go unused before it is deleted
+	/// </summary>
+	static void SetReleaseAfterFrames(uint32_t frames) { _releaseAfterFrames = frames; }
+	static uint32_t GetReleaseAfterFrames() { return _releaseAfterFrames; }
+
+	static const Stats& GetStats() { return _stats; }
+
+	/// <summary>
+	/// Renders ImGui controls and statistics for the pool
+	/// </summary>
+	static void RenderImGui();
+
+	/// <summary>
+	/// Deletes every target, must be called before the GL context is destroyed
+	/// </summary>
+	static void Shutdown();
+
+private:
+	struct Entry {
+		IGraphicsResource::Sptr Resource;
+		glm::ivec2              Size;
+		RenderTargetDescriptor  Target;
+		uint8_t                 Samples;
+		size_t                  Bytes;
+		bool                    InUse;
+		uint64_t                LastUsedFrame;
+	};
+
+	static std::vector<Entry> _entries;
+	static uint64_t _frameIndex;
+	static uint32_t _releaseAfterFrames;
+	static Stats    _stats;
+};
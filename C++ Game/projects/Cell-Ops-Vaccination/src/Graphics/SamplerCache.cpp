@@ -0,0 +1,183 @@
+#include "Graphics/SamplerCache.h"
+
+#include <algorithm>
+#include <imgui.h>
+
+#include "Graphics/ITexture.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/ImGuiHelper.h"
+
+std::unordered_map<SamplerDescription, GLuint, SamplerCache::DescriptionHash> SamplerCache::_samplers;
+std::vector<GLuint> SamplerCache::_boundSamplers;
+float SamplerCache::_maxAnisotropy = -1.0f;
+float SamplerCache::_lodBias = 0.0f;
+
+namespace {
+	// Draws a combo box for picking between the given values of an enum
+	template <typename EnumType, size_t Count>
+	bool EnumCombo(const char* label, EnumType& value, const EnumType(&options)[Count]) {
+		bool changed = false;
+		if (ImGui::BeginCombo(label, (~value).c_str())) {
+			for (const EnumType& option : options) {
+				if (ImGui::Selectable((~option).c_str(), option == value)) {
+					value = option;
+					changed = true;
+				}
+			}
+			ImGui::EndCombo();
+		}
+		return changed;
+	}
+
+	const MinFilter MinFilters[] = { MinFilter::Nearest, MinFilter::Linear, MinFilter::NearestMipNearest, MinFilter::LinearMipNearest, MinFilter::NearestMipLinear, MinFilter::LinearMipLinear };
+	const MagFilter MagFilters[] = { MagFilter::Nearest, MagFilter::Linear };
+	const WrapMode  WrapModes[]  = { WrapMode::ClampToEdge, WrapMode::ClampToBorder, WrapMode::MirroredRepeat, WrapMode::Repeat, WrapMode::MirrorClampToEdge };
+}
+
+bool SamplerDescription::operator==(const SamplerDescription& other) const {
+	return
+		MinificationFilter  == other.MinificationFilter &&
+		MagnificationFilter == other.MagnificationFilter &&
+		HorizontalWrap      == other.HorizontalWrap &&
+		VerticalWrap        == other.VerticalWrap &&
+		DepthWrap           == other.DepthWrap &&
+		MaxAnisotropic      == other.MaxAnisotropic &&
+		LodBias             == other.LodBias;
+}
+
+bool SamplerDescription::RenderImGui() {
+	bool changed = false;
+	changed |= EnumCombo("Min Filter", MinificationFilter, MinFilters);
+	changed |= EnumCombo("Mag Filter", MagnificationFilter, MagFilters);
+	changed |= EnumCombo("Wrap S", HorizontalWrap, WrapModes);
+	changed |= EnumCombo("Wrap T", VerticalWrap, WrapModes);
+	changed |= EnumCombo("Wrap R", DepthWrap, WrapModes);
+	changed |= ImGui::DragFloat("Anisotropy", &MaxAnisotropic, 0.1f, 1.0f, 16.0f);
+	changed |= ImGui::DragFloat("LOD Bias", &LodBias, 0.05f, -4.0f, 4.0f);
+	return changed;
+}
+
+nlohmann::json SamplerDescription::ToJson() const {
+	return {
+		{ "filter_min",  ~MinificationFilter },
+		{ "filter_mag",  ~MagnificationFilter },
+		{ "wrap_s",      ~HorizontalWrap },
+		{ "wrap_t",      ~VerticalWrap },
+		{ "wrap_r",      ~DepthWrap },
+		{ "anisotropic", MaxAnisotropic },
+		{ "lod_bias",    LodBias }
+	};
+}
+
+SamplerDescription SamplerDescription::FromJson(const nlohmann::json& blob) {
+	SamplerDescription result;
+	result.MinificationFilter  = JsonParseEnum(MinFilter, blob, "filter_min", result.MinificationFilter);
+	result.MagnificationFilter = JsonParseEnum(MagFilter, blob, "filter_mag", result.MagnificationFilter);
+	result.HorizontalWrap      = JsonParseEnum(WrapMode, blob, "wrap_s", result.HorizontalWrap);
+	result.VerticalWrap        = JsonParseEnum(WrapMode, blob, "wrap_t", result.VerticalWrap);
+	result.DepthWrap           = JsonParseEnum(WrapMode, blob, "wrap_r", result.DepthWrap);
+	result.MaxAnisotropic      = JsonGet(blob, "anisotropic", result.MaxAnisotropic);
+	result.LodBias             = JsonGet(blob, "lod_bias", result.LodBias);
+	return result;
+}
+
+size_t SamplerCache::DescriptionHash::operator()(const SamplerDescription& description) const {
+	size_t result = std::hash<GLint>()((GLint)description.MinificationFilter);
+	auto combine = [&](size_t value) {
+		result ^= value + 0x9e3779b9 + (result << 6) + (result >> 2);
+	};
+	combine(std::hash<GLint>()((GLint)description.MagnificationFilter));
+	combine(std::hash<GLint>()((GLint)description.HorizontalWrap));
+	combine(std::hash<GLint>()((GLint)description.VerticalWrap));
+	combine(std::hash<GLint>()((GLint)description.DepthWrap));
+	combine(std::hash<float>()(description.MaxAnisotropic));
+	combine(std::hash<float>()(description.LodBias));
+	return result;
+}
+
+GLuint SamplerCache::Get(const SamplerDescription& description) {
+	auto it = _samplers.find(description);
+	if (it != _samplers.end()) {
+		return it->second;
+	}
+
+	GLuint sampler = 0;
+	glCreateSamplers(1, &sampler);
+	_ApplyParams(sampler, description);
+	_samplers[description] = sampler;
+	return sampler;
+}
+
+void SamplerCache::Bind(int slot, const SamplerDescription& description) {
+	GLuint sampler = Get(description);
+	if (_boundSamplers.size() <= (size_t)slot) {
+		_boundSamplers.resize(slot + 1, 0);
+	}
+	if (_boundSamplers[slot] != sampler) {
+		glBindSampler(slot, sampler);
+		_boundSamplers[slot] = sampler;
+	}
+}
+
+void SamplerCache::Unbind(int slot) {
+	if ((size_t)slot < _boundSamplers.size() && _boundSamplers[slot] != 0) {
+		glBindSampler(slot, 0);
+		_boundSamplers[slot] = 0;
+	}
+}
+
+void SamplerCache::SetQuality(float maxAnisotropy, float lodBias) {
+	_maxAnisotropy = maxAnisotropy;
+	_lodBias = lodBias;
+
+	// Only the sampler objects change, the textures keep their own settings
+	for (auto& [description, sampler] : _samplers) {
+		_ApplyParams(sampler, description);
+	}
+}
+
+void SamplerCache::RenderImGui() {
+	float maxAniso = _maxAnisotropy;
+	float lodBias = _lodBias;
+	bool changed = false;
+
+	// Simple presets for quickly comparing quality levels
+	if (ImGui::Button("Low")) { maxAniso = 1.0f; lodBias = 1.0f; changed = true; }
+	ImGui::SameLine();
+	if (ImGui::Button("Medium")) { maxAniso = 4.0f; lodBias = 0.0f; changed = true; }
+	ImGui::SameLine();
+	if (ImGui::Button("High")) { maxAniso = -1.0f; lodBias = 0.0f; changed = true; }
+
+	changed |= LABEL_LEFT(ImGui::DragFloat, "Max Anisotropy", &maxAniso, 0.1f, -1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
+	changed |= LABEL_LEFT(ImGui::DragFloat, "LOD Bias      ", &lodBias, 0.05f, -4.0f, 4.0f);
+	ImGui::Text("Samplers: %u", (uint32_t)_samplers.size());
+
+	if (changed) {
+		SetQuality(maxAniso, lodBias);
+	}
+}
+
+void SamplerCache::Shutdown() {
+	for (auto& [description, sampler] : _samplers) {
+		glDeleteSamplers(1, &sampler);
+	}
+	_samplers.clear();
+	_boundSamplers.clear();
+}
+
+void SamplerCache::_ApplyParams(GLuint sampler, const SamplerDescription& description) {
+	// Negative means no limit other than what the hardware supports
+	float maxAniso = ITexture::GetLimits().MAX_ANISOTROPY;
+	if (_maxAnisotropy >= 1.0f) {
+		maxAniso = std::min(maxAniso, _maxAnisotropy);
+	}
+	float anisotropy = description.MaxAnisotropic < 0.0f ? maxAniso : std::clamp(description.MaxAnisotropic, 1.0f, maxAniso);
+
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, (GLenum)description.MinificationFilter);
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, (GLenum)description.MagnificationFilter);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, (GLenum)description.HorizontalWrap);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, (GLenum)description.VerticalWrap);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, (GLenum)description.DepthWrap);
+	glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
+	glSamplerParameterf(sampler, GL_TEXTURE_LOD_BIAS, description.LodBias + _lodBias);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <json.hpp>
+
+#include "Graphics/GlEnums.h"
+
+/// <summary>
+/// Describes how a texture should be sampled, independent of the texture itself
+/// </summary>
+struct SamplerDescription {
+	/// <summary>
+	/// The filter to use when multiple texels will map to a single pixel
+	/// </summary>
+	MinFilter MinificationFilter;
+	/// <summary>
+	/// The filter to use when one texel will map to multiple pixels
+	/// </summary>
+	MagFilter MagnificationFilter;
+	/// <summary>
+	/// The wrap modes along the S, T and R axes
+	/// </summary>
+	WrapMode  HorizontalWrap;
+	WrapMode  VerticalWrap;
+	WrapMode  DepthWrap;
+	/// <summary>
+	/// The number of anisotropic samples to take, before the global quality limit is applied
+	/// </summary>
+	float     MaxAnisotropic;
+	/// <summary>
+	/// Offset added to the mip level that is selected, positive values blur and negative sharpen
+	/// </summary>
+	float     LodBias;
+
+	SamplerDescription() :
+		MinificationFilter(MinFilter::NearestMipLinear),
+		MagnificationFilter(MagFilter::Linear),
+		HorizontalWrap(WrapMode::Repeat),
+		VerticalWrap(WrapMode::Repeat),
+		DepthWrap(WrapMode::Repeat),
+		MaxAnisotropic(1.0f),
+		LodBias(0.0f)
+	{ }
+
+	bool operator ==(const SamplerDescription& other) const;
+	bool operator !=(const SamplerDescription& other) const { return !(*this == other); }
+
+	/// <summary>
+	/// Renders ImGui controls for editing this description
+	/// </summary>
+	/// <returns>True if the description was changed</returns>
+	bool RenderImGui();
+
+	nlohmann::json ToJson() const;
+	static SamplerDescription FromJson(const nlohmann::json& blob);
+};
+
+/// <summary>
+/// Shares GL sampler objects between everything that samples textures the same way, so
+/// materials can choose how a texture is sampled without needing a copy of the texture.
+///
+/// Global quality settings are applied to the sampler objects rather than the textures, so
+/// anisotropy and mip bias can be dialed down on weaker machines at runtime
+/// </summary>
+class SamplerCache {
+public:
+	SamplerCache() = delete;
+
+	/// <summary>
+	/// Gets the GL sampler object for the given description, creating it if needed
+	/// </summary>
+	static GLuint Get(const SamplerDescription& description);
+
+	/// <summary>
+	/// Binds the sampler for the given description to a texture unit
+	/// </summary>
+	/// <param name="slot">The texture unit to bind to</param>
+	/// <param name="description">Describes the sampler to bind</param>
+	static void Bind(int slot, const SamplerDescription& description);
+	/// <summary>
+	/// Removes any sampler bound to the given texture unit, so the texture's own parameters
+	/// are used again. Does nothing if no sampler is bound there
+	/// </summary>
+	static void Unbind(int slot);
+
+	/// <summary>
+	/// Sets the global sampling quality, updating all existing samplers
+	/// </summary>
+	/// <param name="maxAnisotropy">The maximum anisotropy any sampler may use, or a negative value for the hardware limit</param>
+	/// <param name="lodBias">Added on top of every sampler's own LOD bias</param>
+	static void SetQuality(float maxAnisotropy, float lodBias);
+	static float GetMaxAnisotropy() { return _maxAnisotropy; }
+	static float GetLodBias() { return _lodBias; }
+
+	/// <summary>
+	/// Gets the number of unique samplers that have been created
+	/// </summary>
+	static size_t GetSamplerCount() { return _samplers.size(); }
+
+	/// <summary>
+	/// Renders ImGui controls for the global quality settings
+	/// </summary>
+	static void RenderImGui();
+
+	/// <summary>
+	/// Deletes all sampler objects, must be called before the GL context is destroyed
+	/// </summary>
+	static void Shutdown();
+
+private:
+	struct DescriptionHash {
+		size_t operator()(const SamplerDescription& description) const;
+	};
+
+	static std::unordered_map<SamplerDescription, GLuint, DescriptionHash> _samplers;
+	// The sampler bound to each texture unit, so we can skip redundant binds
+	static std::vector<GLuint> _boundSamplers;
+	static float _maxAnisotropy;
+	static float _lodBias;
+
+	/// <summary>
+	/// Applies a description to a sampler object, with the global quality settings taken into account
+	/// </summary>
+	static void _ApplyParams(GLuint sampler, const SamplerDescription& description);
+};
@@ -5,6 +5,7 @@
 #include <filesystem>
 
 #include "Utils/FileHelpers.h"
+#include "Utils/VirtualFileSystem.h"
 
 ShaderProgram::ShaderProgram() : 
 	IGraphicsResource(),
@@ -83,7 +84,7 @@ bool ShaderProgram::LoadShaderPart(const char* source, ShaderPartType type) {
 
 bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
 	// Make sure that the file exists before we try reading
-	if (std::filesystem::exists(path)) {
+	if (VirtualFileSystem::Exists(path)) {
 		// Load the source from the file, using our helper that will
 		// resolve #include directives
 		std::string source = FileHelpers::ReadResolveIncludes(path);
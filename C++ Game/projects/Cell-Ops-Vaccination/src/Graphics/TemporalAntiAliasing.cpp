@@ -0,0 +1,104 @@
+#include "Graphics/TemporalAntiAliasing.h"
+
+#include <GLM/gtc/matrix_transform.hpp>
+
+TemporalAntiAliasing::TemporalAntiAliasing(const glm::ivec2& size) :
+	JitterSamples(8),
+	HistoryWeight(0.9f),
+	_history(),
+	_historyIndex(0),
+	_historyValid(false),
+	_resolveShader(nullptr),
+	_fullscreenVao(nullptr)
+{
+	// The history is kept at a higher precision than the scene color, so that small
+	// contributions from each frame don't get rounded away
+	FramebufferDescriptor descriptor;
+	descriptor.Width = size.x;
+	descriptor.Height = size.y;
+	descriptor.RenderTargets[RenderTargetAttachment::Color0] = { true, RenderTargetType::ColorRgba16F };
+	_history[0] = std::make_shared<Framebuffer>(descriptor);
+	_history[1] = std::make_shared<Framebuffer>(descriptor);
+
+	_resolveShader = ShaderProgram::Create();
+	_resolveShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_triangle.glsl", ShaderPartType::Vertex);
+	_resolveShader->LoadShaderPartFromFile("shaders/fragment_shaders/taa_resolve.glsl", ShaderPartType::Fragment);
+	_resolveShader->Link();
+
+	// The fullscreen triangle generates its vertices from gl_VertexID, but GL still needs a VAO bound
+	_fullscreenVao = VertexArrayObject::Create();
+}
+
+TemporalAntiAliasing::~TemporalAntiAliasing() = default;
+
+float TemporalAntiAliasing::Halton(int index, int base) {
+	float result = 0.0f;
+	float fraction = 1.0f;
+	while (index > 0) {
+		fraction /= base;
+		result += fraction * (index % base);
+		index /= base;
+	}
+	return result;
+}
+
+glm::vec2 TemporalAntiAliasing::GetJitter(uint64_t frame) const {
+	// Skip index 0, which is (0, 0) in every base
+	int index = (int)(frame % (uint64_t)glm::max(JitterSamples, 1)) + 1;
+	return glm::vec2(Halton(index, 2), Halton(index, 3)) - 0.5f;
+}
+
+glm::mat4 TemporalAntiAliasing::JitterProjection(const glm::mat4& projection, const glm::vec2& jitter, const glm::ivec2& size) {
+	// Translating in clip space after the projection shifts the image by a constant amount in NDC,
+	// which works for both perspective and orthographic projections
+	glm::vec3 offset = glm::vec3(jitter * 2.0f / glm::vec2(glm::max(size, glm::ivec2(1))), 0.0f);
+	return glm::translate(glm::mat4(1.0f), offset) * projection;
+}
+
+void TemporalAntiAliasing::Resize(const glm::ivec2& size) {
+	_history[0]->Resize(size);
+	_history[1]->Resize(size);
+	Invalidate();
+}
+
+void TemporalAntiAliasing::Invalidate() {
+	_historyValid = false;
+}
+
+void TemporalAntiAliasing::Resolve(const Framebuffer::Sptr& target, RenderTargetAttachment velocity, const glm::mat4& viewProjection, const glm::mat4& prevViewProjection, const glm::vec2& jitter) {
+	const Framebuffer::Sptr& output = _history[_historyIndex];
+	const Framebuffer::Sptr& history = _history[1 - _historyIndex];
+
+	output->Bind();
+	glViewport(0, 0, output->GetWidth(), output->GetHeight());
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+
+	_resolveShader->Bind();
+	target->BindAttachment(RenderTargetAttachment::Color0, 0);
+	history->BindAttachment(RenderTargetAttachment::Color0, 1);
+	target->BindAttachment(velocity, 2);
+	target->BindAttachment(RenderTargetAttachment::DepthStencil, 3);
+
+	glm::mat4 invViewProjection = glm::inverse(viewProjection);
+	glm::vec2 jitterUv = jitter / glm::vec2(target->GetSize());
+	float historyWeight = glm::clamp(HistoryWeight, 0.0f, 1.0f);
+	_resolveShader->SetUniformMatrix("u_InvViewProjection", invViewProjection);
+	_resolveShader->SetUniformMatrix("u_PrevViewProjection", prevViewProjection);
+	_resolveShader->SetUniform("u_Jitter", jitterUv);
+	_resolveShader->SetUniform("u_HistoryWeight", historyWeight);
+	_resolveShader->SetUniform("u_HistoryValid", _historyValid);
+
+	_fullscreenVao->Bind();
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	VertexArrayObject::Unbind();
+	output->Unbind();
+
+	// Copy the result back, so that anything drawn after us lands on the anti-aliased image
+	Framebuffer::Blit(output, target, BufferFlags::Color, MagFilter::Nearest);
+	target->Bind();
+	glEnable(GL_DEPTH_TEST);
+
+	_historyIndex = 1 - _historyIndex;
+	_historyValid = true;
+}
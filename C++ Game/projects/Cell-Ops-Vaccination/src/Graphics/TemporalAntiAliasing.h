@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Utils/Macros.h"
+#include "Graphics/Framebuffer.h"
+#include "Graphics/ShaderProgram.h"
+#include "Graphics/VertexArrayObject.h"
+
+/// <summary>
+/// Temporal anti-aliasing. The scene is rendered with a sub-pixel projection jitter that
+/// changes every frame, and each frame is blended into a history buffer that is reprojected
+/// using per-pixel velocities. Over a few frames this converges on a supersampled image, for
+/// about the cost of a single fullscreen pass.
+///
+/// History colors are clamped to the neighbourhood of the current pixel, which stops
+/// disoccluded or changed pixels from ghosting
+/// </summary>
+class TemporalAntiAliasing {
+public:
+	MAKE_PTRS(TemporalAntiAliasing);
+	NO_COPY(TemporalAntiAliasing);
+	NO_MOVE(TemporalAntiAliasing);
+
+	// The velocity target should be cleared to this, pixels that still hold it have their
+	// motion worked out from depth and the camera movement instead
+	// Must match NO_VELOCITY in fragment_shaders/taa_resolve.glsl
+	static constexpr float NO_VELOCITY = -1000.0f;
+
+	// Number of jitter positions to cycle through, higher is smoother but takes longer to converge
+	int   JitterSamples;
+	// How much of the history is kept every frame, between 0 and 1
+	float HistoryWeight;
+
+	TemporalAntiAliasing(const glm::ivec2& size);
+	~TemporalAntiAliasing();
+
+	/// <summary>
+	/// Gets an element of the Halton low discrepancy sequence, in the range [0, 1)
+	/// </summary>
+	/// <param name="index">The index into the sequence, starting at 1</param>
+	/// <param name="base">The base of the sequence, should be prime</param>
+	static float Halton(int index, int base);
+
+	/// <summary>
+	/// Gets the sub-pixel jitter to render the given frame with, in pixels in the range [-0.5, 0.5].
+	/// The sequence only depends on the frame index, so results are repeatable
+	/// </summary>
+	glm::vec2 GetJitter(uint64_t frame) const;
+
+	/// <summary>
+	/// Offsets a projection matrix so that the image it produces is shifted by the given jitter
+	/// </summary>
+	/// <param name="projection">The camera's projection matrix</param>
+	/// <param name="jitter">The offset to apply, in pixels</param>
+	/// <param name="size">The size of the render target in pixels</param>
+	static glm::mat4 JitterProjection(const glm::mat4& projection, const glm::vec2& jitter, const glm::ivec2& size);
+
+	/// <summary>
+	/// Resizes the history buffers, discarding the history
+	/// </summary>
+	void Resize(const glm::ivec2& size);
+
+	/// <summary>
+	/// Discards the history, should be called on camera cuts and scene changes
+	/// </summary>
+	void Invalidate();
+
+	/// <summary>
+	/// Blends the target's color with the history, writing the anti-aliased result back into the
+	/// target's first color attachment. Leaves the target bound for drawing
+	/// </summary>
+	/// <param name="target">The framebuffer that the scene was rendered to, with a texture depth attachment</param>
+	/// <param name="velocity">The attachment holding the screen space velocity for moving objects</param>
+	/// <param name="viewProjection">The camera's view projection for this frame, without jitter</param>
+	/// <param name="prevViewProjection">The camera's view projection for the previous frame, without jitter</param>
+	/// <param name="jitter">The jitter that the frame was rendered with, in pixels</param>
+	void Resolve(const Framebuffer::Sptr& target, RenderTargetAttachment velocity, const glm::mat4& viewProjection, const glm::mat4& prevViewProjection, const glm::vec2& jitter);
+
+private:
+	// We ping-pong between two history buffers, reading last frame's result while writing this frame's
+	Framebuffer::Sptr       _history[2];
+	int                     _historyIndex;
+	bool                    _historyValid;
+
+	ShaderProgram::Sptr     _resolveShader;
+	VertexArrayObject::Sptr _fullscreenVao;
+};
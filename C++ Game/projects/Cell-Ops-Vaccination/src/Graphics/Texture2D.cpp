@@ -3,6 +3,9 @@
 #include <Logging.h>
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/VirtualFileSystem.h"
+#include "Graphics/GlUploadThread.h"
+#include "Graphics/TextureStreamer.h"
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -14,6 +17,48 @@ inline int CalcRequiredMipLevels(int width, int height) {
 	return (1 + floor(log2(glm::max(width, height))));
 }
 
+namespace {
+	/// <summary>
+	/// Halves an 8 bit per channel image the given number of times with a box filter, the same
+	/// way mipmaps are generated, so that we only need to upload the levels we want
+	/// </summary>
+	std::vector<uint8_t> DownsampleImage(const uint8_t* data, uint32_t& width, uint32_t& height, int channels, uint32_t levels) {
+		std::vector<uint8_t> result(data, data + (size_t)width * height * channels);
+		for (uint32_t level = 0; level < levels && (width > 1 || height > 1); level++) {
+			uint32_t newWidth = glm::max(1u, width / 2);
+			uint32_t newHeight = glm::max(1u, height / 2);
+			std::vector<uint8_t> next((size_t)newWidth * newHeight * channels);
+			for (uint32_t y = 0; y < newHeight; y++) {
+				uint32_t y0 = glm::min(y * 2, height - 1), y1 = glm::min(y * 2 + 1, height - 1);
+				for (uint32_t x = 0; x < newWidth; x++) {
+					uint32_t x0 = glm::min(x * 2, width - 1), x1 = glm::min(x * 2 + 1, width - 1);
+					for (int c = 0; c < channels; c++) {
+						uint32_t sum =
+							result[((size_t)y0 * width + x0) * channels + c] + result[((size_t)y0 * width + x1) * channels + c] +
+							result[((size_t)y1 * width + x0) * channels + c] + result[((size_t)y1 * width + x1) * channels + c];
+						next[((size_t)y * newWidth + x) * channels + c] = (uint8_t)((sum + 2) / 4);
+					}
+				}
+			}
+			result = std::move(next);
+			width = newWidth;
+			height = newHeight;
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Rough number of bytes a single texel takes in video memory, 3 channel formats are usually padded
+	/// </summary>
+	size_t GetApproxTexelBytes(InternalFormat format) {
+		switch (format) {
+		case InternalFormat::R8:  return 1;
+		case InternalFormat::RG8: return 2;
+		default:                  return 4;
+		}
+	}
+}
+
 nlohmann::json Texture2D::ToJson() const {
 	return {
 		{ "filename", _description.Filename },
@@ -23,9 +68,24 @@ nlohmann::json Texture2D::ToJson() const {
 		{ "filter_mag",       ~_description.MagnificationFilter },
 		{ "anisotropic",       _description.MaxAnisotropic },
 		{ "generate_mipmaps",  _description.GenerateMipMaps },
+		{ "async_upload",      _description.AsyncUpload },
+		{ "streamed",          _description.Streamed },
 	};
 }
 
+bool Texture2D::GetSamplerDescription(SamplerDescription* result) const {
+	// Multisampled textures don't support sampler state
+	if (_description.MultisampleCount != 1) {
+		return false;
+	}
+	result->MinificationFilter  = _description.MinificationFilter;
+	result->MagnificationFilter = _description.MagnificationFilter;
+	result->HorizontalWrap      = _description.HorizontalWrap;
+	result->VerticalWrap        = _description.VerticalWrap;
+	result->MaxAnisotropic      = _description.MaxAnisotropic;
+	return true;
+}
+
 Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 {
 	Texture2DDescription descr = Texture2DDescription();
@@ -36,10 +96,20 @@ Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", 0.0f);
 	descr.GenerateMipMaps     = JsonGet(data, "generate_mipmaps", false);
+	descr.AsyncUpload         = JsonGet(data, "async_upload", false);
+	descr.Streamed            = JsonGet(data, "streamed", false);
 	return std::make_shared<Texture2D>(descr);
 }
 
-Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(TextureType::_2D) {
+Texture2D::Texture2D(const Texture2DDescription& description) : 
+	ITexture(TextureType::_2D),
+	_isStreamed(false),
+	_residentLevel(0),
+	_requestedLevel(0),
+	_pendingLevel(0),
+	_lastRequestFrame(0),
+	_blurrySinceFrame(0)
+{
 	_description = description;
 	_SetTextureParams();
 	if (!description.Filename.empty()) {
@@ -48,17 +118,89 @@ Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(Texture
 }
 
 Texture2D::Texture2D(const std::string& filePath) : 
-	ITexture(TextureType::_2D) 
+	ITexture(TextureType::_2D),
+	_isStreamed(false),
+	_residentLevel(0),
+	_requestedLevel(0),
+	_pendingLevel(0),
+	_lastRequestFrame(0),
+	_blurrySinceFrame(0)
 {
 	_description.Filename = filePath;
 	_SetTextureParams();
 	_LoadDataFromFile();
 }
 
+Texture2D::~Texture2D() {
+	if (_isStreamed) {
+		TextureStreamer::Unregister(this);
+	}
+
+	// If the upload thread is still working on our texture, we leave it to clean up the handle
+	if (_asyncUpload != nullptr) {
+		std::lock_guard<std::mutex> lock(_asyncUpload->Mutex);
+		_asyncUpload->Owner = nullptr;
+		if (_asyncUpload->IsUploading) {
+			_asyncUpload->IsOrphaned = true;
+			if (!_asyncUpload->IsStreaming) {
+				_rendererId = 0;
+			}
+		}
+	}
+}
+
+size_t Texture2D::GetResidentBytes() const {
+	return _GetBytesAtLevel(_residentLevel);
+}
+
+size_t Texture2D::_GetBytesAtLevel(uint32_t level) const {
+	if (_description.Width * _description.Height == 0) {
+		return 0;
+	}
+	uint32_t width = glm::max(1u, _description.Width >> level);
+	uint32_t height = glm::max(1u, _description.Height >> level);
+	size_t texels = (size_t)width * height;
+	// A full mip chain adds about a third on top of the base level
+	if (_description.GenerateMipMaps) {
+		texels += texels / 3;
+	}
+	return texels * GetApproxTexelBytes(_description.Format) * _description.MultisampleCount;
+}
+
+void Texture2D::RequestScreenSize(float pixels) {
+	if (!_isStreamed || _description.Width * _description.Height == 0) {
+		return;
+	}
+
+	// Each mip level halves the size, so we want the level that's closest to the screen size
+	float ratio = glm::max(_description.Width, _description.Height) / glm::max(pixels, 1.0f);
+	uint32_t level = ratio <= 1.0f ? 0 : (uint32_t)glm::floor(glm::log2(ratio));
+	level = glm::min(level, _GetMinResidentLevel());
+
+	uint64_t frame = TextureStreamer::GetFrameIndex();
+	if (_lastRequestFrame != frame) {
+		_lastRequestFrame = frame;
+		_requestedLevel = level;
+	} else {
+		_requestedLevel = glm::min(_requestedLevel, level);
+	}
+}
+
+uint32_t Texture2D::_GetMinResidentLevel() const {
+	uint32_t size = glm::max(_description.Width, _description.Height);
+	uint32_t minSize = glm::max(1u, TextureStreamer::GetMinResidentSize());
+	uint32_t level = 0;
+	while ((size >> level) > minSize) {
+		level++;
+	}
+	return level;
+}
+
 void Texture2D::SetMinFilter(MinFilter value) {
 	if (_description.MultisampleCount == 1) {
 		_description.MinificationFilter = value;
 		glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
+		MarkDirty();
 	}
 	else {
 		LOG_WARN("Attempted to set minification filter on a multisampled texture, ignoring");
@@ -69,6 +211,7 @@ void Texture2D::SetMagFilter(MagFilter value) {
 	if (_description.MultisampleCount == 1) {
 		_description.MagnificationFilter = value;
 		glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
+		MarkDirty();
 	} else {
 		LOG_WARN("Attempted to set magnification filter on a multisampled texture, ignoring");
 	}
@@ -78,6 +221,7 @@ void Texture2D::SetAnisoLevel(float value) {
 	if (value != _description.MaxAnisotropic) {
 		_description.MaxAnisotropic = glm::clamp(value, 1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
 		glTextureParameterf(_rendererId, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+		MarkDirty();
 
 		if (_description.GenerateMipMaps) {
 			glGenerateTextureMipmap(_rendererId);
@@ -90,70 +234,214 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 	LOG_ASSERT((width + offsetX) <= _description.Width, "Pixel bounds are outside of the X extents of the image!");
 	LOG_ASSERT((height + offsetY) <= _description.Height, "Pixel bounds are outside of the Y extents of the image!");
 
+	_UploadPixels(_rendererId, _description.GenerateMipMaps, width, height, format, type, data, offsetX, offsetY);
+}
+
+void Texture2D::_UploadPixels(uint32_t handle, bool generateMipMaps, uint32_t width, uint32_t height, PixelFormat format, PixelType type, const void* data, uint32_t offsetX, uint32_t offsetY) {
 	// Align the data store to the size of a single component to ensure we don't get weirdness with images that aren't RGBA
 	// See https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glPixelStore.xhtml
 	int componentSize = (GLint)GetTexelComponentSize(type);
 	glPixelStorei(GL_PACK_ALIGNMENT, componentSize);
 
 	// Upload our data to our image
-	glTextureSubImage2D(_rendererId, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
+	glTextureSubImage2D(handle, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
 
 	// If requested, generate mip-maps for our texture
-	if (_description.GenerateMipMaps) {
-		glGenerateTextureMipmap(_rendererId);
+	if (generateMipMaps) {
+		glGenerateTextureMipmap(handle);
+	}
+}
+
+uint8_t* Texture2D::_DecodeFile(Texture2DDescription& description, PixelFormat& imageFormat) {
+	// Variables that will store properties about our image
+	int width, height, numChannels;
+	const int targetChannels = GetTexelComponentCount(description.FormatHint);
+
+	// Read the file through the VFS so it can come from a pack, then let STBI decode it
+	std::string fileData;
+	if (!VirtualFileSystem::ReadFile(description.Filename, fileData)) {
+		LOG_WARN("Could not read image \"{}\"", description.Filename);
+		return nullptr;
+	}
+
+	// Use STBI to load the image
+	stbi_set_flip_vertically_on_load(true);
+	uint8_t* data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(fileData.data()), (int)fileData.size(), &width, &height, &numChannels, targetChannels);
+
+	// If we could not load any data, warn and return null
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", description.Filename);
+		return nullptr;
 	}
+
+	// We should estimate a good format for our data
+
+	// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+	if (targetChannels != 0)
+		numChannels = targetChannels;
+
+	// We'll determine a recommended format for the image based on number of channels
+	// We hinted that we wanted a certain number of channels, but we're not guaranteed
+	// that all those channels exist (ex: loading an RGB image but requesting RGBA)
+	InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
+	imageFormat = GetPixelFormatForChannels(numChannels);
+
+	// This is one of those poorly documented things in OpenGL
+	if ((numChannels * width) % 4 != 0) {
+		LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
+	}
+
+	// Update our description to match what we loaded
+	description.Format = internal_format;
+	description.Width = width;
+	description.Height = height;
+	return data;
 }
 
 void Texture2D::_LoadDataFromFile() {
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
-		// Variables that will store properties about our image
-		int width, height, numChannels;
-		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
-
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
-
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
-			return ;
+		// Streaming only makes sense when we have mips to drop
+		_isStreamed = _description.Streamed && _description.GenerateMipMaps && _description.MultisampleCount == 1;
+		if (_isStreamed) {
+			TextureStreamer::Register(this);
 		}
 
-		// We should estimate a good format for our data
+		if (_isStreamed || (_description.AsyncUpload && GlUploadThread::IsEnabled())) {
+			// Streamed textures start out with only their smallest levels resident
+			_UploadFromFile(_isStreamed ? -1 : 0, false, _description.AsyncUpload);
+		} else {
+			PixelFormat imageFormat;
+			uint8_t* data = _DecodeFile(_description, imageFormat);
+			if (data == nullptr) {
+				return;
+			}
 
-		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
-		if (targetChannels != 0)
-			numChannels = targetChannels;
+			// Allocates our memory
+			_SetTextureParams();
 
-		// We'll determine a recommended format for the image based on number of channels
-		// We hinted that we wanted a certain number of channels, but we're not guaranteed
-		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+			// Upload data to our texture
+			LoadData(_description.Width, _description.Height, imageFormat, PixelType::UByte, data);
 
-		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
-			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
+			// We now have data in the image, we can clear the STBI data
+			stbi_image_free(data);
 		}
+	}
+	
+	SetDebugName(_description.Filename);
+}
 
-		// Update our description to match what we loaded
-		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
+void Texture2D::_UploadFromFile(int level, bool intoNewTexture, bool async) {
+	std::shared_ptr<AsyncUploadState> state = std::make_shared<AsyncUploadState>();
+	state->Owner = this;
+	state->Result = _description;
+	state->IsStreaming = intoNewTexture;
+	state->Handle = intoNewTexture ? 0 : _rendererId;
+	_asyncUpload = state;
+
+	// Read on the main thread, since the streamer's settings can change at any time
+	uint32_t minResidentSize = glm::max(1u, TextureStreamer::GetMinResidentSize());
+
+	// The upload thread decodes the image and fills in the texture, we only use our copy of the
+	// description and the handle there, since the texture itself belongs to the main thread
+	GlUploadThread::Job upload = [state, level, minResidentSize]() {
+		PixelFormat imageFormat;
+		uint8_t* data = _DecodeFile(state->Result, imageFormat);
+		uint32_t handle = state->Handle;
+		if (data != nullptr) {
+			// Work out the streaming minimum now that we know how big the image is
+			uint32_t residentLevel = 0;
+			if (level < 0) {
+				while ((glm::max(state->Result.Width, state->Result.Height) >> residentLevel) > minResidentSize) {
+					residentLevel++;
+				}
+			} else {
+				residentLevel = (uint32_t)level;
+			}
+
+			// Shrink the image down on the CPU, so we never need memory for the levels we skip
+			Texture2DDescription resident = state->Result;
+			std::vector<uint8_t> downsampled;
+			const uint8_t* pixels = data;
+			if (residentLevel > 0) {
+				downsampled = DownsampleImage(data, resident.Width, resident.Height, GetTexelComponentCount(imageFormat), residentLevel);
+				pixels = downsampled.data();
+			}
+
+			if (state->IsStreaming) {
+				glCreateTextures(GL_TEXTURE_2D, 1, &handle);
+			}
+			_AllocateStorage(handle, resident);
+			_UploadPixels(handle, resident.GenerateMipMaps, resident.Width, resident.Height, imageFormat, PixelType::UByte, pixels, 0, 0);
+			stbi_image_free(data);
+			state->ResidentLevel = residentLevel;
+			state->Succeeded = true;
+		}
 
-		// Allocates our memory
-		_SetTextureParams();
+		std::lock_guard<std::mutex> lock(state->Mutex);
+		state->Handle = handle;
+		state->IsUploading = false;
+		if (state->IsOrphaned && handle != 0) {
+			glDeleteTextures(1, &handle);
+		}
+	};
+	GlUploadThread::Job complete = [state]() {
+		// The GPU is done with the upload, the texture is ready to use
+		Texture2D* owner = state->Owner;
+		if (owner != nullptr) {
+			if (state->Succeeded) {
+				owner->_description.Format = state->Result.Format;
+				owner->_description.Width = state->Result.Width;
+				owner->_description.Height = state->Result.Height;
+				if (state->IsStreaming) {
+					glDeleteTextures(1, &owner->_rendererId);
+					owner->_rendererId = state->Handle;
+					owner->SetDebugName(owner->_description.Filename);
+				}
+				owner->_residentLevel = state->ResidentLevel;
+			}
+			owner->_pendingLevel = owner->_residentLevel;
+			owner->_asyncUpload = nullptr;
+		}
+		// The texture went away after the upload finished, so nobody owns the new texture
+		else if (state->IsStreaming && state->Succeeded && !state->IsOrphaned) {
+			glDeleteTextures(1, &state->Handle);
+		}
+	};
 
-		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
+	if (async && GlUploadThread::IsEnabled()) {
+		GlUploadThread::Submit(upload, complete);
+	} else {
+		upload();
+		complete();
+	}
+}
 
-		// We now have data in the image, we can clear the STBI data
-		stbi_image_free(data);
+void Texture2D::_EvictToLevel(uint32_t level) {
+	LOG_ASSERT(level > _residentLevel && _asyncUpload == nullptr, "Can only evict levels from a texture that isn't being streamed");
+
+	Texture2DDescription resident = _description;
+	resident.Width = glm::max(1u, _description.Width >> level);
+	resident.Height = glm::max(1u, _description.Height >> level);
+
+	// The levels we're keeping are already on the GPU, so we can copy them straight across
+	// instead of decoding the file again
+	uint32_t handle = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &handle);
+	_AllocateStorage(handle, resident);
+	int levels = CalcRequiredMipLevels(resident.Width, resident.Height);
+	uint32_t offset = level - _residentLevel;
+	for (int ix = 0; ix < levels; ix++) {
+		GLsizei width = glm::max(1u, resident.Width >> ix);
+		GLsizei height = glm::max(1u, resident.Height >> ix);
+		glCopyImageSubData(_rendererId, GL_TEXTURE_2D, offset + ix, 0, 0, 0, handle, GL_TEXTURE_2D, ix, 0, 0, 0, width, height, 1);
 	}
-	
+
+	glDeleteTextures(1, &_rendererId);
+	_rendererId = handle;
+	_residentLevel = level;
+	_pendingLevel = level;
 	SetDebugName(_description.Filename);
 }
 
@@ -174,25 +462,31 @@ void Texture2D::_SetTextureParams() {
 	if ((_description.Width * _description.Height > 0) && _description.Format != InternalFormat::Unknown) {
 		// If the texture is NOT multisampled, we proceed as normal
 		if (_description.MultisampleCount == 1) {
-			// Calculate how many layers of storage to allocate based on whether mipmaps are enabled or not
-			int layers = _description.GenerateMipMaps ? CalcRequiredMipLevels(_description.Width, _description.Height) : 1;
-			// Allocates the memory for our texture
-			glTextureStorage2D(_rendererId, layers, (GLenum)_description.Format, _description.Width, _description.Height);
-
-			glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
-			glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
-			glTextureParameterf(_rendererId, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+			_AllocateStorage(_rendererId, _description);
 		}
 		// Texture is multisampled, we need to allocate memory differently
 		else {
 			glTextureStorage2DMultisample(_rendererId, _description.MultisampleCount, *_description.Format, _description.Width, _description.Height, true);
+			glTextureParameteri(_rendererId, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
+			glTextureParameteri(_rendererId, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
 		}
-
-		glTextureParameteri(_rendererId, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
-		glTextureParameteri(_rendererId, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
 	}
 }
 
+void Texture2D::_AllocateStorage(uint32_t handle, const Texture2DDescription& description) {
+	// Calculate how many layers of storage to allocate based on whether mipmaps are enabled or not
+	int layers = description.GenerateMipMaps ? CalcRequiredMipLevels(description.Width, description.Height) : 1;
+	// Allocates the memory for our texture
+	glTextureStorage2D(handle, layers, (GLenum)description.Format, description.Width, description.Height);
+
+	glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, (GLenum)description.MinificationFilter);
+	glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, (GLenum)description.MagnificationFilter);
+	glTextureParameterf(handle, GL_TEXTURE_MAX_ANISOTROPY, description.MaxAnisotropic);
+
+	glTextureParameteri(handle, GL_TEXTURE_WRAP_S, (GLenum)description.HorizontalWrap);
+	glTextureParameteri(handle, GL_TEXTURE_WRAP_T, (GLenum)description.VerticalWrap);
+}
+
 Texture2D::Sptr Texture2D::LoadFromFile(const std::string& path, const Texture2DDescription& description, bool forceRgba) {
 	// Create a copy of the description and change filename to the path
 	Texture2DDescription desc = description;
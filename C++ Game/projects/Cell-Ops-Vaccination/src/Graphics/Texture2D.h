@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include "ITexture.h"
 
 /// <summary>
@@ -60,6 +61,19 @@ struct Texture2DDescription {
 	/// </summary>
 	PixelFormat    FormatHint;
 
+	/// <summary>
+	/// True if the file should be decoded and uploaded on the GlUploadThread, when it is running.
+	/// The texture will be empty until the upload completes, so this should only be used for
+	/// textures that can pop in, and not ones whose size is needed straight away
+	/// </summary>
+	bool           AsyncUpload;
+
+	/// <summary>
+	/// True if only the mip levels needed for how large the texture appears on screen should be
+	/// kept in video memory, see TextureStreamer. Requires GenerateMipMaps
+	/// </summary>
+	bool           Streamed;
+
 	Texture2DDescription() :
 		Width(0), Height(0),
 		Format(InternalFormat::Unknown),
@@ -71,7 +85,9 @@ struct Texture2DDescription {
 		GenerateMipMaps(true),
 		MultisampleCount(1),
 		Filename(""),
-		FormatHint(PixelFormat::RGBA)
+		FormatHint(PixelFormat::RGBA),
+		AsyncUpload(false),
+		Streamed(false)
 	{ }
 };
 
@@ -80,7 +96,7 @@ public:
 	DEFINE_RESOURCE(Texture2D)
 
 	// Make sure we mark our destructor as virtual so base class is called
-	virtual ~Texture2D() = default;
+	virtual ~Texture2D();
 
 public:
 	Texture2D(const std::string& filePath);
@@ -121,6 +137,8 @@ public:
 	float GetAnisoLevel() const { return _description.MaxAnisotropic; }
 	void SetAnisoLevel(float value);
 
+	virtual bool GetSamplerDescription(SamplerDescription* result) const override;
+
 	/// <summary>
 	/// Loads a region of data into this texture
 	/// Bounds must be contained by the bounds of the texture
@@ -141,11 +159,66 @@ public:
 	/// </summary>
 	const Texture2DDescription& GetDescription() const { return _description; }
 
+	/// <summary>
+	/// Returns true if the texture's data is still being uploaded on the GlUploadThread
+	/// </summary>
+	bool IsUploading() const { return _asyncUpload != nullptr; }
+
+	/// <summary>
+	/// Returns true if this texture's mip levels are managed by the TextureStreamer
+	/// </summary>
+	bool IsStreamed() const { return _isStreamed; }
+	/// <summary>
+	/// Gets the number of the most detailed mip level that is in video memory, 0 when the
+	/// full resolution image is resident
+	/// </summary>
+	uint32_t GetResidentLevel() const { return _residentLevel; }
+	/// <summary>
+	/// Gets the approximate number of bytes of video memory that this texture is using
+	/// </summary>
+	size_t GetResidentBytes() const;
+
+	virtual void RequestScreenSize(float pixels) override;
+
 	virtual nlohmann::json ToJson() const override;
 	static Texture2D::Sptr FromJson(const nlohmann::json& data);
 
 protected:
+	// State shared with an upload on the GlUploadThread
+	struct AsyncUploadState {
+		std::mutex Mutex;
+		// Cleared by the upload thread once it's done with the texture
+		bool       IsUploading = true;
+		// Set if the texture was destroyed mid-upload, the upload thread then deletes it
+		bool       IsOrphaned = false;
+		// Main thread only, null once the texture is destroyed
+		Texture2D* Owner = nullptr;
+		// The results of the upload, filled in by the upload thread
+		Texture2DDescription Result;
+		bool       Succeeded = false;
+		// The texture being uploaded into. When streaming this is a new texture that replaces
+		// the owner's once it's done, rather than the owner's own texture
+		uint32_t   Handle = 0;
+		bool       IsStreaming = false;
+		// The mip level that the uploaded texture starts at
+		uint32_t   ResidentLevel = 0;
+	};
+
 	Texture2DDescription _description;
+	std::shared_ptr<AsyncUploadState> _asyncUpload;
+
+	// Streaming state, see TextureStreamer
+	bool     _isStreamed;
+	uint32_t _residentLevel;
+	// The most detailed level requested while drawing this frame
+	uint32_t _requestedLevel;
+	// The level an in-flight upload will bring us to
+	uint32_t _pendingLevel;
+	uint64_t _lastRequestFrame;
+	// The frame that we started wanting more detail than we have, 0 if we have all we need
+	uint64_t _blurrySinceFrame;
+
+	friend class TextureStreamer;
 
 	/// <summary>
 	/// Loads this texture from the file specified in the description
@@ -153,10 +226,49 @@ protected:
 	/// </summary>
 	void _LoadDataFromFile();
 	/// <summary>
+	/// Decodes the file and uploads it starting at the given mip level, replacing our texture
+	/// once it's done
+	/// </summary>
+	/// <param name="level">The most detailed mip level to upload, or -1 for the streaming minimum</param>
+	/// <param name="intoNewTexture">True to upload into a new texture and swap it in, false to fill in our current (empty) texture</param>
+	/// <param name="async">True to do the work on the GlUploadThread, if it's running</param>
+	void _UploadFromFile(int level, bool intoNewTexture, bool async);
+	/// <summary>
+	/// Drops our most detailed mip levels, by copying the smaller levels into a new texture
+	/// </summary>
+	/// <param name="level">The new most detailed level, must be less detailed than the current one</param>
+	void _EvictToLevel(uint32_t level);
+	/// <summary>
+	/// Gets the least detailed level that a streamed texture is allowed to drop to
+	/// </summary>
+	uint32_t _GetMinResidentLevel() const;
+	/// <summary>
+	/// Gets the approximate number of bytes we would use with the given most detailed level resident
+	/// </summary>
+	size_t _GetBytesAtLevel(uint32_t level) const;
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
 
+	/// <summary>
+	/// Reads and decodes the file in the description, and fills in the size and format to match.
+	/// Doesn't touch GL so it can be called from any thread
+	/// </summary>
+	/// <param name="description">The description to load, its size and format are updated</param>
+	/// <param name="imageFormat">Receives the layout of the decoded pixels</param>
+	/// <returns>The decoded pixels, to be freed with stbi_image_free, or nullptr on failure</returns>
+	static uint8_t* _DecodeFile(Texture2DDescription& description, PixelFormat& imageFormat);
+	/// <summary>
+	/// Allocates the storage and sets the parameters for a single sampled texture. Only uses
+	/// DSA calls on the given handle, so it's safe to call from the upload context
+	/// </summary>
+	static void _AllocateStorage(uint32_t handle, const Texture2DDescription& description);
+	/// <summary>
+	/// Uploads pixels to the first level of a texture, and generates mipmaps if requested
+	/// </summary>
+	static void _UploadPixels(uint32_t handle, bool generateMipMaps, uint32_t width, uint32_t height, PixelFormat format, PixelType type, const void* data, uint32_t offsetX, uint32_t offsetY);
+
 public:
 	static Texture2D::Sptr LoadFromFile(const std::string& path, const Texture2DDescription& description = Texture2DDescription(), bool forceRgba = true);
 };
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "stb_image.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/VirtualFileSystem.h"
 
 TextureCube::TextureCube(const std::string& baseFilename) :
 	ITexture(TextureType::Cubemap),
@@ -26,6 +27,16 @@ TextureCube::TextureCube(const TextureCubeDescription& description) :
 	_LoadFromDescription();
 }
 
+bool TextureCube::GetSamplerDescription(SamplerDescription* result) const {
+	// Cubemaps always clamp, otherwise we'd get seams between the faces
+	result->MinificationFilter  = _description.MinificationFilter;
+	result->MagnificationFilter = _description.MagnificationFilter;
+	result->HorizontalWrap      = WrapMode::ClampToEdge;
+	result->VerticalWrap        = WrapMode::ClampToEdge;
+	result->DepthWrap           = WrapMode::ClampToEdge;
+	return true;
+}
+
 nlohmann::json TextureCube::ToJson() const
 {
 	nlohmann::json result;
@@ -82,7 +93,7 @@ void TextureCube::_LoadFromDescription()
 			targetPath += baseName.extension();
 
 			// If the file exists, store it in the description
-			if (std::filesystem::exists(targetPath)) {
+			if (VirtualFileSystem::Exists(targetPath.string())) {
 				_description.FaceFileNames[face] = targetPath.string();
 			}
 		}
@@ -115,9 +126,13 @@ void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>
 		const std::string& filename = _description.FaceFileNames[face];
 		int fileWidth, fileHeight, fileNumChannels;
 
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(filename.c_str(), &fileWidth, &fileHeight, &fileNumChannels, 0);
+		// Read the file through the VFS so it can come from a pack, then let STBI decode it
+		std::string fileData;
+		uint8_t* data = nullptr;
+		if (VirtualFileSystem::ReadFile(filename, fileData)) {
+			stbi_set_flip_vertically_on_load(true);
+			data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(fileData.data()), (int)fileData.size(), &fileWidth, &fileHeight, &fileNumChannels, 0);
+		}
 
 		// If we could not load any data, warn and return null
 		if (data == nullptr) {
@@ -102,6 +102,8 @@ public:
 	/// </summary>
 	MagFilter GetMagFilter() const { return _description.MagnificationFilter; }
 
+	virtual bool GetSamplerDescription(SamplerDescription* result) const override;
+
 	/// <summary>
 	/// Gets this texture's description, which contains basic information about the
 	/// texture's dimensions and creation parameters
@@ -0,0 +1,153 @@
+#include "Graphics/TextureStreamer.h"
+
+#include <algorithm>
+#include <imgui.h>
+
+#include "Graphics/Texture2D.h"
+#include "Utils/ImGuiHelper.h"
+
+std::vector<Texture2D*> TextureStreamer::_textures;
+uint64_t TextureStreamer::_frameIndex = 1;
+size_t   TextureStreamer::_budget = 512ull * 1024 * 1024;
+uint32_t TextureStreamer::_minResidentSize = 64;
+uint32_t TextureStreamer::_maxUploadsPerFrame = 2;
+uint32_t TextureStreamer::_evictAfterFrames = 120;
+size_t   TextureStreamer::_residentBytes = 0;
+uint32_t TextureStreamer::_blurryCount = 0;
+uint32_t TextureStreamer::_uploadingCount = 0;
+float    TextureStreamer::_averageFramesToSharp = 0.0f;
+
+void TextureStreamer::Register(Texture2D* texture) {
+	_textures.push_back(texture);
+}
+
+void TextureStreamer::Unregister(Texture2D* texture) {
+	auto it = std::find(_textures.begin(), _textures.end(), texture);
+	if (it != _textures.end()) {
+		*it = _textures.back();
+		_textures.pop_back();
+	}
+}
+
+void TextureStreamer::Update() {
+	struct Candidate {
+		Texture2D* Texture;
+		uint32_t   Wanted;
+	};
+	std::vector<Candidate> upgrades;
+	std::vector<Candidate> evictions;
+
+	size_t resident = 0;
+	_blurryCount = 0;
+	_uploadingCount = 0;
+
+	for (Texture2D* texture : _textures) {
+		// Still loading the first time, we don't know how big it is yet
+		if (texture->_description.Width * texture->_description.Height == 0) {
+			continue;
+		}
+
+		if (texture->IsUploading()) {
+			resident += texture->_GetBytesAtLevel(std::min(texture->_residentLevel, texture->_pendingLevel));
+			_uploadingCount++;
+			continue;
+		}
+		resident += texture->GetResidentBytes();
+
+		// Textures we've drawn this frame want whatever they asked for. If we've seen it recently
+		// we hold on to what we have, otherwise it can drop to the minimum
+		uint32_t minLevel = texture->_GetMinResidentLevel();
+		uint32_t wanted = minLevel;
+		if (texture->_lastRequestFrame == _frameIndex) {
+			wanted = texture->_requestedLevel;
+		} else if (texture->_lastRequestFrame + _evictAfterFrames >= _frameIndex) {
+			wanted = texture->_residentLevel;
+		}
+
+		if (wanted < texture->_residentLevel) {
+			if (texture->_blurrySinceFrame == 0) {
+				texture->_blurrySinceFrame = _frameIndex;
+			}
+			upgrades.push_back(Candidate{ texture, wanted });
+			_blurryCount++;
+		} else {
+			if (texture->_blurrySinceFrame != 0) {
+				float frames = (float)(_frameIndex - texture->_blurrySinceFrame);
+				_averageFramesToSharp = _averageFramesToSharp == 0.0f ? frames : _averageFramesToSharp + (frames - _averageFramesToSharp) * 0.1f;
+				texture->_blurrySinceFrame = 0;
+			}
+			if (wanted > texture->_residentLevel) {
+				evictions.push_back(Candidate{ texture, wanted });
+			}
+		}
+	}
+
+	// The blurriest textures go first, and the textures we haven't seen in the longest get evicted first
+	std::sort(upgrades.begin(), upgrades.end(), [](const Candidate& a, const Candidate& b) {
+		return (a.Texture->_residentLevel - a.Wanted) > (b.Texture->_residentLevel - b.Wanted);
+	});
+	std::sort(evictions.begin(), evictions.end(), [](const Candidate& a, const Candidate& b) {
+		return a.Texture->_lastRequestFrame < b.Texture->_lastRequestFrame;
+	});
+
+	size_t nextEviction = 0;
+	auto evictOne = [&]() {
+		if (nextEviction >= evictions.size()) {
+			return false;
+		}
+		const Candidate& victim = evictions[nextEviction++];
+		resident -= victim.Texture->GetResidentBytes() - victim.Texture->_GetBytesAtLevel(victim.Wanted);
+		victim.Texture->_EvictToLevel(victim.Wanted);
+		return true;
+	};
+
+	// If we're already over budget (ex: the budget was lowered), drop unneeded levels first
+	while (resident > _budget && evictOne()) { }
+
+	uint32_t started = 0;
+	for (const Candidate& upgrade : upgrades) {
+		if (started >= _maxUploadsPerFrame) {
+			break;
+		}
+
+		// Make room if we can, otherwise settle for a less detailed level that does fit
+		Texture2D* texture = upgrade.Texture;
+		uint32_t target = upgrade.Wanted;
+		size_t extra = 0;
+		while (target < texture->_residentLevel) {
+			extra = texture->_GetBytesAtLevel(target) - texture->GetResidentBytes();
+			if (resident + extra <= _budget) {
+				break;
+			}
+			if (!evictOne()) {
+				target++;
+			}
+		}
+
+		if (target < texture->_residentLevel) {
+			texture->_pendingLevel = target;
+			texture->_UploadFromFile((int)target, true, true);
+			resident += extra;
+			started++;
+		}
+	}
+
+	_residentBytes = resident;
+	_uploadingCount += started;
+	_frameIndex++;
+}
+
+void TextureStreamer::RenderImGui() {
+	float budgetMb = _budget / (1024.0f * 1024.0f);
+	if (LABEL_LEFT(ImGui::DragFloat, "Budget (MB)", &budgetMb, 1.0f, 1.0f, 8192.0f)) {
+		_budget = (size_t)(budgetMb * 1024.0f * 1024.0f);
+	}
+	int minSize = (int)_minResidentSize;
+	if (LABEL_LEFT(ImGui::DragInt, "Min Size   ", &minSize, 1.0f, 1, 4096)) {
+		_minResidentSize = (uint32_t)std::max(1, minSize);
+	}
+
+	ImGui::Text("Resident: %.2f MB in %u textures", _residentBytes / (1024.0f * 1024.0f), (uint32_t)_textures.size());
+	ImGui::Text("Streaming: %u, waiting for detail: %u", _uploadingCount, _blurryCount);
+	ImGui::Text("Time to sharp: %.1f frames", _averageFramesToSharp);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class Texture2D;
+
+/// <summary>
+/// Keeps only the mip levels of streamed textures that are actually needed in video memory.
+///
+/// Streamed textures start out with only their smallest levels resident. While drawing, the
+/// renderer tells each texture roughly how large it appears on screen (see
+/// ITexture::RequestScreenSize), and once per frame Update streams in the more detailed levels
+/// that were asked for, on the GlUploadThread when it's running. When the resident textures
+/// would go over the memory budget, the levels of textures that haven't been seen recently (or
+/// are more detailed than they need to be) are dropped first.
+///
+/// All functions must be called from the main thread
+/// </summary>
+class TextureStreamer {
+public:
+	TextureStreamer() = delete;
+
+	/// <summary>
+	/// Starts managing a streamed texture, called by the texture itself
+	/// </summary>
+	static void Register(Texture2D* texture);
+	/// <summary>
+	/// Stops managing a texture, called by the texture when it is destroyed
+	/// </summary>
+	static void Unregister(Texture2D* texture);
+
+	/// <summary>
+	/// Streams in requested levels and evicts unneeded ones, should be called once per frame
+	/// after everything has been drawn
+	/// </summary>
+	static void Update();
+
+	/// <summary>
+	/// Gets the number of the current streaming frame, used to tell which requests are fresh
+	/// </summary>
+	static uint64_t GetFrameIndex() { return _frameIndex; }
+
+	/// <summary>
+	/// Sets the maximum number of bytes of video memory that streamed textures may use. The
+	/// smallest levels of each texture are always kept, even if they go over the budget
+	/// </summary>
+	static void SetBudget(size_t bytes) { _budget = bytes; }
+	static size_t GetBudget() { return _budget; }
+	/// <summary>
+	/// Sets the size in texels of the largest side of the smallest level that streamed textures keep resident
+	/// </summary>
+	static void SetMinResidentSize(uint32_t texels) { _minResidentSize = texels; }
+	static uint32_t GetMinResidentSize() { return _minResidentSize; }
+	/// <summary>
+	/// Sets the maximum number of textures that may start streaming in each frame
+	/// </summary>
+	static void SetMaxUploadsPerFrame(uint32_t count) { _maxUploadsPerFrame = count; }
+
+	/// <summary>
+	/// Gets the number of bytes of video memory used by the streamed textures
+	/// </summary>
+	static size_t GetResidentBytes() { return _residentBytes; }
+
+	/// <summary>
+	/// Renders ImGui controls and statistics for the streamer
+	/// </summary>
+	static void RenderImGui();
+
+private:
+	static std::vector<Texture2D*> _textures;
+	static uint64_t _frameIndex;
+	static size_t   _budget;
+	static uint32_t _minResidentSize;
+	static uint32_t _maxUploadsPerFrame;
+	// Textures that haven't been requested in this many frames are the first to be evicted
+	static uint32_t _evictAfterFrames;
+
+	// Stats from the last update
+	static size_t   _residentBytes;
+	static uint32_t _blurryCount;
+	static uint32_t _uploadingCount;
+	// Rolling average of how many frames it takes for a texture to reach the level it wants
+	static float    _averageFramesToSharp;
+};
@@ -0,0 +1,120 @@
+#include "Utils/AsyncFileWriter.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+
+#include "Logging.h"
+
+namespace fs = std::filesystem;
+
+std::thread                       AsyncFileWriter::_worker;
+std::mutex                        AsyncFileWriter::_mutex;
+std::condition_variable           AsyncFileWriter::_jobReady;
+std::condition_variable           AsyncFileWriter::_jobsDone;
+std::deque<AsyncFileWriter::WriteJob> AsyncFileWriter::_jobs;
+bool                              AsyncFileWriter::_isWriting = false;
+bool                              AsyncFileWriter::_isStopping = false;
+
+namespace {
+	double Now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+void AsyncFileWriter::Write(const std::string& path, std::vector<Chunk>&& chunks) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = std::find_if(_jobs.begin(), _jobs.end(), [&](const WriteJob& job) { return job.Path == path; });
+		if (it != _jobs.end()) {
+			it->Chunks = std::move(chunks);
+		} else {
+			_jobs.push_back(WriteJob{ path, std::move(chunks), Now() });
+		}
+		_isStopping = false;
+	}
+	if (!_worker.joinable()) {
+		_worker = std::thread(&AsyncFileWriter::_WorkerMain);
+	}
+	_jobReady.notify_one();
+}
+
+bool AsyncFileWriter::WriteAtomic(const std::string& path, const std::vector<Chunk>& chunks) {
+	fs::path target(path);
+	fs::path temp = target;
+	temp += ".tmp";
+
+	{
+		std::ofstream output(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+		for (const Chunk& chunk : chunks) {
+			output.write(chunk->data(), chunk->size());
+		}
+		output.flush();
+		if (!output) {
+			LOG_ERROR("Failed to write \"{}\"", temp.string());
+			output.close();
+			std::error_code ec;
+			fs::remove(temp, ec);
+			return false;
+		}
+	}
+
+	// Swap the new file in, this replaces the old file in one step
+	std::error_code ec;
+	fs::rename(temp, target, ec);
+	if (ec) {
+		LOG_ERROR("Failed to replace \"{}\": {}", path, ec.message());
+		fs::remove(temp, ec);
+		return false;
+	}
+	return true;
+}
+
+void AsyncFileWriter::Flush() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_jobsDone.wait(lock, []() { return _jobs.empty() && !_isWriting; });
+}
+
+void AsyncFileWriter::Shutdown() {
+	if (!_worker.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_jobReady.notify_one();
+	_worker.join();
+}
+
+void AsyncFileWriter::_WorkerMain() {
+	while (true) {
+		WriteJob job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobReady.wait(lock, []() { return _isStopping || !_jobs.empty(); });
+			// Pending writes still get finished when stopping, we don't want to lose a save on exit
+			if (_jobs.empty()) return;
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+			_isWriting = true;
+		}
+
+		double startTime = Now();
+		size_t bytes = 0;
+		for (const Chunk& chunk : job.Chunks) {
+			bytes += chunk->size();
+		}
+		if (WriteAtomic(job.Path, job.Chunks)) {
+			double endTime = Now();
+			LOG_INFO("Wrote \"{}\" ({} KB) in {:.2f}ms, {:.2f}ms after it was queued", job.Path, bytes / 1024, (endTime - startTime) * 1000.0, (endTime - job.QueueTime) * 1000.0);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isWriting = false;
+		}
+		_jobsDone.notify_all();
+	}
+}
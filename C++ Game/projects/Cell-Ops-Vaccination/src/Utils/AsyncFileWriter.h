@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/// <summary>
+/// Writes files on a background thread, so that saving doesn't stall the main thread on disk IO.
+/// File contents are given as a list of immutable chunks that get written back to back, which
+/// lets callers hand over cached text without copying it.
+///
+/// Files are written to a temporary file next to the target first, then renamed over the
+/// target, so a crash or failure mid-write never leaves a half written file behind
+/// </summary>
+class AsyncFileWriter {
+public:
+	AsyncFileWriter() = delete;
+
+	typedef std::shared_ptr<const std::string> Chunk;
+
+	/// <summary>
+	/// Queues a file to be written. If a write to the same path is still waiting in the queue,
+	/// it is replaced, since only the newest contents matter
+	/// </summary>
+	/// <param name="path">The path of the file to write</param>
+	/// <param name="chunks">The contents of the file, written in order</param>
+	static void Write(const std::string& path, std::vector<Chunk>&& chunks);
+	/// <summary>
+	/// Writes a file on the calling thread, via a temporary file that is renamed over the target
+	/// </summary>
+	/// <returns>True if the file was written</returns>
+	static bool WriteAtomic(const std::string& path, const std::vector<Chunk>& chunks);
+
+	/// <summary>
+	/// Blocks until all queued writes have finished
+	/// </summary>
+	static void Flush();
+	/// <summary>
+	/// Finishes all queued writes and stops the worker thread, should be called before exiting
+	/// </summary>
+	static void Shutdown();
+
+private:
+	struct WriteJob {
+		std::string        Path;
+		std::vector<Chunk> Chunks;
+		double             QueueTime;
+	};
+
+	static std::thread             _worker;
+	static std::mutex              _mutex;
+	static std::condition_variable _jobReady;
+	static std::condition_variable _jobsDone;
+	static std::deque<WriteJob>    _jobs;
+	static bool                    _isWriting;
+	static bool                    _isStopping;
+
+	static void _WorkerMain();
+};
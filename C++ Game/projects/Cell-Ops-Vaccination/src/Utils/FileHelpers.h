@@ -7,7 +7,7 @@ class FileHelpers {
 public:
 	FileHelpers() = delete;
 	/// <summary>
-	/// Reads the entire contents of a file into a string
+	/// Reads the entire contents of a file into a string, through the VirtualFileSystem
 	/// </summary>
 	/// <param name="filename">The path of the file to load</param>
 	/// <returns>The entire contents of the file stored in a string</returns>
@@ -0,0 +1,69 @@
+#pragma once
+#include <GLM/glm.hpp>
+
+/// <summary>
+/// Represents the 6 clipping planes of a camera, extracted from a view-projection matrix.
+/// Used for cheap visibility tests against bounding spheres and boxes
+/// </summary>
+struct Frustum {
+	// Planes are stored as (normal, distance), with normals pointing into the frustum
+	// Order is left, right, bottom, top, near, far
+	glm::vec4 Planes[6];
+
+	Frustum() : Planes() {}
+
+	/// <summary>
+	/// Extracts the frustum planes from a combined view-projection matrix (Gribb/Hartmann)
+	/// </summary>
+	/// <param name="viewProjection">The camera's view projection matrix</param>
+	explicit Frustum(const glm::mat4& viewProjection) {
+		// GLM is column major, so we need to transpose to get at the rows
+		glm::mat4 rows = glm::transpose(viewProjection);
+		Planes[0] = rows[3] + rows[0];
+		Planes[1] = rows[3] - rows[0];
+		Planes[2] = rows[3] + rows[1];
+		Planes[3] = rows[3] - rows[1];
+		Planes[4] = rows[3] + rows[2];
+		Planes[5] = rows[3] - rows[2];
+
+		// Normalize so that distances come out in world units
+		for (int ix = 0; ix < 6; ix++) {
+			Planes[ix] /= glm::length(glm::vec3(Planes[ix]));
+		}
+	}
+
+	/// <summary>
+	/// Returns true if any part of the sphere is inside the frustum
+	/// </summary>
+	/// <param name="center">The center of the sphere in world space</param>
+	/// <param name="radius">The radius of the sphere in world units</param>
+	bool IntersectsSphere(const glm::vec3& center, float radius) const {
+		for (int ix = 0; ix < 6; ix++) {
+			if (glm::dot(glm::vec3(Planes[ix]), center) + Planes[ix].w < -radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Returns true if any part of the axis aligned box is inside the frustum
+	/// </summary>
+	/// <param name="min">The minimum corner of the box in world space</param>
+	/// <param name="max">The maximum corner of the box in world space</param>
+	bool IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+		for (int ix = 0; ix < 6; ix++) {
+			// Test the corner that is furthest along the plane normal
+			glm::vec3 normal = glm::vec3(Planes[ix]);
+			glm::vec3 corner = glm::vec3(
+				normal.x >= 0.0f ? max.x : min.x,
+				normal.y >= 0.0f ? max.y : min.y,
+				normal.z >= 0.0f ? max.z : min.z
+			);
+			if (glm::dot(normal, corner) + Planes[ix].w < 0.0f) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
@@ -114,6 +114,10 @@ void ImGuiHelper::HeaderCheckbox(ImGuiID headerId, bool* value)
 	last_item_backup.Restore();
 }
 
+bool ImGuiHelper::IsAnyItemEditedThisFrame() {
+	return GImGui->ActiveIdHasBeenEditedThisFrame;
+}
+
 void ImGuiHelper::StartFrame() {
 	LOG_ASSERT(_window != nullptr, "You must initialize ImGuiHelper before use!");
 
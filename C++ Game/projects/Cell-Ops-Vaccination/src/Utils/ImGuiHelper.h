@@ -41,6 +41,12 @@ public:
 
 	static void HeaderCheckbox(ImGuiID headerId, bool* value);
 
+	/// <summary>
+	/// Returns true if a widget has changed its value so far this frame. Checking this before
+	/// and after drawing a group of widgets tells us if anything in that group was edited
+	/// </summary>
+	static bool IsAnyItemEditedThisFrame();
+
 protected:
 	ImGuiHelper() = default;
 
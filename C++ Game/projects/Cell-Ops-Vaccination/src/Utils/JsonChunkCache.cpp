@@ -0,0 +1,53 @@
+#include "Utils/JsonChunkCache.h"
+
+JsonChunkCache::JsonChunkCache() :
+	_entries(),
+	_rebuildCount(0)
+{ }
+
+JsonChunkCache::Chunk JsonChunkCache::_Store(const Guid& key, uint64_t revision, std::string&& text) {
+	Chunk result = std::make_shared<const std::string>(std::move(text));
+	_entries[key] = Entry{ revision, result, true };
+	_rebuildCount++;
+	return result;
+}
+
+void JsonChunkCache::Prune() {
+	for (auto it = _entries.begin(); it != _entries.end(); ) {
+		if (!it->second.Used) {
+			it = _entries.erase(it);
+		} else {
+			it->second.Used = false;
+			it++;
+		}
+	}
+	_rebuildCount = 0;
+}
+
+void JsonChunkCache::Clear() {
+	_entries.clear();
+	_rebuildCount = 0;
+}
+
+JsonChunkCache::Chunk JsonChunkCache::MakeChunk(const std::string& text) {
+	return std::make_shared<const std::string>(text);
+}
+
+std::string JsonChunkCache::_Indent(std::string&& text, int depth) {
+	if (depth <= 0) {
+		return std::move(text);
+	}
+
+	// Newlines can only appear between tokens (they're escaped in strings), so we can
+	// safely indent after every one of them
+	std::string indent(depth, '\t');
+	std::string result;
+	result.reserve(text.size() + text.size() / 8);
+	for (char c : text) {
+		result.push_back(c);
+		if (c == '\n') {
+			result.append(indent);
+		}
+	}
+	return result;
+}
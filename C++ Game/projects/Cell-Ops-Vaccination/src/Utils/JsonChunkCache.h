@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <json.hpp>
+
+#include "Utils/GUID.hpp"
+
+/// <summary>
+/// Caches the serialized text of the entries in a JSON file (such as the objects in a scene,
+/// or the resources in a manifest), along with the revision that each entry was serialized
+/// at. Saves can then re-serialize only the entries that changed since the last save, and
+/// stitch the rest of the file together from cached text.
+///
+/// Chunks are immutable once created, so a list of them can safely be handed off to another
+/// thread to be written out while the originals keep changing
+/// </summary>
+class JsonChunkCache {
+public:
+	typedef std::shared_ptr<const std::string> Chunk;
+
+	JsonChunkCache();
+	~JsonChunkCache() = default;
+
+	/// <summary>
+	/// Gets the serialized text for an entry, calling serialize to rebuild it if the entry's
+	/// revision has changed since it was cached
+	/// </summary>
+	/// <param name="key">The unique ID of the entry</param>
+	/// <param name="revision">The current revision of the entry</param>
+	/// <param name="prefix">Text to put before the entry, such as indentation or an object key</param>
+	/// <param name="depth">The indentation depth that the entry will be written at</param>
+	/// <param name="serialize">Returns the entry's JSON representation</param>
+	template <typename Serializer>
+	Chunk Get(const Guid& key, uint64_t revision, const std::string& prefix, int depth, const Serializer& serialize) {
+		auto it = _entries.find(key);
+		if (it != _entries.end() && it->second.Revision == revision) {
+			it->second.Used = true;
+			return it->second.Text;
+		}
+
+		// Either a new entry or it's changed, serialize it again
+		return _Store(key, revision, prefix + Dump(serialize(), depth));
+	}
+
+	/// <summary>
+	/// Removes any entries that have not been requested since the last call to Prune, such as
+	/// deleted objects, and resets the rebuild counter
+	/// </summary>
+	void Prune();
+	/// <summary>
+	/// Removes all cached entries
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Gets the number of entries that were re-serialized since the last call to Prune
+	/// </summary>
+	size_t GetRebuildCount() const { return _rebuildCount; }
+
+	/// <summary>
+	/// Makes a chunk from some constant text, such as separators between entries
+	/// </summary>
+	static Chunk MakeChunk(const std::string& text);
+	/// <summary>
+	/// Dumps a JSON value with tab indentation, matching dump(1, '\t'), but with every line
+	/// after the first indented by the given depth so it can be nested inside other text
+	/// </summary>
+	template <typename JsonType>
+	static std::string Dump(const JsonType& value, int depth) {
+		return _Indent(value.dump(1, '\t'), depth);
+	}
+
+private:
+	struct Entry {
+		uint64_t Revision;
+		Chunk    Text;
+		bool     Used;
+	};
+	std::unordered_map<Guid, Entry> _entries;
+	size_t _rebuildCount;
+
+	Chunk _Store(const Guid& key, uint64_t revision, std::string&& text);
+	static std::string _Indent(std::string&& text, int depth);
+};
@@ -0,0 +1,251 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <json.hpp>
+
+#include "Logging.h"
+
+/// <summary>
+/// Streams a JSON document with nlohmann's SAX interface, only building the parts of the
+/// document that the caller asks for. Values are selected with path patterns, where each
+/// element is an object key, an array index, or "*" to match anything.
+///
+/// Containers that lead towards a pattern are streamed through without being built. Values
+/// that match a pattern are built and handed to the callback as soon as they are complete,
+/// so the caller can consume them and let them go before the next one is parsed. Anything
+/// else is skipped. This keeps peak memory down to the largest single matched value, rather
+/// than the whole document
+///
+/// Usage:
+/// JsonSaxReader<> reader({ { "objects", "*" }, { "*" } }, [&](const auto& path, nlohmann::json& value) { ... });
+/// bool success = nlohmann::json::sax_parse(content, &reader);
+/// </summary>
+template <typename BasicJsonType = nlohmann::json>
+class JsonSaxReader : public nlohmann::json_sax<BasicJsonType> {
+public:
+	using Path     = std::vector<std::string>;
+	using Callback = std::function<void(const Path& path, BasicJsonType& value)>;
+
+	using number_integer_t  = typename BasicJsonType::number_integer_t;
+	using number_unsigned_t = typename BasicJsonType::number_unsigned_t;
+	using number_float_t    = typename BasicJsonType::number_float_t;
+	using string_t          = typename BasicJsonType::string_t;
+	using binary_t          = typename BasicJsonType::binary_t;
+
+	/// <summary>
+	/// Creates a new reader
+	/// </summary>
+	/// <param name="patterns">The paths of the values to build and hand to the callback</param>
+	/// <param name="callback">Invoked with the path and value of every matched value, in document order</param>
+	JsonSaxReader(const std::vector<Path>& patterns, const Callback& callback) :
+		_patterns(patterns),
+		_callback(callback),
+		_frames(),
+		_path(),
+		_pendingKey(),
+		_captured(),
+		_captureStack(),
+		_captureKey(),
+		_skipDepth(0)
+	{ }
+
+	virtual bool null() override {
+		return _Scalar(BasicJsonType(nullptr));
+	}
+	virtual bool boolean(bool val) override {
+		return _Scalar(BasicJsonType(val));
+	}
+	virtual bool number_integer(number_integer_t val) override {
+		return _Scalar(BasicJsonType(val));
+	}
+	virtual bool number_unsigned(number_unsigned_t val) override {
+		return _Scalar(BasicJsonType(val));
+	}
+	virtual bool number_float(number_float_t val, const string_t&) override {
+		return _Scalar(BasicJsonType(val));
+	}
+	virtual bool string(string_t& val) override {
+		return _Scalar(BasicJsonType(std::move(val)));
+	}
+	virtual bool binary(binary_t& val) override {
+		return _Scalar(BasicJsonType(std::move(val)));
+	}
+
+	virtual bool start_object(std::size_t) override {
+		return _StartContainer(BasicJsonType::object(), false);
+	}
+	virtual bool key(string_t& val) override {
+		if (_skipDepth > 0) {
+			return true;
+		}
+		if (!_captureStack.empty()) {
+			_captureKey = std::move(val);
+		} else {
+			_pendingKey = std::move(val);
+		}
+		return true;
+	}
+	virtual bool end_object() override {
+		return _EndContainer();
+	}
+
+	virtual bool start_array(std::size_t) override {
+		return _StartContainer(BasicJsonType::array(), true);
+	}
+	virtual bool end_array() override {
+		return _EndContainer();
+	}
+
+	virtual bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) override {
+		LOG_ERROR("JSON parse error at byte {} near \"{}\": {}", position, lastToken, ex.what());
+		return false;
+	}
+
+private:
+	// A container that is being streamed through
+	struct Frame {
+		bool   IsArray;
+		size_t Index;
+	};
+
+	enum class Mode {
+		Stream,
+		Capture,
+		Skip
+	};
+
+	std::vector<Path> _patterns;
+	Callback          _callback;
+
+	std::vector<Frame> _frames;
+	Path               _path;
+	string_t           _pendingKey;
+
+	// The value currently being built, and the containers within it that we're adding to
+	BasicJsonType                _captured;
+	std::vector<BasicJsonType*>  _captureStack;
+	string_t                     _captureKey;
+
+	// How many containers deep we are in a value that's being skipped
+	int _skipDepth;
+
+	static bool _Matches(const Path& path, const Path& pattern, size_t count) {
+		for (size_t ix = 0; ix < count; ix++) {
+			if (pattern[ix] != "*" && pattern[ix] != path[ix]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Works out what to do with the value at the current path
+	Mode _Classify(bool isContainer) const {
+		if (isContainer) {
+			for (const Path& pattern : _patterns) {
+				if (pattern.size() > _path.size() && _Matches(_path, pattern, _path.size())) {
+					return Mode::Stream;
+				}
+			}
+		}
+		for (const Path& pattern : _patterns) {
+			if (pattern.size() == _path.size() && _Matches(_path, pattern, _path.size())) {
+				return Mode::Capture;
+			}
+		}
+		return Mode::Skip;
+	}
+
+	// Adds the path element for a value that is starting in a streamed container
+	void _BeginValue() {
+		if (!_frames.empty()) {
+			Frame& frame = _frames.back();
+			_path.push_back(frame.IsArray ? std::to_string(frame.Index++) : std::string(_pendingKey));
+		}
+	}
+
+	void _EndValue() {
+		if (!_path.empty()) {
+			_path.pop_back();
+		}
+	}
+
+	// Adds a value to the container at the top of the capture stack, returning where it ended up
+	BasicJsonType* _AddCaptured(BasicJsonType&& value) {
+		BasicJsonType* parent = _captureStack.back();
+		if (parent->is_array()) {
+			parent->push_back(std::move(value));
+			return &parent->back();
+		} else {
+			BasicJsonType& slot = (*parent)[_captureKey];
+			slot = std::move(value);
+			return &slot;
+		}
+	}
+
+	bool _Scalar(BasicJsonType&& value) {
+		if (_skipDepth > 0) {
+			return true;
+		}
+		if (!_captureStack.empty()) {
+			_AddCaptured(std::move(value));
+			return true;
+		}
+
+		_BeginValue();
+		if (_Classify(false) == Mode::Capture) {
+			_callback(_path, value);
+		}
+		_EndValue();
+		return true;
+	}
+
+	bool _StartContainer(BasicJsonType&& empty, bool isArray) {
+		if (_skipDepth > 0) {
+			_skipDepth++;
+			return true;
+		}
+		if (!_captureStack.empty()) {
+			_captureStack.push_back(_AddCaptured(std::move(empty)));
+			return true;
+		}
+
+		_BeginValue();
+		switch (_Classify(true)) {
+			case Mode::Stream:
+				_frames.push_back({ isArray, 0 });
+				break;
+			case Mode::Capture:
+				_captured = std::move(empty);
+				_captureStack.push_back(&_captured);
+				break;
+			case Mode::Skip:
+				_skipDepth = 1;
+				break;
+		}
+		return true;
+	}
+
+	bool _EndContainer() {
+		if (_skipDepth > 0) {
+			if (--_skipDepth == 0) {
+				_EndValue();
+			}
+			return true;
+		}
+		if (!_captureStack.empty()) {
+			_captureStack.pop_back();
+			// Finished building a matched value, hand it off then let it go
+			if (_captureStack.empty()) {
+				_callback(_path, _captured);
+				_captured = BasicJsonType();
+				_EndValue();
+			}
+			return true;
+		}
+
+		_frames.pop_back();
+		_EndValue();
+		return true;
+	}
+};
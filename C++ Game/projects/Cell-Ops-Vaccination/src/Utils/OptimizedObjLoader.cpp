@@ -9,6 +9,7 @@
 #include <filesystem>
 
 #include "Utils/StringUtils.h"
+#include "Utils/VirtualFileSystem.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 
@@ -28,7 +29,7 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 		// Get the binary path
 		fs::path binPath = filePath.replace_extension(binaryExtension);
 		// If the file does not exist, convert the OBJ file to a binary file
-		if (!fs::exists(binPath)) {
+		if (!VirtualFileSystem::Exists(binPath.string())) {
 			ConvertToBinary(filename, binPath.string());
 		}
 		// Load the corresponding binary file
@@ -73,14 +74,12 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 }
 
 MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename) {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
-
-	// If our file fails to open, we will throw an error
-	if (!file) {
+	// Read the whole file through the VFS, then parse it from memory
+	std::string contents;
+	if (!VirtualFileSystem::ReadFile(filename, contents)) {
 		throw std::runtime_error("Failed to open file");
 	}
+	std::istringstream file(std::move(contents));
 
 	// Could also take this in as a parameter
 	glm::vec4 color = glm::vec4(1.0f);
@@ -235,10 +234,10 @@ MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(c
 
 VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
 
-	// Open the output file
-	std::ifstream file(filename, std::ios::binary);
-	// If our file fails to open, we will throw an error
-	if (!file) { throw std::runtime_error("Failed to open file"); }
+	// Read the whole file through the VFS, then parse it from memory
+	std::string contents;
+	if (!VirtualFileSystem::ReadFile(filename, contents)) { throw std::runtime_error("Failed to open file"); }
+	std::istringstream file(std::move(contents), std::ios::binary);
 
 	float startTime = static_cast<float>(glfwGetTime());
 
@@ -0,0 +1,87 @@
+#include "Random.h"
+
+namespace {
+	// FNV-1a, used to turn stream names into sequence selectors
+	uint64_t HashName(const std::string& name) {
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (char c : name) {
+			hash ^= (uint8_t)c;
+			hash *= 0x100000001b3ULL;
+		}
+		return hash;
+	}
+
+	// SplitMix64 finalizer, spreads similar seeds out so that streams don't correlate
+	uint64_t MixSeed(uint64_t value) {
+		value += 0x9e3779b97f4a7c15ULL;
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
+	}
+}
+
+nlohmann::json RandomStream::ToJson() const {
+	return {
+		{ "state", _state },
+		{ "increment", _increment }
+	};
+}
+
+RandomStream RandomStream::FromJson(const nlohmann::json& blob) {
+	RandomStream result;
+	result._state = blob["state"].get<uint64_t>();
+	result._increment = blob["increment"].get<uint64_t>() | 1u;
+	return result;
+}
+
+RandomService::RandomService(uint64_t seed) :
+	_seed(seed),
+	_streams()
+{ }
+
+void RandomService::SetSeed(uint64_t seed) {
+	_seed = seed;
+	_streams.clear();
+}
+
+RandomStream& RandomService::GetStream(const std::string& name) {
+	auto it = _streams.find(name);
+	if (it == _streams.end()) {
+		uint64_t hash = HashName(name);
+		it = _streams.emplace(name, RandomStream(MixSeed(_seed ^ hash), hash)).first;
+	}
+	return it->second;
+}
+
+RandomStream RandomService::Fork(const std::string& name) {
+	RandomStream& parent = GetStream(name);
+	// Draw one value per statement, the evaluation order within an expression isn't defined
+	uint64_t seed = (uint64_t)parent.Next() << 32;
+	seed |= parent.Next();
+	uint64_t sequence = (uint64_t)parent.Next() << 32;
+	sequence |= parent.Next();
+	return RandomStream(seed, sequence);
+}
+
+nlohmann::json RandomService::ToJson() const {
+	nlohmann::json streams = nlohmann::json::object();
+	for (const auto& [name, stream] : _streams) {
+		streams[name] = stream.ToJson();
+	}
+	return {
+		{ "seed", _seed },
+		{ "streams", streams }
+	};
+}
+
+void RandomService::LoadFromJson(const nlohmann::json& blob) {
+	if (!blob.is_object()) {
+		return;
+	}
+	SetSeed(blob.contains("seed") ? blob["seed"].get<uint64_t>() : _seed);
+	if (blob.contains("streams") && blob["streams"].is_object()) {
+		for (const auto& [name, stream] : blob["streams"].items()) {
+			_streams[name] = RandomStream::FromJson(stream);
+		}
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <map>
+#include <GLM/glm.hpp>
+#include "json.hpp"
+
+/// <summary>
+/// A single PCG32 random number stream. Streams are small value types, so a system can
+/// take a copy to use on another thread without any locking. Batch helpers produce the
+/// exact same sequence as repeated single calls, so results don't depend on how callers
+/// chunk their requests
+/// </summary>
+class RandomStream {
+public:
+	RandomStream() : RandomStream(0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL) {}
+
+	/// <summary>
+	/// Creates a new stream from a seed and a sequence selector. Streams with the same
+	/// seed but different sequences are independent of each other
+	/// </summary>
+	RandomStream(uint64_t seed, uint64_t sequence) :
+		_state(0),
+		_increment((sequence << 1u) | 1u)
+	{
+		Next();
+		_state += seed;
+		Next();
+	}
+
+	/// <summary>
+	/// Gets the next uniformly distributed 32 bit value
+	/// </summary>
+	uint32_t Next() {
+		uint64_t old = _state;
+		_state = old * 6364136223846793005ULL + _increment;
+		uint32_t xorShifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+		uint32_t rot = (uint32_t)(old >> 59u);
+		return (xorShifted >> rot) | (xorShifted << ((~rot + 1u) & 31u));
+	}
+
+	/// <summary>
+	/// Gets a float in the range [0, 1)
+	/// </summary>
+	float NextFloat() {
+		// Use the top 24 bits, which is all the precision a float mantissa can hold
+		return (float)(Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	/// <summary>
+	/// Gets an integer in the range [min, max), without modulo bias
+	/// </summary>
+	int Range(int min, int max) {
+		if (max <= min) return min;
+		uint32_t range = (uint32_t)(max - min);
+		// Lemire's multiply and reject method
+		uint64_t product = (uint64_t)Next() * range;
+		uint32_t low = (uint32_t)product;
+		if (low < range) {
+			uint32_t threshold = (0u - range) % range;
+			while (low < threshold) {
+				product = (uint64_t)Next() * range;
+				low = (uint32_t)product;
+			}
+		}
+		return min + (int)(product >> 32);
+	}
+
+	/// <summary>
+	/// Gets a float in the range [min, max)
+	/// </summary>
+	float Range(float min, float max) {
+		return min + (max - min) * NextFloat();
+	}
+
+	/// <summary>
+	/// Gets a point uniformly distributed within the given box
+	/// </summary>
+	glm::vec3 InBox(const glm::vec3& min, const glm::vec3& max) {
+		float x = Range(min.x, max.x);
+		float y = Range(min.y, max.y);
+		float z = Range(min.z, max.z);
+		return glm::vec3(x, y, z);
+	}
+
+	/// <summary>
+	/// Fills a buffer with raw 32 bit values
+	/// </summary>
+	void NextBatch(uint32_t* out, size_t count) {
+		for (size_t ix = 0; ix < count; ix++) {
+			out[ix] = Next();
+		}
+	}
+
+	/// <summary>
+	/// Fills a buffer with floats in the range [min, max). The raw values are generated
+	/// first in chunks, so that the conversion loop has no dependencies and can be vectorized
+	/// </summary>
+	void NextBatch(float* out, size_t count, float min = 0.0f, float max = 1.0f) {
+		const float scale = (max - min) * (1.0f / 16777216.0f);
+		uint32_t raw[64];
+		for (size_t start = 0; start < count; start += 64) {
+			size_t chunk = glm::min(count - start, (size_t)64);
+			NextBatch(raw, chunk);
+			for (size_t ix = 0; ix < chunk; ix++) {
+				out[start + ix] = min + (float)(raw[ix] >> 8) * scale;
+			}
+		}
+	}
+
+	bool operator ==(const RandomStream& other) const { return _state == other._state && _increment == other._increment; }
+	bool operator !=(const RandomStream& other) const { return !(*this == other); }
+
+	nlohmann::json ToJson() const;
+	static RandomStream FromJson(const nlohmann::json& blob);
+
+private:
+	uint64_t _state;
+	uint64_t _increment;
+};
+
+/// <summary>
+/// Hands out named random streams, all derived from a single seed. Each system should use
+/// its own stream, so that changes to how often one system draws numbers don't shift
+/// the sequence seen by the others. Streams are created lazily on first use, and their
+/// state can be saved and restored with the scene
+///
+/// Not thread safe; grab a copy of a stream (or Fork one) to use from another thread
+/// </summary>
+class RandomService {
+public:
+	static constexpr uint64_t DEFAULT_SEED = 0x5EED0F1CE11ULL;
+
+	RandomService(uint64_t seed = DEFAULT_SEED);
+
+	/// <summary>
+	/// Sets the seed, resetting all streams back to the start of their sequences
+	/// </summary>
+	void SetSeed(uint64_t seed);
+	uint64_t GetSeed() const { return _seed; }
+
+	/// <summary>
+	/// Gets the named stream, creating it if it does not exist yet
+	/// </summary>
+	/// <param name="name">The name of the stream, usually the system that uses it</param>
+	RandomStream& GetStream(const std::string& name);
+
+	/// <summary>
+	/// Creates a new stream from the named stream's current position, advancing it. Useful
+	/// for handing each job or thread its own deterministic stream
+	/// </summary>
+	RandomStream Fork(const std::string& name);
+
+	const std::map<std::string, RandomStream>& GetStreams() const { return _streams; }
+
+	nlohmann::json ToJson() const;
+	/// <summary>
+	/// Loads the seed and any saved stream positions from a JSON blob
+	/// </summary>
+	void LoadFromJson(const nlohmann::json& blob);
+
+private:
+	uint64_t _seed;
+	// Ordered so that saved files are stable between runs
+	std::map<std::string, RandomStream> _streams;
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include "Utils/GUID.hpp"
 #include "json.hpp"
 
@@ -41,9 +43,31 @@ public:
 	/// <returns>The JSON blob for the resource</returns>
 	virtual nlohmann::json ToJson() const = 0;
 
+	/// <summary>
+	/// Gets the revision of this resource's serialized state. This changes whenever the
+	/// resource is marked as dirty, which lets saves skip re-serializing resources that
+	/// have not changed since the last save
+	/// </summary>
+	virtual uint64_t GetRevision() const { return _revision; }
+	/// <summary>
+	/// Marks this resource as changed, so that it will be re-serialized on the next save.
+	/// Should be called by anything that modifies the data returned by ToJson
+	/// </summary>
+	void MarkDirty() { _revision = NextRevision(); }
+
+	/// <summary>
+	/// Gets a new revision number. Revisions are shared between all resources and always
+	/// increase, so a revision that is higher than a cached one is always newer
+	/// </summary>
+	static uint64_t NextRevision() {
+		static std::atomic<uint64_t> counter(0);
+		return ++counter;
+	}
+
 protected:
 	Guid _guid;
-	IResource() : _guid(Guid::New()){}
+	uint64_t _revision;
+	IResource() : _guid(Guid::New()), _revision(NextRevision()) {}
 };
 
 /// <summary>
@@ -3,13 +3,26 @@
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Utils/JsonSaxReader.h"
+#include "Utils/AsyncFileWriter.h"
+
+#include <chrono>
 
 std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
 
 nlohmann::ordered_json ResourceManager::_manifest;
+JsonChunkCache ResourceManager::_manifestCache;
+
+std::shared_mutex ResourceManager::_mutex;
+std::thread::id ResourceManager::_mainThread;
+std::mutex ResourceManager::_taskMutex;
+std::deque<std::packaged_task<IResource::Sptr()>> ResourceManager::_mainThreadTasks;
 
 void ResourceManager::Init() {
+	// All resource creation happens on this thread, since it owns the GL context
+	_mainThread = std::this_thread::get_id();
+
 	// TODO: initialize the resource manager once it's a bit more complex
 	//_manifest["textures"]  = std::vector<nlohmann::json>();
 	//_manifest["meshes"]    = std::vector<nlohmann::json>();
@@ -17,42 +30,220 @@ void ResourceManager::Init() {
 	//_manifest["materials"] = std::vector<nlohmann::json>();
 }
 
+bool ResourceManager::IsMainThread() {
+	return std::this_thread::get_id() == _mainThread;
+}
+
+void ResourceManager::ProcessMainThreadTasks() {
+	LOG_ASSERT(IsMainThread(), "ProcessMainThreadTasks must be called from the main thread");
+
+	std::deque<std::packaged_task<IResource::Sptr()>> tasks;
+	{
+		std::lock_guard<std::mutex> lock(_taskMutex);
+		tasks.swap(_mainThreadTasks);
+	}
+	for (auto& task : tasks) {
+		task();
+	}
+}
+
 const nlohmann::ordered_json& ResourceManager::GetManifest() {
 	return _manifest;
 }
 
+IResource::Sptr ResourceManager::_Find(const std::type_index& type, const Guid& id) {
+	auto typeIt = _resources.find(type);
+	if (typeIt == _resources.end()) {
+		return nullptr;
+	}
+	auto it = typeIt->second.find(id);
+	return it != typeIt->second.end() ? it->second : nullptr;
+}
+
+IResource::Sptr ResourceManager::_LoadFromManifest(const std::type_index& type, const std::string& typeName, const Guid& id) {
+	std::function<Guid(const nlohmann::json&)> loader;
+	nlohmann::json data;
+	{
+		std::shared_lock<std::shared_mutex> lock(_mutex);
+
+		// Another request may have loaded it while we were waiting for the main thread
+		IResource::Sptr existing = _Find(type, id);
+		if (existing != nullptr) {
+			return existing;
+		}
+
+		// We need both a loader and a manifest entry to be able to load it
+		auto loaderIt = _typeLoaders.find(typeName);
+		auto typeIt = _manifest.find(typeName);
+		if (loaderIt == _typeLoaders.end() || !loaderIt->second || typeIt == _manifest.end()) {
+			return nullptr;
+		}
+		auto entryIt = typeIt->find(id.str());
+		if (entryIt == typeIt->end()) {
+			return nullptr;
+		}
+		loader = loaderIt->second;
+		data = *entryIt;
+	}
+
+	// Invoke the loader function with the manifest data, this takes the lock itself once
+	// the resource has been created
+	loader(data);
+
+	// Search resources again to get the resource
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+	return _Find(type, id);
+}
+
+IResource::Sptr ResourceManager::_RunOnMainThread(const std::function<IResource::Sptr()>& func) {
+	if (IsMainThread()) {
+		return func();
+	}
+
+	// Hand it over and wait for the result, the function can only be referencing our caller's
+	// state since we block until it's done
+	std::packaged_task<IResource::Sptr()> task(func);
+	std::future<IResource::Sptr> result = task.get_future();
+	{
+		std::lock_guard<std::mutex> lock(_taskMutex);
+		_mainThreadTasks.push_back(std::move(task));
+	}
+	return result.get();
+}
+
 void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets) {
+	// Make sure we're not reading a file that's still being saved
+	AsyncFileWriter::Flush();
 	std::string contents = FileHelpers::ReadFile(path);
-	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
-	_manifest = blob;
 
+	// Stream the entries straight into the manifest, rather than parsing a temporary
+	// document and copying it over
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	_manifest = nlohmann::ordered_json::object();
+	_manifestCache.Clear();
+	JsonSaxReader<nlohmann::ordered_json> reader({ { "*", "*" }, { "*" } },
+		[&](const JsonSaxReader<nlohmann::ordered_json>::Path& jsonPath, nlohmann::ordered_json& value) {
+			if (jsonPath.size() == 2) {
+				_manifest[jsonPath[0]][jsonPath[1]] = std::move(value);
+			} else {
+				_manifest[jsonPath[0]] = std::move(value);
+			}
+		});
+	if (!nlohmann::ordered_json::sax_parse(contents, &reader)) {
+		LOG_ERROR("Failed to parse resource manifest \"{}\"", path);
+		return;
+	}
+
+	// Assets are loaded once the whole manifest is read, since some types depend on others
 	if (preloadAssets) {
-		for (auto& [typeName, items] : blob.items()) {
-			auto& func = _typeLoaders[typeName];
-			if (func) {
+		// Loaders take the lock themselves, so we copy out what we need to load first
+		std::vector<std::pair<std::function<Guid(const nlohmann::json&)>, nlohmann::json>> toLoad;
+		for (auto& [typeName, items] : _manifest.items()) {
+			auto it = _typeLoaders.find(typeName);
+			if (it != _typeLoaders.end() && it->second) {
 				for (auto& [guid, blob] : items.items()) {
-					func(blob);
+					toLoad.emplace_back(it->second, blob);
 				}
 			}
 		}
+		lock.unlock();
+
+		for (auto& [func, blob] : toLoad) {
+			func(blob);
+		}
 	}
 }
 
 void ResourceManager::SaveManifest(const std::string& path) {
-	// Update all resources in the manifest so they match their current representation
-	for (auto& [type, map] : _resources) {
-		std::string typeName = StringTools::SanitizeClassName(type.name());
-		for (auto& [guid, res] : map) {
-			_manifest[typeName][guid.str()] = res->ToJson();
-			_manifest[typeName][guid.str()]["guid"] = res->GetGUID().str();
+	auto startTime = std::chrono::steady_clock::now();
+
+	// Grab the resources we're saving, we don't want to hold the lock while they serialize
+	struct SaveEntry {
+		std::string     TypeName;
+		Guid            Id;
+		IResource::Sptr Resource;
+	};
+	std::vector<SaveEntry> resources;
+	{
+		std::shared_lock<std::shared_mutex> lock(_mutex);
+		for (auto& [type, map] : _resources) {
+			std::string typeName = StringTools::SanitizeClassName(type.name());
+			for (auto& [guid, res] : map) {
+				resources.push_back(SaveEntry{ typeName, guid, res });
+			}
+		}
+	}
+
+	// Update resources that have changed since the last save, so the manifest matches their current representation
+	std::unordered_map<Guid, JsonChunkCache::Chunk> chunks;
+	std::vector<std::pair<const SaveEntry*, nlohmann::ordered_json>> changed;
+	for (const SaveEntry& entry : resources) {
+		chunks[entry.Id] = _manifestCache.Get(entry.Id, entry.Resource->GetRevision(), "\n\t\t" + nlohmann::json(entry.Id.str()).dump() + ": ", 2, [&]() {
+			nlohmann::ordered_json blob = entry.Resource->ToJson();
+			blob["guid"] = entry.Resource->GetGUID().str();
+			changed.emplace_back(&entry, blob);
+			return blob;
+		});
+	}
+	size_t rebuilt = _manifestCache.GetRebuildCount();
+
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	for (auto& [entry, blob] : changed) {
+		_manifest[entry->TypeName][entry->Id.str()] = std::move(blob);
+	}
+
+	// Stitch the file together from the cached entries, entries for resources that are in the
+	// manifest but were never loaded never change, so they only get serialized once
+	static const JsonChunkCache::Chunk separator = JsonChunkCache::MakeChunk(",");
+	std::vector<JsonChunkCache::Chunk> output;
+	output.push_back(JsonChunkCache::MakeChunk("{"));
+	bool firstType = true;
+	for (auto& [typeName, items] : _manifest.items()) {
+		std::string header = (firstType ? "\n\t" : ",\n\t") + nlohmann::json(typeName).dump() + ": ";
+		firstType = false;
+		if (!items.is_object() || items.empty()) {
+			output.push_back(JsonChunkCache::MakeChunk(header + JsonChunkCache::Dump(items, 1)));
+			continue;
+		}
+
+		output.push_back(JsonChunkCache::MakeChunk(header + "{"));
+		bool firstItem = true;
+		for (auto& item : items.items()) {
+			const std::string& key = item.key();
+			const nlohmann::ordered_json& blob = item.value();
+			if (!firstItem) {
+				output.push_back(separator);
+			}
+			firstItem = false;
+
+			Guid guid = Guid(key);
+			auto it = chunks.find(guid);
+			if (it != chunks.end()) {
+				output.push_back(it->second);
+			} else {
+				output.push_back(_manifestCache.Get(guid, 0, "\n\t\t" + nlohmann::json(key).dump() + ": ", 2, [&]() -> const nlohmann::ordered_json& { return blob; }));
+			}
 		}
+		output.push_back(JsonChunkCache::MakeChunk("\n\t}"));
 	}
-	FileHelpers::WriteContentsToFile(path, _manifest.dump(1,'\t'));
+	output.push_back(JsonChunkCache::MakeChunk(firstType ? "}" : "\n}"));
+	_manifestCache.Prune();
+	lock.unlock();
+
+	AsyncFileWriter::Write(path, std::move(output));
+	double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	LOG_INFO("Saving manifest to \"{}\", serialized {} resources in {:.2f}ms", path, rebuilt, elapsed);
 }
 
 void ResourceManager::Cleanup() {
-	for (auto& [type, map] : _resources) {
-		map.clear();
+	// Release the resources outside of the lock, in case their destructors need the resource manager
+	std::map<std::type_index, std::map<Guid, IResource::Sptr>> resources;
+	{
+		std::unique_lock<std::shared_mutex> lock(_mutex);
+		for (auto& [type, map] : _resources) {
+			resources[type].swap(map);
+		}
 	}
+	resources.clear();
 }
 
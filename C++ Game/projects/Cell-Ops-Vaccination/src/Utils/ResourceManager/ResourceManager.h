@@ -3,6 +3,11 @@
 #include <json.hpp>
 #include <unordered_map>
 #include <typeindex>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <future>
 
 #include "Graphics/Texture2D.h"
 #include "Graphics/VertexArrayObject.h"
@@ -12,19 +17,39 @@
 #include "Utils/GUID.hpp"
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/StringUtils.h"
+#include "Utils/JsonChunkCache.h"
 
 /// <summary>
 /// Utility class for managing and loading resources from JSON
 /// manifest files
+/// 
+/// Threading rules:
+/// - Get, CreateAsset and Each are safe to call from any thread. Lookups of resources that
+///   are already loaded only take a shared lock, so parallel readers never block each other
+/// - Anything that creates a resource (loading from the manifest, or CreateAsset) has to
+///   create GL objects, so the work is handed to the main thread and the calling thread waits
+///   for it. The main thread runs these in ProcessMainThreadTasks once per frame, so a worker
+///   must never be waited on by the main thread while it's creating resources
+/// - Manifest loading, saving, Cleanup and RegisterType are main thread only
 /// </summary>
 class ResourceManager {
 public:
 	/// <summary>
 	/// Initializes the resource manager and performs any first-time
-	/// setup required
+	/// setup required. Must be called from the thread that owns the GL context
 	/// </summary>
 	static void Init();
 
+	/// <summary>
+	/// Returns true if called from the thread that the resource manager was initialized on
+	/// </summary>
+	static bool IsMainThread();
+	/// <summary>
+	/// Runs any resource creation that other threads have handed over to the main thread,
+	/// should be called once per frame from the main thread
+	/// </summary>
+	static void ProcessMainThreadTasks();
+
 	/// <summary>
 	/// Creates a new asset, and forwards the arguments to it's constructor
 	/// </summary>
@@ -34,9 +59,13 @@ public:
 	/// <returns>The GUID of the newly created asset</returns>
 	template <typename T, typename ... TArgs, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> CreateAsset(TArgs&&... args) {
-		// Create and store the asset
-		std::shared_ptr<T> asset = std::make_shared<T>(std::forward<TArgs>(args)...);
-		_resources[std::type_index(typeid(T))][asset->IResource::GetGUID()] = asset;
+		// Create the asset, this will make GL objects so it has to happen on the main thread.
+		// We wait for it to finish, so it's safe to capture the arguments by reference
+		std::shared_ptr<T> asset;
+		_RunOnMainThread([&]() -> IResource::Sptr {
+			asset = std::make_shared<T>(std::forward<TArgs>(args)...);
+			return asset;
+		});
 
 		// Get the JSON representation of the asset so we can store it in the manifest
 		nlohmann::json data = asset->ToJson();
@@ -45,7 +74,9 @@ public:
 		std::string guid = asset->IResource::GetGUID().str();
 		data["guid"] = guid;
 
-		// Store the JSON data in the resource manifest (based on the type's name)
+		// Store the asset, and the JSON data in the resource manifest (based on the type's name)
+		std::unique_lock<std::shared_mutex> lock(_mutex);
+		_resources[std::type_index(typeid(T))][asset->IResource::GetGUID()] = asset;
 		_manifest[StringTools::SanitizeClassName(typeid(T).name())][guid] = data;
 		return asset;
 	}
@@ -58,26 +89,20 @@ public:
 	/// <returns>The resource with the given GUID, or nullptr if none exists</returns>
 	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> Get(Guid id) {
-		// Try and grab the asset from the resource pool
-		std::shared_ptr<T> result =  std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
-
-		// If the asset is null, we can try finding it in the manifest to load it
-		if (result == nullptr) {
-			// Get the type name it'll be stored under
-			std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
-
-			// If the manifest has an entry, we can load it!
-			if (_manifest[typeName].contains(id)) {
-				// Invoke the loader function with the manifest data
-				_typeLoaders[typeName](_manifest[typeName][id]);
-
-				// Search resources again to get the resource
-				return std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
+		std::type_index type = std::type_index(typeid(T));
+
+		// Try and grab the asset from the resource pool, this is the common case so it only needs a shared lock
+		{
+			std::shared_lock<std::shared_mutex> lock(_mutex);
+			IResource::Sptr result = _Find(type, id);
+			if (result != nullptr) {
+				return std::dynamic_pointer_cast<T>(result);
 			}
 		}
 
-		// If result wasn't null, or couldn't be found in the manifest, return here
-		return result;
+		// If the asset isn't loaded, we can try finding it in the manifest to load it
+		std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+		return std::dynamic_pointer_cast<T>(_RunOnMainThread([&]() { return _LoadFromManifest(type, typeName, id); }));
 	}
 
 	/// <summary>
@@ -91,10 +116,14 @@ public:
 		// Extract the type name from a sanitized version of they typeid name
 		std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
 
-		// Create the type loader for the type
+		std::unique_lock<std::shared_mutex> lock(_mutex);
+
+		// Create the type loader for the type, note that loading can recurse into other resources
+		// (ex: materials loading their textures), so we only lock once the resource is created
 		_typeLoaders[typeName] = [](const nlohmann::json& data) {
 			IResource::Sptr res = T::FromJson(data);
 			res->OverrideGUID(Guid(data["guid"]));
+			std::unique_lock<std::shared_mutex> lock(_mutex);
 			_resources[std::type_index(typeid(T))][res->GetGUID()] = res;
 			return res->GetGUID();
 		};
@@ -120,8 +149,21 @@ public:
 		// We can use typeid and type_index to get a unique ID for our types
 		std::type_index type = std::type_index(typeid(ResourceType));
 
+		// Copy the resources out so that the callback can use the resource manager
+		std::vector<IResource::Sptr> resources;
+		{
+			std::shared_lock<std::shared_mutex> lock(_mutex);
+			auto it = _resources.find(type);
+			if (it != _resources.end()) {
+				resources.reserve(it->second.size());
+				for (auto& [key, value] : it->second) {
+					resources.push_back(value);
+				}
+			}
+		}
+
 		// Iterate over all the resources in the store
-		for (auto& [key, value] : _resources[type]) {
+		for (auto& value : resources) {
 			// If the pointer is alive and matches our enabled criteria, invoke the callback
 			if (value != nullptr) {
 				// Upcast to resource type and invoke the callback
@@ -131,7 +173,7 @@ public:
 	}
 
 	/// <summary>
-	/// Gets the current JSON manifest
+	/// Gets the current JSON manifest, should only be used from the main thread
 	/// </summary>
 	static const nlohmann::ordered_json& GetManifest();
 	/// <summary>
@@ -142,7 +184,8 @@ public:
 	/// <param name="preloadAssets">True if all assets should be loaded into memory</param>
 	static void LoadManifest(const std::string& path, bool preloadAssets = false);
 	/// <summary>
-	/// Saves the manifest to the given JSON file
+	/// Saves the manifest to the given JSON file. Only resources that have changed since the
+	/// last save are serialized again, and the file is written on a background thread
 	/// </summary>
 	/// <param name="path">The path to the file to output</param>
 	static void SaveManifest(const std::string& path);
@@ -169,4 +212,35 @@ protected:
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
+	/// <summary>
+	/// The serialized text of the manifest entries as of the last save
+	/// </summary>
+	static JsonChunkCache _manifestCache;
+
+	/// <summary>
+	/// Guards the resources, type loaders and manifest. Note that shared_mutex is not recursive,
+	/// so it must never be held while calling into resource code that could call back into us
+	/// </summary>
+	static std::shared_mutex _mutex;
+
+	// The thread with the GL context, which all resource creation happens on
+	static std::thread::id _mainThread;
+	// Work handed over to the main thread by other threads
+	static std::mutex _taskMutex;
+	static std::deque<std::packaged_task<IResource::Sptr()>> _mainThreadTasks;
+
+	/// <summary>
+	/// Finds a loaded resource, the caller must hold _mutex
+	/// </summary>
+	static IResource::Sptr _Find(const std::type_index& type, const Guid& id);
+	/// <summary>
+	/// Loads a resource from it's manifest entry if it isn't already loaded, main thread only
+	/// </summary>
+	/// <returns>The resource, or nullptr if it isn't in the manifest</returns>
+	static IResource::Sptr _LoadFromManifest(const std::type_index& type, const std::string& typeName, const Guid& id);
+	/// <summary>
+	/// Runs a function on the main thread, immediately if we're already on it, otherwise
+	/// blocking until the main thread gets to it in ProcessMainThreadTasks
+	/// </summary>
+	static IResource::Sptr _RunOnMainThread(const std::function<IResource::Sptr()>& func);
 };
\ No newline at end of file
@@ -0,0 +1,463 @@
+#include "Utils/VirtualFileSystem.h"
+
+#include <Windows.h>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+#include <chrono>
+#include <gzip/compress.hpp>
+#include <gzip/decompress.hpp>
+
+#include "Logging.h"
+#include "Utils/StringUtils.h"
+
+namespace fs = std::filesystem;
+
+const char* VirtualFileSystem::PACK_EXTENSION = ".pak";
+
+std::vector<std::unique_ptr<VirtualFileSystem::IMount>> VirtualFileSystem::_mounts;
+std::atomic<uint64_t> VirtualFileSystem::_packReads(0);
+std::atomic<uint64_t> VirtualFileSystem::_looseReads(0);
+std::atomic<uint64_t> VirtualFileSystem::_bytesRead(0);
+std::atomic<uint64_t> VirtualFileSystem::_readTimeUs(0);
+
+namespace {
+	// Pack layout:
+	//   PackHeader
+	//   Entry data, each entry starting on a multiple of PackHeader::Alignment
+	//   Table of contents, NumEntries x (PackEntry followed by PathLength bytes of path)
+	const char     PACK_MAGIC[4] = { 'O', 'P', 'A', 'K' };
+	const uint32_t PACK_VERSION  = 0x01;
+
+	struct PackHeader {
+		char     Magic[4] = { 'O', 'P', 'A', 'K' };
+		uint32_t Version = PACK_VERSION;
+		uint32_t NumEntries = 0;
+		uint32_t Alignment = 0;
+		uint64_t TocOffset = 0;
+		uint64_t TocSize = 0;
+	};
+
+	enum PackEntryFlags : uint32_t {
+		PackEntryNone       = 0,
+		PackEntryCompressed = 1 << 0
+	};
+
+	struct PackEntry {
+		// Offset of the entry's data from the start of the pack
+		uint64_t Offset = 0;
+		// Size of the data in the pack
+		uint64_t StoredSize = 0;
+		// Size of the data once decompressed
+		uint64_t Size = 0;
+		uint32_t Flags = PackEntryNone;
+		uint32_t PathLength = 0;
+	};
+
+	double Now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Reads a file straight from disk, without going through the mounts
+	bool ReadDiskFile(const fs::path& path, std::string& outContents) {
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in) {
+			return false;
+		}
+		in.seekg(0, std::ios::end);
+		std::streamoff size = in.tellg();
+		if (size < 0) {
+			return false;
+		}
+		outContents.resize((size_t)size);
+		in.seekg(0, std::ios::beg);
+		in.read(&outContents[0], size);
+		return true;
+	}
+
+	// Strips the mount point from a normalized path, returns false if the path is not under it
+	bool StripMountPoint(const std::string& path, const std::string& mountPoint, std::string& outRelative) {
+		if (mountPoint.empty()) {
+			outRelative = path;
+			return true;
+		}
+		if (path.size() > mountPoint.size() && path.compare(0, mountPoint.size(), mountPoint) == 0 && path[mountPoint.size()] == '/') {
+			outRelative = path.substr(mountPoint.size() + 1);
+			return true;
+		}
+		return false;
+	}
+}
+
+class VirtualFileSystem::IMount {
+public:
+	std::string MountPoint;
+
+	virtual ~IMount() = default;
+	virtual bool IsPack() const = 0;
+	virtual std::string GetDescription() const = 0;
+	virtual bool Exists(const std::string& relativePath) const = 0;
+	virtual bool Read(const std::string& relativePath, std::string& outContents) const = 0;
+};
+
+class VirtualFileSystem::DirectoryMount final : public VirtualFileSystem::IMount {
+public:
+	fs::path Root;
+
+	virtual bool IsPack() const override { return false; }
+
+	virtual std::string GetDescription() const override {
+		return Root.string();
+	}
+
+	virtual bool Exists(const std::string& relativePath) const override {
+		return fs::is_regular_file(Root / relativePath);
+	}
+
+	virtual bool Read(const std::string& relativePath, std::string& outContents) const override {
+		fs::path path = Root / relativePath;
+		return fs::is_regular_file(path) && ReadDiskFile(path, outContents);
+	}
+};
+
+class VirtualFileSystem::PackMount final : public VirtualFileSystem::IMount {
+public:
+	std::string Path;
+
+	PackMount() :
+		_file(INVALID_HANDLE_VALUE),
+		_mapping(nullptr),
+		_data(nullptr),
+		_size(0),
+		_entries()
+	{ }
+
+	virtual ~PackMount() {
+		if (_data != nullptr) UnmapViewOfFile(_data);
+		if (_mapping != nullptr) CloseHandle(_mapping);
+		if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+	}
+
+	bool Open(const std::string& path) {
+		Path = path;
+
+		// Map the whole pack once, every read after this is just a memcpy or an inflate
+		_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (_file == INVALID_HANDLE_VALUE) {
+			LOG_WARN("Could not open pack \"{}\"", path);
+			return false;
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size) || size.QuadPart < (LONGLONG)sizeof(PackHeader)) {
+			LOG_ERROR("Pack \"{}\" is too small to be valid", path);
+			return false;
+		}
+		_size = (uint64_t)size.QuadPart;
+
+		_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (_mapping == nullptr) {
+			LOG_ERROR("Could not map pack \"{}\"", path);
+			return false;
+		}
+		_data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (_data == nullptr) {
+			LOG_ERROR("Could not map pack \"{}\"", path);
+			return false;
+		}
+
+		// Validate the header
+		PackHeader header;
+		memcpy(&header, _data, sizeof(PackHeader));
+		if (memcmp(header.Magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.Version != PACK_VERSION) {
+			LOG_ERROR("\"{}\" is not a pack, or was built by a different version", path);
+			return false;
+		}
+		if (header.TocOffset + header.TocSize > _size) {
+			LOG_ERROR("Pack \"{}\" is truncated", path);
+			return false;
+		}
+
+		// Read the table of contents into a lookup table
+		_entries.reserve(header.NumEntries);
+		uint64_t seek = header.TocOffset;
+		const uint64_t tocEnd = header.TocOffset + header.TocSize;
+		for (uint32_t ix = 0; ix < header.NumEntries; ix++) {
+			PackEntry entry;
+			if (seek + sizeof(PackEntry) > tocEnd) {
+				LOG_ERROR("Pack \"{}\" has a corrupt table of contents", path);
+				return false;
+			}
+			memcpy(&entry, _data + seek, sizeof(PackEntry));
+			seek += sizeof(PackEntry);
+
+			if (seek + entry.PathLength > tocEnd || entry.Offset + entry.StoredSize > header.TocOffset) {
+				LOG_ERROR("Pack \"{}\" has a corrupt table of contents", path);
+				return false;
+			}
+			std::string entryPath(reinterpret_cast<const char*>(_data + seek), entry.PathLength);
+			seek += entry.PathLength;
+
+			_entries[entryPath] = entry;
+		}
+
+		return true;
+	}
+
+	virtual bool IsPack() const override { return true; }
+
+	virtual std::string GetDescription() const override {
+		return Path + " (" + std::to_string(_entries.size()) + " entries)";
+	}
+
+	virtual bool Exists(const std::string& relativePath) const override {
+		return _entries.find(relativePath) != _entries.end();
+	}
+
+	virtual bool Read(const std::string& relativePath, std::string& outContents) const override {
+		auto it = _entries.find(relativePath);
+		if (it == _entries.end()) {
+			return false;
+		}
+		const PackEntry& entry = it->second;
+		const char* data = reinterpret_cast<const char*>(_data + entry.Offset);
+
+		if (entry.Flags & PackEntryCompressed) {
+			try {
+				outContents.clear();
+				gzip::Decompressor().decompress(outContents, data, entry.StoredSize);
+			}
+			catch (const std::exception& e) {
+				LOG_ERROR("Failed to decompress \"{}\" from pack \"{}\": {}", relativePath, Path, e.what());
+				return false;
+			}
+			if (outContents.size() != entry.Size) {
+				LOG_ERROR("\"{}\" in pack \"{}\" decompressed to the wrong size", relativePath, Path);
+				return false;
+			}
+		} else {
+			outContents.assign(data, entry.Size);
+		}
+		return true;
+	}
+
+private:
+	HANDLE         _file;
+	HANDLE         _mapping;
+	const uint8_t* _data;
+	uint64_t       _size;
+	std::unordered_map<std::string, PackEntry> _entries;
+};
+
+std::string VirtualFileSystem::NormalizePath(const std::string& path) {
+	std::string result = fs::path(path).lexically_normal().generic_string();
+	// Windows paths aren't case sensitive, so our lookups shouldn't be either
+	StringTools::ToLower(result);
+	if (result.size() >= 2 && result[0] == '.' && result[1] == '/') {
+		result = result.substr(2);
+	}
+	while (!result.empty() && result.back() == '/') {
+		result.pop_back();
+	}
+	return result;
+}
+
+bool VirtualFileSystem::MountDirectory(const std::string& path, const std::string& mountPoint) {
+	if (!fs::is_directory(path)) {
+		LOG_WARN("Could not mount \"{}\", it is not a directory", path);
+		return false;
+	}
+	std::unique_ptr<DirectoryMount> mount = std::make_unique<DirectoryMount>();
+	mount->Root = fs::path(path);
+	mount->MountPoint = NormalizePath(mountPoint);
+	LOG_INFO("Mounted directory \"{}\" at \"/{}\"", path, mount->MountPoint);
+	_mounts.push_back(std::move(mount));
+	return true;
+}
+
+bool VirtualFileSystem::MountPack(const std::string& path, const std::string& mountPoint) {
+	std::unique_ptr<PackMount> mount = std::make_unique<PackMount>();
+	if (!mount->Open(path)) {
+		return false;
+	}
+	mount->MountPoint = NormalizePath(mountPoint);
+	LOG_INFO("Mounted pack {} at \"/{}\"", mount->GetDescription(), mount->MountPoint);
+	_mounts.push_back(std::move(mount));
+	return true;
+}
+
+void VirtualFileSystem::UnmountAll() {
+	_mounts.clear();
+}
+
+bool VirtualFileSystem::Exists(const std::string& path) {
+	if (!fs::path(path).is_absolute()) {
+		std::string normalized = NormalizePath(path);
+		std::string relative;
+		for (auto it = _mounts.rbegin(); it != _mounts.rend(); it++) {
+			if (StripMountPoint(normalized, (*it)->MountPoint, relative) && (*it)->Exists(relative)) {
+				return true;
+			}
+		}
+	}
+	return fs::exists(path);
+}
+
+bool VirtualFileSystem::ReadFile(const std::string& path, std::string& outContents) {
+	double startTime = Now();
+
+	if (!fs::path(path).is_absolute()) {
+		std::string normalized = NormalizePath(path);
+		std::string relative;
+		for (auto it = _mounts.rbegin(); it != _mounts.rend(); it++) {
+			if (StripMountPoint(normalized, (*it)->MountPoint, relative) && (*it)->Read(relative, outContents)) {
+				_RecordRead((*it)->IsPack(), outContents.size(), startTime);
+				return true;
+			}
+		}
+	}
+
+	// Fall back to the regular file system
+	if (!ReadDiskFile(path, outContents)) {
+		return false;
+	}
+	_RecordRead(false, outContents.size(), startTime);
+	return true;
+}
+
+bool VirtualFileSystem::CookPack(const std::string& sourceDir, const std::string& outPath, float minSavings, uint32_t alignment) {
+	if (!fs::is_directory(sourceDir)) {
+		LOG_ERROR("Cannot cook \"{}\", it is not a directory", sourceDir);
+		return false;
+	}
+	alignment = alignment == 0 ? 1 : alignment;
+	double startTime = Now();
+
+	// Write to a temporary file, so a failed cook never leaves a broken pack behind
+	fs::path tempPath = fs::path(outPath);
+	tempPath += ".tmp";
+	std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!out) {
+		LOG_ERROR("Could not open \"{}\" for writing", tempPath.string());
+		return false;
+	}
+
+	// Sort the files so that cooking the same directory twice gives the same pack
+	std::error_code error;
+	fs::path outFull = fs::weakly_canonical(outPath, error);
+	std::vector<fs::path> files;
+	for (const auto& item : fs::recursive_directory_iterator(sourceDir)) {
+		if (!item.is_regular_file()) continue;
+		fs::path full = fs::weakly_canonical(item.path(), error);
+		// Skip our own output, and any other packs
+		if (full == outFull || item.path().extension() == PACK_EXTENSION || item.path().extension() == ".tmp") continue;
+		files.push_back(item.path());
+	}
+	std::sort(files.begin(), files.end());
+
+	PackHeader header;
+	header.Alignment = alignment;
+	out.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+
+	std::vector<std::pair<std::string, PackEntry>> toc;
+	toc.reserve(files.size());
+	uint64_t offset = sizeof(PackHeader);
+	uint64_t totalSize = 0;
+	uint64_t totalStored = 0;
+	const std::string padding(alignment, '\0');
+
+	for (const fs::path& file : files) {
+		// Always read from disk here, a mounted pack could have a stale copy
+		std::string contents;
+		if (!ReadDiskFile(file, contents)) {
+			LOG_ERROR("Could not read \"{}\", aborting cook", file.string());
+			out.close();
+			fs::remove(tempPath, error);
+			return false;
+		}
+
+		PackEntry entry;
+		entry.Size = contents.size();
+		// Only keep the compressed copy if it's worth it, images and such are usually already compressed
+		std::string compressed = contents.empty() ? std::string() : gzip::compress(contents.data(), contents.size());
+		const std::string* stored = &contents;
+		if (!contents.empty() && compressed.size() < contents.size() * (1.0f - minSavings)) {
+			stored = &compressed;
+			entry.Flags |= PackEntryCompressed;
+		}
+		entry.StoredSize = stored->size();
+
+		// Pad up to the alignment
+		uint64_t aligned = (offset + alignment - 1) / alignment * alignment;
+		out.write(padding.data(), aligned - offset);
+		entry.Offset = aligned;
+		out.write(stored->data(), stored->size());
+		offset = aligned + stored->size();
+
+		std::string relative = NormalizePath(fs::relative(file, sourceDir).generic_string());
+		entry.PathLength = (uint32_t)relative.size();
+		toc.push_back(std::make_pair(relative, entry));
+
+		totalSize += entry.Size;
+		totalStored += entry.StoredSize;
+	}
+
+	// The table of contents goes at the end, since we only know the offsets once the data is written
+	header.NumEntries = (uint32_t)toc.size();
+	header.TocOffset = offset;
+	for (const auto& [path, entry] : toc) {
+		out.write(reinterpret_cast<const char*>(&entry), sizeof(PackEntry));
+		out.write(path.data(), path.size());
+		offset += sizeof(PackEntry) + path.size();
+	}
+	header.TocSize = offset - header.TocOffset;
+
+	out.seekp(0, std::ios::beg);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+	out.close();
+	if (!out) {
+		LOG_ERROR("Failed writing pack \"{}\"", tempPath.string());
+		fs::remove(tempPath, error);
+		return false;
+	}
+
+	fs::rename(tempPath, outPath, error);
+	if (error) {
+		LOG_ERROR("Could not move cooked pack to \"{}\": {}", outPath, error.message());
+		return false;
+	}
+
+	LOG_INFO("Cooked {} files from \"{}\" into \"{}\" in {:.2f}s ({:.1f} MB -> {:.1f} MB)", toc.size(), sourceDir, outPath,
+			 Now() - startTime, totalSize / (1024.0 * 1024.0), totalStored / (1024.0 * 1024.0));
+	return true;
+}
+
+VirtualFileSystem::Stats VirtualFileSystem::GetStats() {
+	Stats result;
+	result.PackReads = _packReads;
+	result.LooseReads = _looseReads;
+	result.BytesRead = _bytesRead;
+	result.ReadTime = _readTimeUs / 1000000.0;
+	return result;
+}
+
+void VirtualFileSystem::ResetStats() {
+	_packReads = 0;
+	_looseReads = 0;
+	_bytesRead = 0;
+	_readTimeUs = 0;
+}
+
+void VirtualFileSystem::LogStats() {
+	Stats stats = GetStats();
+	LOG_INFO("VFS: {} pack reads, {} loose reads, {:.1f} MB in {:.3f}s", stats.PackReads, stats.LooseReads, stats.BytesRead / (1024.0 * 1024.0), stats.ReadTime);
+	for (const auto& mount : _mounts) {
+		LOG_INFO("\t/{} -> {}", mount->MountPoint, mount->GetDescription());
+	}
+}
+
+void VirtualFileSystem::_RecordRead(bool fromPack, size_t bytes, double startTime) {
+	(fromPack ? _packReads : _looseReads)++;
+	_bytesRead += bytes;
+	_readTimeUs += (uint64_t)((Now() - startTime) * 1000000.0);
+}
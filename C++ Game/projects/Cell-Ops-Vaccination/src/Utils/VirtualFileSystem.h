@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+/// <summary>
+/// A read-only virtual file system for game assets. Directories and pack files can be
+/// mounted, and files are looked up in the most recently mounted source first. Paths that
+/// aren't found in any mount (or are absolute) fall back to the regular file system, so
+/// loose files keep working with nothing mounted.
+///
+/// Packs store many files back to back in a single file with a table of contents at the
+/// end, so loading an asset costs a lookup into a memory mapped file rather than a round of
+/// open/stat/read calls. Entries can be individually gzip compressed, and are aligned so
+/// that uncompressed entries start on a page boundary
+/// </summary>
+class VirtualFileSystem {
+public:
+	VirtualFileSystem() = delete;
+
+	// The extension that pack files are expected to have
+	static const char* PACK_EXTENSION;
+	// Entries in packs written by CookPack start on multiples of this many bytes
+	static const uint32_t DEFAULT_ALIGNMENT = 4096;
+
+	/// <summary>
+	/// Loading statistics, gathered since startup or the last ResetStats
+	/// </summary>
+	struct Stats {
+		// Number of files read from packs
+		uint64_t PackReads = 0;
+		// Number of files read from mounted directories, or the fallback file system
+		uint64_t LooseReads = 0;
+		// Total number of bytes returned to callers
+		uint64_t BytesRead = 0;
+		// Time spent reading and decompressing, in seconds
+		double   ReadTime = 0.0;
+	};
+
+	/// <summary>
+	/// Mounts a directory on disk, files in it will be visible under the mount point
+	/// </summary>
+	/// <param name="path">The directory to mount</param>
+	/// <param name="mountPoint">The virtual path to mount the directory at, or empty to mount at the root</param>
+	/// <returns>True if the directory exists and was mounted</returns>
+	static bool MountDirectory(const std::string& path, const std::string& mountPoint = "");
+	/// <summary>
+	/// Mounts a pack file that was created with CookPack
+	/// </summary>
+	/// <param name="path">The path to the pack file on disk</param>
+	/// <param name="mountPoint">The virtual path to mount the pack at, or empty to mount at the root</param>
+	/// <returns>True if the pack was opened and mounted</returns>
+	static bool MountPack(const std::string& path, const std::string& mountPoint = "");
+	/// <summary>
+	/// Unmounts all directories and packs, closing any open pack files
+	/// </summary>
+	static void UnmountAll();
+
+	/// <summary>
+	/// Returns true if the file exists in any mount, or on disk
+	/// </summary>
+	static bool Exists(const std::string& path);
+	/// <summary>
+	/// Reads the entire contents of a file, decompressing it if needed
+	/// </summary>
+	/// <param name="path">The path of the file to read</param>
+	/// <param name="outContents">Receives the contents of the file</param>
+	/// <returns>True if the file was found and read</returns>
+	static bool ReadFile(const std::string& path, std::string& outContents);
+
+	/// <summary>
+	/// Builds a pack file from all the files in a directory
+	/// </summary>
+	/// <param name="sourceDir">The directory to pack, paths in the pack will be relative to this</param>
+	/// <param name="outPath">The path of the pack to write. Will not be included in itself if it is inside sourceDir</param>
+	/// <param name="minSavings">Entries are only stored compressed if that makes them at least this fraction smaller</param>
+	/// <param name="alignment">Entries start on multiples of this many bytes</param>
+	/// <returns>True if the pack was written</returns>
+	static bool CookPack(const std::string& sourceDir, const std::string& outPath, float minSavings = 0.1f, uint32_t alignment = DEFAULT_ALIGNMENT);
+
+	static Stats GetStats();
+	static void ResetStats();
+	/// <summary>
+	/// Writes a summary of the mounts and loading statistics to the log
+	/// </summary>
+	static void LogStats();
+
+	/// <summary>
+	/// Converts a path to the form used for lookups, lowercase with forward slashes and
+	/// without any ./ or ../ parts
+	/// </summary>
+	static std::string NormalizePath(const std::string& path);
+
+protected:
+	class IMount;
+	class DirectoryMount;
+	class PackMount;
+
+	// Mounts in the order they were added, searched from the back
+	static std::vector<std::unique_ptr<IMount>> _mounts;
+
+	static std::atomic<uint64_t> _packReads;
+	static std::atomic<uint64_t> _looseReads;
+	static std::atomic<uint64_t> _bytesRead;
+	// Stored in microseconds so it can be atomic
+	static std::atomic<uint64_t> _readTimeUs;
+
+	static void _RecordRead(bool fromPack, size_t bytes, double startTime);
+};